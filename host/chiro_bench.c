@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <esp_log.h>
+
+#include "host_sim.h"
+#include "bench.h"
+#include "logger.h"
+#include "sensor_trace.h"
+
+/*
+ * ⏱️ BANC DE MESURE SUR L'ORDINATEUR
+ *
+ * Même banc que sur l'ESP32 (bench.h) : les durées viennent de l'horloge
+ * simulée, qui avance selon host_cost_model à chaque accès aux supports.
+ * Les réglages de config.h se comparent en recompilant avec CHIRO_DEFINITIONS.
+ */
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-n cycles] [-d dir] [-c fichier.csv] [-a mA] [-s mA] [-z µA] [-b ms] [-w µs] [-B mAh] [-t trace.csv] [-T µs] [-S kHz] [-l niveau]\n"
+            "  -n N     cycles à rejouer (défaut: 5000)\n"
+            "  -d dir   répertoire de simulation (défaut: bench_data, effacé au départ)\n"
+            "  -c f     une ligne CSV par cycle dans f\n"
+            "  -a -s -z courants actif / SD / deep sleep (défaut: %.0f mA, %.0f mA, %.0f µA)\n"
+            "  -b ms    durée de démarrage non vue par esp_timer (défaut: %d)\n"
+            "  -w µs    réveil par le wake stub, ROM comprise (défaut: %d)\n"
+            "  -B mAh   capacité de batterie pour la projection (défaut: %d)\n"
+            "  -t f     mesures rejouées depuis la trace f au lieu du capteur synthétique\n"
+            "  -T µs    durée de conversion du capteur de la trace (défaut: 0)\n"
+            "  -S kHz   horloge SPI tolérée par la carte SD simulée (défaut: %d)\n"
+            "  -l N     niveau de log émis sur l'UART simulée, 0-5 (défaut: 0, aucun)\n",
+            name, BENCH_ACTIVE_MA, BENCH_SD_MA, BENCH_SLEEP_UA, BENCH_BOOT_MS, BENCH_STUB_WAKE_US,
+            BENCH_BATTERY_MAH, host_cost_model.sd_max_freq_khz);
+}
+
+// Deep sleep simulé puis réveil par le timer
+static void sim_sleep(uint32_t sleep_sec, bool stub)
+{
+    host_sim_deep_sleep((uint64_t)(stub ? sleep_sec : chiro_prepare_sleep(sleep_sec)) * 1000000ULL);
+    host_sim_boot(false);
+    print_wakeup_info();
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = "bench_data";
+    const char *csv_path = NULL;
+    uint32_t cycles = 5000;
+    bench_power_model_t model = BENCH_POWER_MODEL_DEFAULT();
+    int log_level = ESP_LOG_NONE;
+    const char *trace_path = NULL;
+    uint32_t conversion_us = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:c:a:s:z:b:w:B:t:T:S:l:h")) != -1) {
+        switch (opt) {
+            case 'n': cycles = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': dir = optarg; break;
+            case 'c': csv_path = optarg; break;
+            case 'a': model.active_ma = strtof(optarg, NULL); break;
+            case 's': model.sd_ma = strtof(optarg, NULL); break;
+            case 'z': model.sleep_ua = strtof(optarg, NULL); break;
+            case 'b': model.boot_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'w': model.stub_wake_us = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'B': model.battery_mah = strtof(optarg, NULL); break;
+            case 't': trace_path = optarg; break;
+            case 'T': conversion_us = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'S': host_cost_model.sd_max_freq_khz = atoi(optarg); break;
+            case 'l': log_level = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    // Les logs coûtent du temps d'UART mais ne sont pas affichés
+    FILE *null_log = fopen("/dev/null", "w");
+    host_log_output = null_log;
+    host_log_level = (esp_log_level_t)log_level;
+
+    FILE *csv = NULL;
+    if (csv_path != NULL && (csv = fopen(csv_path, "w")) == NULL) {
+        perror(csv_path);
+        return 1;
+    }
+    if (trace_path != NULL) {
+        if (sensor_trace_load(trace_path, conversion_us) != 0) {
+            fprintf(stderr, "%s : aucune mesure lue\n", trace_path);
+            return 1;
+        }
+        static const sensor_driver_t *const trace_drivers[] = { &sensor_driver_trace };
+        sensors_use(trace_drivers, 1);
+    }
+    if (host_sim_open(dir, true) != 0) {
+        perror(dir);
+        return 1;
+    }
+
+    host_sim_boot(true);
+    print_wakeup_info();
+
+    bench_summary_t summary;
+    bench_run(cycles, sim_sleep, csv, &summary);
+    bench_print_summary(stdout, &summary, &model);
+
+    printf("Supports       : flash %llu o écrits / %llu o lus, %lu secteurs effacés ; "
+           "SD %llu o écrits, %lu fsync\n",
+           (unsigned long long)host_media_stats.flash_write_bytes,
+           (unsigned long long)host_media_stats.flash_read_bytes, (unsigned long)host_media_stats.flash_erases,
+           (unsigned long long)host_media_stats.sd_write_bytes, (unsigned long)host_media_stats.sd_syncs);
+
+    host_sim_close();
+    if (csv != NULL) {
+        fclose(csv);
+    }
+    if (null_log != NULL) {
+        fclose(null_log);
+    }
+    return 0;
+}
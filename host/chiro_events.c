@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "record.h"
+#include "event_log.h"
+
+/*
+ * 📟 LECTURE DU JOURNAL D'ÉVÉNEMENTS DE LA CARTE SD
+ *
+ * Le firmware n'écrit que des numéros d'événement et leurs arguments
+ * (events.bin, voir src/event_log.h) : les messages sont retrouvés ici depuis
+ * EVENT_CATALOG. Les entrées au CRC invalide (coupure pendant l'écriture) et
+ * les numéros inconnus d'un firmware plus récent sont comptés et ignorés.
+ */
+
+// Heures plus anciennes : secondes depuis le démarrage (heure pas encore restaurée)
+#define BOOT_EPOCH_LIMIT 946684800u  // 2000-01-01
+
+static const event_info_t event_infos[EVENT_COUNT] = { EVENT_CATALOG(EVENT_INFO) };
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-l niveaux] [-c] events.bin...\n"
+            "  -l s    seulement ces niveaux (ex. EW, défaut: EWI)\n"
+            "  -c      CSV (epoch,niveau,événement,arg0,arg1,message)\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    const char *levels = "EWI";
+    bool csv = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:ch")) != -1) {
+        switch (opt) {
+            case 'l': levels = optarg; break;
+            case 'c': csv = true; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (csv) {
+        puts("Epoch,Level,Event,Arg0,Arg1,Message");
+    }
+    long shown = 0, invalid = 0, unknown = 0;
+    long per_level[3] = { 0 };
+
+    for (int i = optind; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+
+        event_entry_t entry;
+        while (fread(&entry, sizeof(entry), 1, file) == 1) {
+            if (entry.crc != record_crc16(&entry, offsetof(event_entry_t, crc))) {
+                invalid++;
+                continue;
+            }
+            if (entry.event >= EVENT_COUNT) {
+                unknown++;
+                continue;
+            }
+            const event_info_t *info = &event_infos[entry.event];
+            if (strchr(levels, info->level) == NULL) {
+                continue;
+            }
+
+            char message[160];
+            snprintf(message, sizeof(message), info->format, (long)entry.args[0], (long)entry.args[1]);
+            if (csv) {
+                printf("%lu,%c,%s,%ld,%ld,\"%s\"\n", (unsigned long)entry.epoch, info->level, info->name,
+                       (long)entry.args[0], (long)entry.args[1], message);
+            } else {
+                char date[32];
+                if (entry.epoch < BOOT_EPOCH_LIMIT) {
+                    // Reconstruction après coupure, avant que l'heure ne soit restaurée
+                    snprintf(date, sizeof(date), "démarrage +%lu s", (unsigned long)entry.epoch);
+                } else {
+                    time_t t = (time_t)entry.epoch;
+                    struct tm tm;
+                    gmtime_r(&t, &tm);
+                    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+                }
+                printf("%-19s  %c  %-22s %s\n", date, info->level, info->name, message);
+            }
+            shown++;
+            per_level[info->level == 'E' ? 0 : info->level == 'W' ? 1 : 2]++;
+        }
+        fclose(file);
+    }
+
+    fprintf(stderr, "%ld événements (%ld erreurs, %ld avertissements), %ld invalides, %ld inconnus\n", shown,
+            per_level[0], per_level[1], invalid, unknown);
+    return 0;
+}
@@ -0,0 +1,863 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "buffer_raw.h"
+#include "record.h"
+#include "record_codec.h"
+
+/*
+ * 📤 LECTURE, VÉRIFICATION ET EXPORT DES JOURNAUX
+ *
+ * Relit les données rapatriées du terrain avec le code de format du firmware
+ * (record.c, record_codec.c, buffer_raw.h) :
+ * - journal du tampon SPIFFS (data_buffer.bin, versions 1 et 2)
+ * - image de la partition brute (BUFFER_BACKEND_RAW, lue avec esptool read_flash)
+ * - fichiers CSV de la carte SD (par jour ou data.csv historique)
+ *
+ * Les fichiers sont mappés en mémoire (mmap) et découpés en tranches
+ * décodées en parallèle : blocs compressés, secteurs de la partition, ou
+ * lignes CSV par fenêtres de CSV_WINDOW octets pour borner la mémoire sur
+ * les journaux de plusieurs Go. La séquence des ID (timekeeper.h) est
+ * ensuite vérifiée dans l'ordre de lecture, à travers tous les fichiers :
+ * - trou : saut en avant, les ID intermédiaires manquent
+ * - doublon : ID déjà vu depuis le dernier redémarrage (flush repris)
+ * - redémarrage : retour à l'ID 1 (coupure, firmwares sans ID persistants) ;
+ *   les ID réservés mais inutilisés avant une coupure apparaissent en trou
+ *
+ * Sortie en CSV (format de la SD) sur stdout, ou en colonnes : un fichier
+ * binaire little-endian par champ, lisible directement avec numpy.fromfile.
+ */
+
+#define MAX_THREADS 64
+#define CSV_WINDOW  (256u << 20)  // Octets de CSV décodés par passe
+
+typedef struct {
+    chiro_record_t *items;
+    size_t count;
+    size_t capacity;
+} record_array_t;
+
+typedef struct {
+    uint64_t records;     // Mesures valides lues
+    uint64_t exported;    // Mesures écrites en sortie
+    uint64_t crc_errors;  // Enregistrements ou blocs au CRC invalide (en mesures)
+    uint64_t malformed;   // Lignes CSV illisibles
+    uint64_t truncated;   // Journaux dont la fin n'a pas pu être relue
+    uint64_t gaps;        // Sauts en avant dans la séquence des ID
+    uint64_t missing;     // ID manquants dans ces sauts
+    uint64_t duplicates;  // Mesures dont l'ID a déjà été vu
+    uint64_t resets;      // Retours à l'ID 1
+    uint64_t backwards;   // Horodatages décroissants hors redémarrage
+} export_stats_t;
+
+static struct {
+    bool all;                 // -a : inclure les mesures déjà flushées
+    bool unique;              // -u : ne pas exporter les doublons
+    bool check_only;          // -q : vérification seule
+    int threads;              // -j
+    const char *columns_dir;  // -c : export en colonnes
+} options;
+
+static export_stats_t stats;
+
+// Suivi de la séquence des ID à travers les fichiers
+static struct {
+    bool started;
+    uint32_t run_max;     // Plus grand ID depuis le dernier redémarrage
+    uint32_t last_epoch;
+} sequence;
+
+// Fichiers de l'export en colonnes : champ de l'enregistrement copié tel quel
+// (offset), sauf l'intervalle décodé en secondes
+typedef struct {
+    const char *name;
+    const char *type;
+    size_t size;
+    size_t offset;
+    FILE *file;
+} column_t;
+
+#define COLUMN_INTERVAL SIZE_MAX
+#define COLUMN_TYPE(type)                                                                     \
+    ((type)-1 < 0 ? (sizeof(type) == 1 ? "i8" : sizeof(type) == 2 ? "i16" : "i32")          \
+                  : (sizeof(type) == 1 ? "u8" : sizeof(type) == 2 ? "u16" : "u32"))
+#define CHANNEL_COLUMN(name, field, type, min, max, scale, column) \
+    { #field, COLUMN_TYPE(type), sizeof(type), offsetof(chiro_record_t, field), NULL },
+
+static column_t columns[] = {
+    { "id",         "u32", 4, offsetof(chiro_record_t, id),    NULL },
+    { "epoch",      "u32", 4, offsetof(chiro_record_t, epoch), NULL },
+    RECORD_CHANNELS(CHANNEL_COLUMN)
+    { "flags",      "u8",  1, offsetof(chiro_record_t, flags), NULL },
+    { "interval_s", "u16", 2, COLUMN_INTERVAL,                 NULL },
+};
+#define COLUMN_COUNT (sizeof(columns) / sizeof(columns[0]))
+#define COLUMN_FIRST_CHANNEL 2
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-a] [-u] [-q] [-j threads] [-c dir] fichier...\n"
+            "  fichier  data_buffer.bin, image de la partition brute ou CSV de la SD\n"
+            "           (plusieurs fichiers sont lus à la suite, dans l'ordre donné)\n"
+            "  -a       inclure les mesures déjà flushées vers la SD (tampon)\n"
+            "  -u       ne pas exporter les doublons d'ID\n"
+            "  -q       vérifier seulement, sans export\n"
+            "  -j N     nombre de threads (défaut: nombre de cœurs)\n"
+            "  -c dir   export en colonnes dans dir au lieu du CSV sur stdout\n",
+            name);
+}
+
+static void array_reserve(record_array_t *array, size_t capacity)
+{
+    if (capacity <= array->capacity) {
+        return;
+    }
+    size_t grown = array->capacity * 2 > capacity ? array->capacity * 2 : capacity;
+    array->items = realloc(array->items, grown * sizeof(chiro_record_t));
+    if (array->items == NULL) {
+        fprintf(stderr, "mémoire insuffisante\n");
+        exit(1);
+    }
+    array->capacity = grown;
+}
+
+static void array_push(record_array_t *array, const chiro_record_t *record)
+{
+    if (array->count == array->capacity) {
+        array_reserve(array, array->capacity < 1024 ? 1024 : array->capacity * 2);
+    }
+    array->items[array->count++] = *record;
+}
+
+static void stats_add(export_stats_t *total, const export_stats_t *part)
+{
+    total->records += part->records;
+    total->crc_errors += part->crc_errors;
+    total->malformed += part->malformed;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🧵 DÉCOUPAGE EN TRANCHES PARALLÈLES
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Traite les éléments [begin, end) ; chaque travailleur a son tableau et ses compteurs
+typedef void (*slice_fn)(void *ctx, size_t begin, size_t end, record_array_t *out, export_stats_t *part);
+
+typedef struct {
+    slice_fn fn;
+    void *ctx;
+    size_t begin;
+    size_t end;
+    record_array_t out;
+    export_stats_t part;
+} slice_t;
+
+static void *slice_thread(void *arg)
+{
+    slice_t *slice = arg;
+    slice->fn(slice->ctx, slice->begin, slice->end, &slice->out, &slice->part);
+    return NULL;
+}
+
+static int slice_count(size_t count)
+{
+    return count < (size_t)options.threads ? (int)(count > 0 ? count : 1) : options.threads;
+}
+
+// Décode count éléments en parallèle puis concatène les tranches dans l'ordre
+static void parallel_decode(size_t count, slice_fn fn, void *ctx, record_array_t *out)
+{
+    int n = slice_count(count);
+    slice_t slices[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+
+    for (int i = 0; i < n; i++) {
+        slices[i] = (slice_t){ .fn = fn, .ctx = ctx, .begin = count * i / n, .end = count * (i + 1) / n };
+        if (n == 1 || pthread_create(&threads[i], NULL, slice_thread, &slices[i]) != 0) {
+            threads[i] = 0;
+            slice_thread(&slices[i]);
+        }
+    }
+
+    out->count = 0;
+    for (int i = 0; i < n; i++) {
+        if (threads[i] != 0) {
+            pthread_join(threads[i], NULL);
+        }
+        array_reserve(out, out->count + slices[i].out.count);
+        if (slices[i].out.count > 0) {
+            memcpy(out->items + out->count, slices[i].out.items, slices[i].out.count * sizeof(chiro_record_t));
+        }
+        out->count += slices[i].out.count;
+        stats_add(&stats, &slices[i].part);
+        free(slices[i].out.items);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🔢 VÉRIFICATION DE LA SÉQUENCE ET EXPORT
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Parcours séquentiel : compte les anomalies et retire les doublons si -u
+static void check_sequence(record_array_t *records)
+{
+    size_t kept = 0;
+
+    for (size_t i = 0; i < records->count; i++) {
+        const chiro_record_t *record = &records->items[i];
+        bool duplicate = false;
+
+        if (!sequence.started) {
+            sequence.started = true;
+            sequence.run_max = record->id;
+        } else if (record->id == 1) {
+            // Les firmwares antérieurs repartaient de 1 après une perte d'alimentation
+            stats.resets++;
+            sequence.run_max = record->id;
+        } else if (record->id <= sequence.run_max) {
+            duplicate = true;
+            stats.duplicates++;
+        } else {
+            if (record->id > sequence.run_max + 1) {
+                stats.gaps++;
+                stats.missing += record->id - sequence.run_max - 1;
+            }
+            if (record->epoch < sequence.last_epoch) {
+                stats.backwards++;
+            }
+            sequence.run_max = record->id;
+        }
+        if (!duplicate) {
+            sequence.last_epoch = record->epoch;
+        }
+
+        if (!(duplicate && options.unique)) {
+            records->items[kept++] = *record;
+        }
+    }
+    records->count = kept;
+}
+
+typedef struct {
+    const chiro_record_t *records;
+    size_t count;
+    int n;
+    char *text[MAX_THREADS];
+    size_t length[MAX_THREADS];
+} csv_format_t;
+
+typedef struct {
+    csv_format_t *format;
+    int index;
+} csv_format_task_t;
+
+static void *format_thread(void *arg)
+{
+    csv_format_task_t *task = arg;
+    csv_format_t *format = task->format;
+    size_t begin = format->count * task->index / format->n;
+    size_t end = format->count * (task->index + 1) / format->n;
+
+    char *text = malloc((end - begin) * RECORD_CSV_MAX_LEN + 1);
+    size_t length = 0;
+    if (text != NULL) {
+        for (size_t i = begin; i < end; i++) {
+            length += record_to_csv(&format->records[i], text + length, RECORD_CSV_MAX_LEN);
+        }
+    }
+    format->text[task->index] = text;
+    format->length[task->index] = length;
+    return NULL;
+}
+
+// Mise en forme parallèle, écriture dans l'ordre
+static bool write_csv(const record_array_t *records)
+{
+    csv_format_t format = { .records = records->items, .count = records->count, .n = slice_count(records->count) };
+    csv_format_task_t tasks[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+
+    for (int i = 0; i < format.n; i++) {
+        tasks[i] = (csv_format_task_t){ .format = &format, .index = i };
+        if (format.n == 1 || pthread_create(&threads[i], NULL, format_thread, &tasks[i]) != 0) {
+            threads[i] = 0;
+            format_thread(&tasks[i]);
+        }
+    }
+
+    bool ok = true;
+    for (int i = 0; i < format.n; i++) {
+        if (threads[i] != 0) {
+            pthread_join(threads[i], NULL);
+        }
+        if (format.text[i] == NULL ||
+            fwrite(format.text[i], 1, format.length[i], stdout) != format.length[i]) {
+            ok = false;
+        }
+        free(format.text[i]);
+    }
+    return ok;
+}
+
+static bool open_columns(const char *dir)
+{
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        perror(dir);
+        return false;
+    }
+    for (size_t c = 0; c < COLUMN_COUNT; c++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.%s", dir, columns[c].name, columns[c].type);
+        columns[c].file = fopen(path, "wb");
+        if (columns[c].file == NULL) {
+            perror(path);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool write_columns(const record_array_t *records)
+{
+    if (records->count == 0) {
+        return true;
+    }
+    uint8_t *column = malloc(records->count * 4);
+    if (column == NULL) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t c = 0; c < COLUMN_COUNT && ok; c++) {
+        for (size_t i = 0; i < records->count; i++) {
+            const chiro_record_t *record = &records->items[i];
+            if (columns[c].offset == COLUMN_INTERVAL) {
+                ((uint16_t *)column)[i] = (uint16_t)record_interval_seconds(record->interval_code);
+            } else {
+                memcpy(column + i * columns[c].size, (const uint8_t *)record + columns[c].offset, columns[c].size);
+            }
+        }
+        ok = fwrite(column, columns[c].size, records->count, columns[c].file) == records->count;
+    }
+    free(column);
+    return ok;
+}
+
+// Description des colonnes, écrite en fin d'export
+static bool close_columns(const char *dir)
+{
+    bool ok = true;
+    for (size_t c = 0; c < COLUMN_COUNT; c++) {
+        ok = fclose(columns[c].file) == 0 && ok;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/columns.txt", dir);
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "# colonnes little-endian, %llu lignes ; valeurs absentes : voir flags (",
+            (unsigned long long)stats.exported);
+    for (int channel = 0; channel < RECORD_CHANNEL_COUNT; channel++) {
+        fprintf(file, "%s%u = %s", channel > 0 ? ", " : "", 1u << channel,
+                columns[COLUMN_FIRST_CHANNEL + channel].name);
+    }
+    fprintf(file, ")\n");
+    for (size_t c = 0; c < COLUMN_COUNT; c++) {
+        fprintf(file, "%s.%s\n", columns[c].name, columns[c].type);
+    }
+    return fclose(file) == 0 && ok;
+}
+
+static bool emit(record_array_t *records)
+{
+    check_sequence(records);
+    stats.exported += options.check_only ? 0 : records->count;
+
+    if (options.check_only || records->count == 0) {
+        return true;
+    }
+    return options.columns_dir != NULL ? write_columns(records) : write_csv(records);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🗜️ JOURNAL DU TAMPON SPIFFS
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    const uint8_t *data;
+    const size_t *offsets;  // Position de chaque bloc (v2) dans le fichier
+    const uint32_t *ranks;  // Rang de la première mesure de chaque bloc
+    uint32_t skip;          // Mesures déjà flushées à ignorer
+} buffer_log_t;
+
+// wanted : mesure à exporter (en attente, ou toutes avec -a)
+static void keep_record(const chiro_record_t *record, bool wanted, record_array_t *out, export_stats_t *part)
+{
+    if (!record_is_valid(record)) {
+        part->crc_errors++;
+    } else if (wanted) {
+        part->records++;
+        array_push(out, record);
+    }
+}
+
+static void decode_fixed(void *ctx, size_t begin, size_t end, record_array_t *out, export_stats_t *part)
+{
+    const buffer_log_t *log = ctx;
+    const chiro_record_t *records = (const chiro_record_t *)(log->data + sizeof(record_log_header_t));
+
+    array_reserve(out, end - begin);
+    for (size_t i = begin; i < end; i++) {
+        keep_record(&records[i], i >= log->skip, out, part);
+    }
+}
+
+static void decode_blocks(void *ctx, size_t begin, size_t end, record_array_t *out, export_stats_t *part)
+{
+    const buffer_log_t *log = ctx;
+    chiro_record_t records[RECORD_BLOCK_MAX_RECORDS];
+
+    for (size_t b = begin; b < end; b++) {
+        const record_block_header_t *header = (const record_block_header_t *)(log->data + log->offsets[b]);
+        if (!record_block_decode(header, (const uint8_t *)(header + 1), records)) {
+            part->crc_errors += header->count;
+            continue;
+        }
+        for (int i = 0; i < header->count; i++) {
+            keep_record(&records[i], log->ranks[b] + i >= log->skip, out, part);
+        }
+    }
+}
+
+static bool export_buffer_log(const char *path, const uint8_t *data, size_t size)
+{
+    const record_log_header_t *header = (const record_log_header_t *)data;
+    if (!record_log_header_check(header)) {
+        fprintf(stderr, "%s: en-tête invalide ou version inconnue\n", path);
+        return false;
+    }
+
+    buffer_log_t log = { .data = data, .skip = options.all ? 0 : header->consumed };
+    record_array_t records = { 0 };
+    size_t *offsets = NULL;
+    uint32_t *ranks = NULL;
+
+    if (header->version == RECORD_LOG_VERSION_FIXED) {
+        size_t count = (size - sizeof(*header)) / sizeof(chiro_record_t);
+        if ((size - sizeof(*header)) % sizeof(chiro_record_t) != 0) {
+            stats.truncated++;
+        }
+        parallel_decode(count, decode_fixed, &log, &records);
+    } else {
+        // Premier passage séquentiel sur les en-têtes : position et rang de chaque bloc
+        size_t count = 0, capacity = 0;
+        size_t pos = sizeof(*header);
+        uint32_t rank = 0;
+
+        while (pos < size) {
+            const record_block_header_t *block = (const record_block_header_t *)(data + pos);
+            if (size - pos < sizeof(*block) || !record_block_header_check(block) ||
+                size - pos - sizeof(*block) < block->payload_size) {
+                stats.truncated++;
+                break;
+            }
+            if (count == capacity) {
+                capacity = capacity ? capacity * 2 : 4096;
+                offsets = realloc(offsets, capacity * sizeof(*offsets));
+                ranks = realloc(ranks, capacity * sizeof(*ranks));
+                if (offsets == NULL || ranks == NULL) {
+                    fprintf(stderr, "mémoire insuffisante\n");
+                    exit(1);
+                }
+            }
+            offsets[count] = pos;
+            ranks[count++] = rank;
+            rank += block->count;
+            pos += sizeof(*block) + block->payload_size;
+        }
+
+        log.offsets = offsets;
+        log.ranks = ranks;
+        parallel_decode(count, decode_blocks, &log, &records);
+    }
+
+    fprintf(stderr, "%s: journal du tampon version %u, %zu mesures%s\n", path, header->version, records.count,
+            options.all ? "" : " en attente");
+    bool ok = emit(&records);
+    free(records.items);
+    free(offsets);
+    free(ranks);
+    return ok;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 🗄️ IMAGE DE LA PARTITION BRUTE
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint32_t seq;
+    uint32_t sector;
+} raw_sector_t;
+
+typedef struct {
+    const uint8_t *data;
+    const raw_sector_t *sectors;  // Secteurs valides, par séquence croissante
+} raw_image_t;
+
+static int compare_seq(const void *a, const void *b)
+{
+    const raw_sector_t *x = a, *y = b;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+static bool slot_erased(const chiro_record_t *record)
+{
+    static const uint8_t erased[sizeof(chiro_record_t)] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+    return memcmp(record, erased, sizeof(erased)) == 0;
+}
+
+static void decode_sectors(void *ctx, size_t begin, size_t end, record_array_t *out, export_stats_t *part)
+{
+    const raw_image_t *image = ctx;
+
+    for (size_t s = begin; s < end; s++) {
+        const uint8_t *sector = image->data + (size_t)image->sectors[s].sector * RAW_SECTOR_SIZE;
+        const raw_sector_header_t *header = (const raw_sector_header_t *)sector;
+        const chiro_record_t *slots = (const chiro_record_t *)(sector + RAW_HEADER_SIZE);
+
+        for (uint32_t slot = 0; slot < RAW_SLOTS_PER_SECTOR && !slot_erased(&slots[slot]); slot++) {
+            bool consumed = !(header->consumed_mask & (1u << (slot / RAW_CONSUME_GRANULE)));
+            keep_record(&slots[slot], options.all || !consumed, out, part);
+        }
+    }
+}
+
+static bool is_raw_image(const uint8_t *data, size_t size)
+{
+    if (size == 0 || size % RAW_SECTOR_SIZE != 0) {
+        return false;
+    }
+    for (size_t offset = 0; offset < size; offset += RAW_SECTOR_SIZE) {
+        if (raw_sector_header_valid((const raw_sector_header_t *)(data + offset))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool export_raw_image(const char *path, const uint8_t *data, size_t size)
+{
+    uint32_t sector_count = size / RAW_SECTOR_SIZE;
+    raw_sector_t *sectors = malloc(sector_count * sizeof(*sectors));
+    if (sectors == NULL) {
+        return false;
+    }
+
+    uint32_t valid = 0;
+    for (uint32_t sector = 0; sector < sector_count; sector++) {
+        const raw_sector_header_t *header = (const raw_sector_header_t *)(data + (size_t)sector * RAW_SECTOR_SIZE);
+        if (raw_sector_header_valid(header)) {
+            sectors[valid++] = (raw_sector_t){ .seq = header->seq, .sector = sector };
+        }
+    }
+    qsort(sectors, valid, sizeof(*sectors), compare_seq);
+
+    raw_image_t image = { .data = data, .sectors = sectors };
+    record_array_t records = { 0 };
+    parallel_decode(valid, decode_sectors, &image, &records);
+
+    fprintf(stderr, "%s: partition brute, %u/%u secteurs utilisés, %zu mesures%s\n", path, valid, sector_count,
+            records.count, options.all ? "" : " en attente");
+    bool ok = emit(&records);
+    free(records.items);
+    free(sectors);
+    return ok;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 📄 FICHIERS CSV DE LA CARTE SD
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool parse_uint(const char **cursor, const char *end, uint32_t *value)
+{
+    const char *p = *cursor;
+    uint64_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9' && v <= UINT32_MAX) {
+        v = v * 10 + (uint64_t)(*p++ - '0');
+    }
+    if (p == *cursor || v > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    *cursor = p;
+    return true;
+}
+
+// Valeur en virgule fixe d'échelle scale ("-12.34", "N/A" = *present à false) en valeur
+// flottante pour record_make()
+static bool parse_fixed(const char **cursor, const char *end, int32_t scale, float *value, bool *present)
+{
+    const char *p = *cursor;
+    if (end - p >= 3 && memcmp(p, "N/A", 3) == 0) {
+        *present = false;
+        *cursor = p + 3;
+        return true;
+    }
+
+    bool negative = p < end && *p == '-';
+    p += negative;
+    uint32_t units;
+    if (!parse_uint(&p, end, &units)) {
+        return false;
+    }
+    int32_t fixed = (int32_t)units * scale;
+    if (p < end && *p == '.') {
+        p++;
+        int32_t digit = scale / 10;
+        while (p < end && *p >= '0' && *p <= '9') {
+            fixed += digit * (*p++ - '0');
+            digit /= 10;
+        }
+    }
+    *value = (float)(negative ? -fixed : fixed) / (float)scale;
+    *present = true;
+    *cursor = p;
+    return true;
+}
+
+static bool expect(const char **cursor, const char *end, char c)
+{
+    if (*cursor < end && **cursor == c) {
+        (*cursor)++;
+        return true;
+    }
+    return false;
+}
+
+// Ligne "ID,DateTime,<canaux de RECORD_CHANNELS>[,Interval_s]" (sans le '\n')
+static bool parse_line(const char *p, const char *end, chiro_record_t *record)
+{
+    uint32_t id, epoch, interval = 0;
+    record_values_t values = {0};
+    bool present;
+
+    if (end > p && end[-1] == '\r') {
+        end--;
+    }
+    if (!parse_uint(&p, end, &id) || !expect(&p, end, ',') || !parse_uint(&p, end, &epoch)) {
+        return false;
+    }
+#define PARSE_CHANNEL(name, field, type, min, max, scale, column)                            \
+    if (!expect(&p, end, ',') || !parse_fixed(&p, end, (scale), &values.name, &present)) { \
+        return false;                                                                    \
+    }                                                                                    \
+    values.present |= present ? RECORD_VALUE_BIT(name) : 0;
+    RECORD_CHANNELS(PARSE_CHANNEL)
+#undef PARSE_CHANNEL
+    if (expect(&p, end, ',') && p < end && !parse_uint(&p, end, &interval)) {
+        return false;
+    }
+    if (p != end) {
+        return false;
+    }
+    record_make(record, id, epoch, &values, interval);
+    return true;
+}
+
+typedef struct {
+    const char *data;
+    size_t begin;  // Fenêtre courante
+    size_t end;
+} csv_window_t;
+
+// Début de la ligne qui contient (ou suit) pos
+static size_t line_start(const char *data, size_t begin, size_t end, size_t pos)
+{
+    if (pos <= begin) {
+        return begin;
+    }
+    const char *newline = memchr(data + pos - 1, '\n', end - pos + 1);
+    return newline != NULL ? (size_t)(newline - data) + 1 : end;
+}
+
+static void decode_lines(void *ctx, size_t begin, size_t end, record_array_t *out, export_stats_t *part)
+{
+    const csv_window_t *window = ctx;
+    const char *data = window->data;
+
+    // Tranches d'octets recalées sur les débuts de ligne
+    size_t pos = line_start(data, window->begin, window->end, window->begin + begin);
+    size_t stop = line_start(data, window->begin, window->end, window->begin + end);
+
+    array_reserve(out, (stop - pos) / 32 + 1);
+    while (pos < stop) {
+        const char *newline = memchr(data + pos, '\n', stop - pos);
+        size_t line_end = newline != NULL ? (size_t)(newline - data) : stop;
+        chiro_record_t record;
+
+        if (line_end == pos || (line_end == pos + 1 && data[pos] == '\r') ||
+            (line_end - pos >= 3 && memcmp(data + pos, "ID,", 3) == 0)) {
+            // Ligne vide ou en-tête
+        } else if (parse_line(data + pos, data + line_end, &record)) {
+            part->records++;
+            array_push(out, &record);
+        } else {
+            part->malformed++;
+        }
+        pos = line_end + 1;
+    }
+}
+
+static bool export_csv(const char *path, const char *data, size_t size)
+{
+    record_array_t records = { 0 };
+    uint64_t before = stats.records;
+    bool ok = true;
+
+    for (size_t begin = 0; begin < size && ok;) {
+        size_t end = size - begin > CSV_WINDOW ? line_start(data, begin, size, begin + CSV_WINDOW) : size;
+        csv_window_t window = { .data = data, .begin = begin, .end = end };
+
+        parallel_decode(end - begin, decode_lines, &window, &records);
+        ok = emit(&records);
+        begin = end;
+    }
+
+    fprintf(stderr, "%s: CSV, %llu mesures\n", path, (unsigned long long)(stats.records - before));
+    free(records.items);
+    return ok;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool export_file(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size == 0) {
+        fprintf(stderr, "%s: fichier vide\n", path);
+        close(fd);
+        return true;
+    }
+
+    const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+
+    bool ok;
+    if (size >= sizeof(record_log_header_t) && ((const record_log_header_t *)data)->magic == RECORD_LOG_MAGIC) {
+        ok = export_buffer_log(path, data, size);
+    } else if (is_raw_image(data, size)) {
+        ok = export_raw_image(path, data, size);
+    } else if ((data[0] >= '0' && data[0] <= '9') || data[0] == 'I') {
+        ok = export_csv(path, (const char *)data, size);
+    } else {
+        fprintf(stderr, "%s: format inconnu\n", path);
+        ok = false;
+    }
+
+    munmap((void *)data, size);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    options.threads = cores > 0 ? (int)cores : 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "auqj:c:h")) != -1) {
+        switch (opt) {
+            case 'a': options.all = true; break;
+            case 'u': options.unique = true; break;
+            case 'q': options.check_only = true; break;
+            case 'j': options.threads = atoi(optarg); break;
+            case 'c': options.columns_dir = optarg; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind == argc) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (options.threads < 1) {
+        options.threads = 1;
+    } else if (options.threads > MAX_THREADS) {
+        options.threads = MAX_THREADS;
+    }
+
+    struct timespec start, stop;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (!options.check_only) {
+        if (options.columns_dir != NULL) {
+            if (!open_columns(options.columns_dir)) {
+                return 1;
+            }
+        } else {
+            fputs(RECORD_CSV_HEADER, stdout);
+        }
+    }
+
+    bool ok = true;
+    for (int i = optind; i < argc && ok; i++) {
+        ok = export_file(argv[i]);
+    }
+
+    if (!options.check_only) {
+        if (options.columns_dir != NULL) {
+            ok = close_columns(options.columns_dir) && ok;
+        } else {
+            ok = fflush(stdout) == 0 && ok;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    fprintf(stderr, "📊 %llu mesures lues, %llu exportées en %.2f s (%d threads)\n",
+            (unsigned long long)stats.records, (unsigned long long)stats.exported,
+            (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9, options.threads);
+    fprintf(stderr, "   CRC invalides: %llu, lignes illisibles: %llu, fins de journal illisibles: %llu\n",
+            (unsigned long long)stats.crc_errors, (unsigned long long)stats.malformed,
+            (unsigned long long)stats.truncated);
+    fprintf(stderr, "   ID: %llu trou(s) (%llu manquants), %llu doublon(s)%s, %llu redémarrage(s), "
+            "%llu recul(s) d'horodatage\n",
+            (unsigned long long)stats.gaps, (unsigned long long)stats.missing,
+            (unsigned long long)stats.duplicates, options.unique ? " retirés" : "",
+            (unsigned long long)stats.resets, (unsigned long long)stats.backwards);
+
+    if (!ok) {
+        fprintf(stderr, "❌ export interrompu\n");
+        return 1;
+    }
+    return 0;
+}
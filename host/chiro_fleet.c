@@ -0,0 +1,650 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <esp_log.h>
+
+#include "host_sim.h"
+#include "bench.h"
+#include "buffer_backend.h"
+#include "config.h"
+#include "event_log.h"
+#include "flash_buffer.h"
+#include "logger.h"
+#include "record.h"
+#include "sensor.h"
+#include "sensor_trace.h"
+#include "staging.h"
+#include "storage_health.h"
+
+/*
+ * 🏔️ SIMULATEUR DE FLOTTE
+ *
+ * Fait vivre une saison à chaque logger d'une flotte (un site par ligne du
+ * fichier -f), pour chaque taille de la partition data_buffer demandée (-P),
+ * par les mêmes chemins que chiro_bench : réveils, lot RTC, tampon flash,
+ * flushs vers la SD. Chaque site a sa trace de mesures, son profil de
+ * supports (cartes et flash plus ou moins lentes) et ses coupures
+ * d'alimentation.
+ *
+ * Les variables de src/ et la RTC memory sont globales : chaque logger
+ * virtuel est un processus fils, avec son propre répertoire de simulation,
+ * et -j fils tournent en même temps (un par cœur par défaut).
+ *
+ * Seuil de flush, durée de sommeil et politique d'échantillonnage sont des
+ * réglages de config.h : un exécutable par configuration, voir
+ * CHIRO_FLEET_CONFIGS dans host/CMakeLists.txt. Les lignes CSV de plusieurs
+ * configurations se concatènent.
+ *
+ * Risque de perte : mesures du lot RTC effacées aux coupures, remplissage
+ * maximal du tampon (relevé au début des flushs), jours avant tampon plein si
+ * la SD ne répond plus, erreurs et avertissements du journal d'événements.
+ * Un logger est à risque si son tampon tiendrait moins de -m jours sans SD,
+ * s'il a dépassé le tampon, si ses mesures ne partent plus vers la SD (plus
+ * de BUFFER_FLUSH_DEFER_MAX en attente en fin de saison) ou si le journal
+ * contient des erreurs.
+ *
+ * Les fichiers par jour de la SD sont relus en fin de saison : un ID ou un
+ * horodatage qui recule trahit une horloge simulée faussée (clock_regressions,
+ * code de sortie 1), qui rendrait tout le dimensionnement faux.
+ */
+
+#define FLEET_MAX_SITES 256
+#define FLEET_MAX_SIZES 16
+
+typedef struct {
+    char name[32];
+    char trace[256];          // Vide : capteur synthétique
+    uint32_t conversion_us;   // Durée de conversion du capteur de la trace
+    int sd_max_freq_khz;      // Horloge SPI tolérée par la carte (0 : host_cost_model)
+    float sd_factor;          // Multiplie les durées d'accès à la SD
+    float flash_factor;       // Multiplie les durées d'accès à la flash
+    uint32_t power_cut_days;  // Coupure d'alimentation tous les N jours (0 : jamais)
+} site_t;
+
+typedef struct {
+    bool ok;
+    bench_summary_t summary;
+    float mah_day;
+    float buffer_peak_pct;     // Remplissage maximal du tampon
+    int32_t buffer_full_days;  // Dernière projection de storage_health (-1 : inconnue)
+    uint32_t pending;          // Mesures pas encore sur la SD en fin de saison
+    uint32_t cuts;
+    uint32_t lost;             // Mesures du lot RTC effacées par les coupures
+    uint32_t errors;
+    uint32_t warnings;
+    uint32_t clock_regressions;  // Mesures de la SD dont l'ID ou l'horodatage recule
+} fleet_result_t;
+
+typedef struct {
+    const site_t *site;
+    uint32_t partition_size;
+    fleet_result_t result;
+    pid_t pid;
+    int fd;
+} fleet_job_t;
+
+static site_t sites[FLEET_MAX_SITES];
+static int site_count = 0;
+static bench_power_model_t model = BENCH_POWER_MODEL_DEFAULT();
+static int32_t margin_days = 7;
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-f sites.csv] [-P tailles] [-D jours] [-j N] [-d dir] [-B mAh] [-m jours]\n"
+            "  -f f     sites de la flotte (défaut: un site, capteur synthétique)\n"
+            "           site,trace,conversion_us,sd_khz,sd_facteur,flash_facteur,coupure_jours\n"
+            "  -P l     tailles de data_buffer séparées par des virgules (défaut: 0x%X)\n"
+            "  -D N     jours simulés par logger (défaut: 180)\n"
+            "  -j N     loggers simulés en parallèle (défaut: un par cœur)\n"
+            "  -d dir   répertoire des simulations (défaut: fleet_data, un sous-répertoire par logger)\n"
+            "  -B mAh   capacité de batterie pour la projection (défaut: %d)\n"
+            "  -m N     autonomie minimale du tampon sans SD, en jours (défaut: 7)\n",
+            name, HOST_PARTITION_SIZE, BENCH_BATTERY_MAH);
+}
+
+// ---------------------------------------------------------------------------
+// 📄 SITES DE LA FLOTTE
+// ---------------------------------------------------------------------------
+
+// Champ suivant d'une ligne CSV (chaîne vide si absent)
+static char *next_field(char **line)
+{
+    char *field = strsep(line, ",");
+    if (field == NULL) {
+        return "";
+    }
+    field[strcspn(field, "\r\n")] = '\0';
+    while (*field == ' ') {
+        field++;
+    }
+    return field;
+}
+
+// Lignes vides, commentaires (#) et en-tête (site,...) ignorés
+static int load_sites(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL && site_count < FLEET_MAX_SITES) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || strncmp(line, "site,", 5) == 0) {
+            continue;
+        }
+        char *cursor = line;
+        site_t *site = &sites[site_count];
+        memset(site, 0, sizeof(*site));
+        snprintf(site->name, sizeof(site->name), "%s", next_field(&cursor));
+        const char *trace = next_field(&cursor);
+        if (strcmp(trace, "-") != 0) {
+            snprintf(site->trace, sizeof(site->trace), "%s", trace);
+        }
+        site->conversion_us = (uint32_t)strtoul(next_field(&cursor), NULL, 10);
+        site->sd_max_freq_khz = atoi(next_field(&cursor));
+        const char *factor = next_field(&cursor);
+        site->sd_factor = *factor != '\0' ? strtof(factor, NULL) : 1.0f;
+        factor = next_field(&cursor);
+        site->flash_factor = *factor != '\0' ? strtof(factor, NULL) : 1.0f;
+        site->power_cut_days = (uint32_t)strtoul(next_field(&cursor), NULL, 10);
+        if (site->name[0] != '\0') {
+            site_count++;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+// Tailles de partition séparées par des virgules (décimal ou 0x...)
+static int parse_sizes(char *list, uint32_t *sizes)
+{
+    int count = 0;
+    char *item;
+    while ((item = strsep(&list, ",")) != NULL && count < FLEET_MAX_SIZES) {
+        unsigned long size = strtoul(item, NULL, 0);
+        if (size == 0 || size % HOST_FLASH_SECTOR_SIZE != 0 || size > UINT32_MAX) {
+            fprintf(stderr, "%s : taille de partition invalide (multiple de %d octets attendu)\n", item,
+                    HOST_FLASH_SECTOR_SIZE);
+            return -1;
+        }
+        sizes[count++] = (uint32_t)size;
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// 🦇 UN LOGGER VIRTUEL (processus fils)
+// ---------------------------------------------------------------------------
+
+static int64_t cut_period_us = 0;
+static int64_t next_cut_us = 0;
+static fleet_result_t *current = NULL;
+
+// Cavité simulée pour le programme ULP, comme dans chiro_sim
+static uint16_t cavity_adc(int adc_unit, int channel, int64_t now_us)
+{
+    (void)adc_unit;
+    double phase = 2.0 * M_PI * (double)(now_us % 86400000000LL) / 86400e6;
+    double raw;
+    if (channel == ULP_ADC_TEMPERATURE_CHANNEL) {
+        raw = (12.0 + 1.5 * sin(phase) - ULP_TEMPERATURE_OFFSET) / ULP_TEMPERATURE_PER_LSB;
+    } else {
+        raw = (90.0 + 4.0 * cos(phase) - ULP_HUMIDITY_OFFSET) / ULP_HUMIDITY_PER_LSB;
+    }
+    return raw < 0.0 ? 0 : (raw > 4095.0 ? 4095 : (uint16_t)lround(raw));
+}
+
+static int64_t scaled(int64_t us, float factor)
+{
+    return (int64_t)llround((double)us * factor);
+}
+
+// Profil de supports du site
+static void apply_profile(const site_t *site)
+{
+    host_cost_model_t *cost = &host_cost_model;
+    cost->sd_mount_us = scaled(cost->sd_mount_us, site->sd_factor);
+    cost->sd_open_us = scaled(cost->sd_open_us, site->sd_factor);
+    cost->sd_read_us_per_kb = scaled(cost->sd_read_us_per_kb, site->sd_factor);
+    cost->sd_write_us_per_kb = scaled(cost->sd_write_us_per_kb, site->sd_factor);
+    cost->sd_sync_us = scaled(cost->sd_sync_us, site->sd_factor);
+    cost->spiffs_mount_us = scaled(cost->spiffs_mount_us, site->flash_factor);
+    cost->spiffs_open_us = scaled(cost->spiffs_open_us, site->flash_factor);
+    cost->flash_read_us_per_kb = scaled(cost->flash_read_us_per_kb, site->flash_factor);
+    cost->flash_write_us_per_kb = scaled(cost->flash_write_us_per_kb, site->flash_factor);
+    cost->flash_erase_us = scaled(cost->flash_erase_us, site->flash_factor);
+    if (site->sd_max_freq_khz > 0) {
+        cost->sd_max_freq_khz = site->sd_max_freq_khz;
+    }
+}
+
+// Remplissage du tampon relevé au dernier flush
+static void track_health(void)
+{
+    const storage_health_t *health = storage_health_last();
+    if (health == NULL) {
+        return;
+    }
+    if (health->usage.total_bytes > 0) {
+        float pct = 100.0f * (float)health->usage.used_bytes / (float)health->usage.total_bytes;
+        if (pct > current->buffer_peak_pct) {
+            current->buffer_peak_pct = pct;
+        }
+    }
+    current->buffer_full_days = health->buffer_full_days;
+}
+
+// Deep sleep simulé, coupure d'alimentation quand elle tombe pendant le sommeil
+static void fleet_sleep(uint32_t sleep_sec, bool stub)
+{
+    track_health();
+    host_sim_deep_sleep((uint64_t)(stub ? sleep_sec : chiro_prepare_sleep(sleep_sec)) * 1000000ULL);
+
+    bool cut = cut_period_us > 0 && host_sim_now_us() >= next_cut_us;
+    if (cut) {
+        // Le lot RTC disparaît avec la RTC memory
+        current->lost += staging_count();
+        current->cuts++;
+        next_cut_us += cut_period_us;
+    }
+    host_sim_boot(cut);
+    print_wakeup_info();
+}
+
+// Erreurs et avertissements vidés dans le journal d'événements de la SD
+static void count_events(fleet_result_t *result)
+{
+    static const event_info_t infos[EVENT_COUNT] = { EVENT_CATALOG(EVENT_INFO) };
+    FILE *file = fopen(SD_EVENTS_FILE, "rb");
+    if (file == NULL) {
+        return;
+    }
+    event_entry_t entry;
+    while (fread(&entry, sizeof(entry), 1, file) == 1) {
+        if (entry.crc != record_crc16(&entry, offsetof(event_entry_t, crc)) || entry.event >= EVENT_COUNT) {
+            continue;
+        }
+        result->errors += infos[entry.event].level == 'E';
+        result->warnings += infos[entry.event].level == 'W';
+    }
+    fclose(file);
+}
+
+// Fichiers par jour de la SD (AAAA/MM/JJ.csv), triés ensuite par date
+static char **day_files = NULL;
+static size_t day_file_count = 0;
+
+static int collect_day_file(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    (void)st;
+    if (type != FTW_F || ftw->level != 3) {
+        return 0;
+    }
+    char **grown = realloc(day_files, (day_file_count + 1) * sizeof(*day_files));
+    if (grown == NULL || (grown[day_file_count] = strdup(path)) == NULL) {
+        day_files = grown != NULL ? grown : day_files;
+        return -1;
+    }
+    day_files = grown;
+    day_file_count++;
+    return 0;
+}
+
+static int compare_paths(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Lignes ID,DateTime,... lues dans l'ordre des jours : ni l'ID ni l'horodatage
+// ne doivent reculer d'une mesure à la suivante
+static uint32_t count_clock_regressions(void)
+{
+    nftw(SD_WORK_DIR, collect_day_file, 8, FTW_PHYS);
+    if (day_file_count > 0) {
+        qsort(day_files, day_file_count, sizeof(*day_files), compare_paths);
+    }
+
+    uint32_t regressions = 0;
+    unsigned long last_id = 0, last_epoch = 0;
+    for (size_t i = 0; i < day_file_count; i++) {
+        FILE *file = fopen(day_files[i], "r");
+        char line[256];
+        while (file != NULL && fgets(line, sizeof(line), file) != NULL) {
+            if (line[0] < '0' || line[0] > '9') {
+                continue;
+            }
+            char *end;
+            unsigned long id = strtoul(line, &end, 10);
+            if (*end != ',') {
+                continue;
+            }
+            unsigned long epoch = strtoul(end + 1, NULL, 10);
+            regressions += id < last_id || epoch < last_epoch;
+            last_id = id;
+            last_epoch = epoch;
+        }
+        if (file != NULL) {
+            fclose(file);
+        }
+        free(day_files[i]);
+    }
+    free(day_files);
+    day_files = NULL;
+    day_file_count = 0;
+    return regressions;
+}
+
+static void run_logger(const char *dir, const site_t *site, uint32_t partition_size, uint32_t days,
+                       fleet_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->buffer_full_days = -1;
+    current = result;
+
+    // Trace lue avant de passer dans le répertoire de simulation
+    if (site->trace[0] != '\0') {
+        if (sensor_trace_load(site->trace, site->conversion_us) != 0) {
+            fprintf(stderr, "%s : aucune mesure lue\n", site->trace);
+            return;
+        }
+        static const sensor_driver_t *const trace_drivers[] = { &sensor_driver_trace };
+        sensors_use(trace_drivers, 1);
+    }
+    apply_profile(site);
+    host_ulp_adc = cavity_adc;
+    host_partition_size = partition_size;
+    if (host_sim_open(dir, true) != 0) {
+        perror(dir);
+        return;
+    }
+    cut_period_us = (int64_t)site->power_cut_days * 86400 * 1000000;
+    next_cut_us = cut_period_us;
+
+    host_sim_boot(true);
+    print_wakeup_info();
+    bench_run_days(days, fleet_sleep, NULL, &result->summary);
+    track_health();
+
+    // Mesures encore en flash ou dans le lot RTC en fin de saison
+    reset_flash_buffer_session();
+    int pending = count_buffer_records();
+    result->pending = (uint32_t)(pending > 0 ? pending : 0) + staging_count();
+    result->mah_day = bench_mah_per_day(&result->summary, &model);
+    count_events(result);
+    result->clock_regressions = count_clock_regressions();
+    result->ok = true;
+    host_sim_close();
+}
+
+// ---------------------------------------------------------------------------
+// 🧵 LOGGERS EN PARALLÈLE
+// ---------------------------------------------------------------------------
+
+static int start_job(fleet_job_t *job, const char *base, uint32_t days)
+{
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s/%s_%lu", base, job->site->name, (unsigned long)(job->partition_size / 1024));
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        fleet_result_t result;
+        run_logger(dir, job->site, job->partition_size, days, &result);
+        // Bilan plus court que PIPE_BUF : écrit d'un bloc, lu après la fin du fils
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    job->pid = pid;
+    job->fd = fds[0];
+    return 0;
+}
+
+static void finish_job(fleet_job_t *job)
+{
+    ssize_t got = read(job->fd, &job->result, sizeof(job->result));
+    if (got != (ssize_t)sizeof(job->result)) {
+        memset(&job->result, 0, sizeof(job->result));
+    }
+    close(job->fd);
+    job->pid = 0;
+}
+
+static void run_jobs(fleet_job_t *jobs, int count, int parallel, const char *base, uint32_t days)
+{
+    int next = 0, running = 0;
+    while (next < count || running > 0) {
+        while (next < count && running < parallel) {
+            if (start_job(&jobs[next], base, days) != 0) {
+                perror("fork");
+                memset(&jobs[next].result, 0, sizeof(jobs[next].result));
+            } else {
+                running++;
+            }
+            next++;
+        }
+        if (running == 0) {
+            continue;
+        }
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < next; i++) {
+            if (jobs[i].pid == pid) {
+                finish_job(&jobs[i]);
+                running--;
+                break;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 📋 BILAN
+// ---------------------------------------------------------------------------
+
+static bool at_risk(const fleet_result_t *r)
+{
+    return r->errors > 0 || r->buffer_peak_pct >= 100.0f || r->pending > BUFFER_FLUSH_DEFER_MAX ||
+           (r->buffer_full_days >= 0 && r->buffer_full_days < margin_days);
+}
+
+static void print_job(const fleet_job_t *job, uint32_t days)
+{
+    const fleet_result_t *r = &job->result;
+    const bench_summary_t *s = &r->summary;
+#if ADAPTIVE_SAMPLING
+    int interval_max = SAMPLE_INTERVAL_MAX_SEC;
+#else
+    int interval_max = DEEP_SLEEP_DURATION_SEC;
+#endif
+    printf("%s,%s,%d,%d,%d,%s,%lu,%lu,", BUFFER_BACKEND_DEFAULT->name,
+           SAMPLING_ENGINE == SAMPLING_ENGINE_ULP ? "ulp" : "cpu", BUFFER_FLUSH_THRESHOLD, DEEP_SLEEP_DURATION_SEC,
+           interval_max, job->site->name, (unsigned long)(job->partition_size / 1024), (unsigned long)days);
+    if (!r->ok) {
+        puts("échec,,,,,,,,,,,,,,,");
+        return;
+    }
+    printf("%lu,%lu,%lu,%llu,%.3f,%.0f,%.1f,%.2f,%ld,%lu,%lu,%lu,%lu,%lu,%lu,%d\n", (unsigned long)s->cycles,
+           (unsigned long)s->stub_cycles, (unsigned long)s->flushes, (unsigned long long)s->flushed_records,
+           r->mah_day, r->mah_day > 0.0f ? model.battery_mah / r->mah_day : 0.0f, s->sd_on_us / 1e6,
+           r->buffer_peak_pct, (long)r->buffer_full_days, (unsigned long)r->pending, (unsigned long)r->cuts,
+           (unsigned long)r->lost, (unsigned long)r->errors, (unsigned long)r->warnings,
+           (unsigned long)r->clock_regressions, at_risk(r));
+}
+
+// Pire site de chaque taille de partition
+static void print_size_summary(const fleet_job_t *jobs, int count, uint32_t partition_size)
+{
+    const fleet_job_t *worst = NULL;
+    int sites_run = 0, failed = 0, risky = 0;
+    float peak = 0.0f;
+    unsigned long lost = 0, regressions = 0;
+    for (int i = 0; i < count; i++) {
+        const fleet_job_t *job = &jobs[i];
+        if (job->partition_size != partition_size) {
+            continue;
+        }
+        sites_run++;
+        if (!job->result.ok) {
+            failed++;
+            continue;
+        }
+        if (worst == NULL || job->result.mah_day > worst->result.mah_day) {
+            worst = job;
+        }
+        if (job->result.buffer_peak_pct > peak) {
+            peak = job->result.buffer_peak_pct;
+        }
+        lost += job->result.lost;
+        regressions += job->result.clock_regressions;
+        risky += at_risk(&job->result);
+    }
+
+    fprintf(stderr, "data_buffer %lu Ko : %d site(s)", (unsigned long)(partition_size / 1024), sites_run);
+    if (worst != NULL) {
+        fprintf(stderr, ", pire %.3f mAh/jour (%s, %.0f jours sur %.0f mAh)", worst->result.mah_day,
+                worst->site->name, worst->result.mah_day > 0.0f ? model.battery_mah / worst->result.mah_day : 0.0f,
+                model.battery_mah);
+    }
+    fprintf(stderr, ", tampon rempli à %.1f %% au plus, %lu mesures perdues aux coupures, %d site(s) à risque",
+            peak, lost, risky);
+    if (failed > 0) {
+        fprintf(stderr, ", %d échec(s)", failed);
+    }
+    if (regressions > 0) {
+        fprintf(stderr, ", %lu mesures datées en arrière (horloge simulée faussée)", regressions);
+    }
+    fputc('\n', stderr);
+}
+
+int main(int argc, char **argv)
+{
+    const char *sites_path = NULL;
+    const char *base = "fleet_data";
+    char *size_list = NULL;
+    uint32_t days = 180;
+    long parallel = sysconf(_SC_NPROCESSORS_ONLN);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:P:D:j:d:B:m:h")) != -1) {
+        switch (opt) {
+            case 'f': sites_path = optarg; break;
+            case 'P': size_list = optarg; break;
+            case 'D': days = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'j': parallel = atol(optarg); break;
+            case 'd': base = optarg; break;
+            case 'B': model.battery_mah = strtof(optarg, NULL); break;
+            case 'm': margin_days = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (parallel < 1) {
+        parallel = 1;
+    }
+
+    if (sites_path != NULL) {
+        if (load_sites(sites_path) != 0) {
+            perror(sites_path);
+            return 1;
+        }
+        if (site_count == 0) {
+            fprintf(stderr, "%s : aucun site\n", sites_path);
+            return 1;
+        }
+    } else {
+        site_t *site = &sites[site_count++];
+        snprintf(site->name, sizeof(site->name), "synthetique");
+        site->sd_factor = 1.0f;
+        site->flash_factor = 1.0f;
+    }
+
+    uint32_t sizes[FLEET_MAX_SIZES] = { HOST_PARTITION_SIZE };
+    int size_count = size_list != NULL ? parse_sizes(size_list, sizes) : 1;
+    if (size_count <= 0) {
+        return 2;
+    }
+
+    if (mkdir(base, 0755) != 0 && errno != EEXIST) {
+        perror(base);
+        return 1;
+    }
+
+    // Les fils écrivent dans /dev/null : seuls les bilans passent par les pipes
+    FILE *null_log = fopen("/dev/null", "w");
+    host_log_output = null_log;
+    host_log_level = ESP_LOG_NONE;
+
+    int count = site_count * size_count;
+    fleet_job_t *jobs = calloc((size_t)count, sizeof(*jobs));
+    if (jobs == NULL) {
+        return 1;
+    }
+    for (int s = 0; s < size_count; s++) {
+        for (int i = 0; i < site_count; i++) {
+            jobs[s * site_count + i].site = &sites[i];
+            jobs[s * site_count + i].partition_size = sizes[s];
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    run_jobs(jobs, count, (int)parallel, base, days);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    puts("backend,engine,threshold,sleep_s,interval_max_s,site,partition_kb,days,wakes,stub_wakes,flushes,"
+         "flushed,mah_day,battery_days,sd_on_s,buffer_peak_pct,buffer_full_days,pending,cuts,lost,errors,warnings,"
+         "clock_regressions,at_risk");
+    for (int i = 0; i < count; i++) {
+        print_job(&jobs[i], days);
+    }
+    fflush(stdout);
+
+    fprintf(stderr, "=== Flotte : %d logger(s) x %lu jours (%s, seuil flush %d, sommeil %d s), %.1f s sur %ld cœur(s) ===\n",
+            count, (unsigned long)days, BUFFER_BACKEND_DEFAULT->name, BUFFER_FLUSH_THRESHOLD,
+            DEEP_SLEEP_DURATION_SEC,
+            (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9, parallel);
+    for (int s = 0; s < size_count; s++) {
+        print_size_summary(jobs, count, sizes[s]);
+    }
+
+    bool clock_ok = true;
+    for (int i = 0; i < count; i++) {
+        clock_ok = clock_ok && jobs[i].result.clock_regressions == 0;
+    }
+    free(jobs);
+    if (null_log != NULL) {
+        fclose(null_log);
+    }
+    return clock_ok ? 0 : 1;
+}
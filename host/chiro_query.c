@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "record.h"
+#include "sd_log.h"
+
+/*
+ * 🔎 LECTURE D'UNE PLAGE DE DATES DANS LE JOURNAL DE LA CARTE SD
+ *
+ * Cherche dans index.bin le dernier bloc qui commence avant le début de la
+ * plage, puis lit les fichiers par jour à partir de sa position : seules les
+ * lignes de la plage (et au plus un bloc avant) sont parcourues. Les
+ * horodatages sont supposés croissants, comme ils le sont à l'écriture.
+ */
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-d dir] -f début -t fin\n"
+            "  -d dir  répertoire CHIRO de la carte SD (défaut: .)\n"
+            "  -f, -t  bornes de la plage (secondes epoch, incluses)\n",
+            name);
+}
+
+// Entrées valides de l'index, dans l'ordre d'écriture
+static sd_index_entry_t *load_index(const char *dir, size_t *count)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/index.bin", dir);
+    *count = 0;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    sd_index_entry_t *entries = malloc(size > 0 ? (size_t)size : 1);
+    size_t n = entries != NULL ? fread(entries, sizeof(*entries), (size_t)size / sizeof(*entries), file) : 0;
+    fclose(file);
+
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].crc == record_crc16(&entries[i], offsetof(sd_index_entry_t, crc))) {
+            entries[(*count)++] = entries[i];
+        }
+    }
+    return entries;
+}
+
+static void day_file(const char *dir, uint32_t day, char *path, size_t size)
+{
+    time_t t = (time_t)day * SD_LOG_SECONDS_PER_DAY;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+
+    int n = snprintf(path, size, "%s", dir);
+    snprintf(path + n, size - (size_t)n, SD_DAY_PATH_FORMAT, tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = ".";
+    long long from = -1, to = -1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:f:t:h")) != -1) {
+        switch (opt) {
+            case 'd': dir = optarg; break;
+            case 'f': from = atoll(optarg); break;
+            case 't': to = atoll(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (from < 0 || to < from || to > UINT32_MAX) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Point de départ : dernier bloc indexé qui commence au plus tard au début de la plage
+    size_t count = 0;
+    sd_index_entry_t *index = load_index(dir, &count);
+    uint32_t day = (uint32_t)(from / SD_LOG_SECONDS_PER_DAY);
+    long offset = 0;
+
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index[mid].epoch <= from) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo > 0 && index[lo - 1].day == day) {
+        offset = (long)index[lo - 1].offset;
+    }
+    free(index);
+
+    fputs(RECORD_CSV_HEADER, stdout);
+    long lines = 0, scanned = 0;
+    bool done = false;
+
+    for (uint32_t last = (uint32_t)(to / SD_LOG_SECONDS_PER_DAY); day <= last && !done; day++, offset = 0) {
+        char path[512];
+        day_file(dir, day, path, sizeof(path));
+        FILE *file = fopen(path, "r");
+        if (file == NULL) {
+            continue;
+        }
+        fseek(file, offset, SEEK_SET);
+
+        char line[256];
+        while (fgets(line, sizeof(line), file) != NULL) {
+            char *field = strchr(line, ',');
+            if (field == NULL || line[0] < '0' || line[0] > '9') {
+                continue; // En-tête
+            }
+            scanned++;
+            long long epoch = atoll(field + 1);
+            if (epoch > to) {
+                done = true;
+                break;
+            }
+            if (epoch >= from) {
+                fputs(line, stdout);
+                lines++;
+            }
+        }
+        fclose(file);
+    }
+
+    fprintf(stderr, "%ld mesures dans la plage (%ld lignes lues)\n", lines, scanned);
+    return 0;
+}
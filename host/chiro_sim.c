@@ -0,0 +1,198 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/stat.h>
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include "host_sim.h"
+#include "config.h"
+#include "logger.h"
+#include "flash_buffer.h"
+#include "phase_stats.h"
+#include "wake_stub.h"
+#include "sensor.h"
+#include "sensor_trace.h"
+#include "storage_health.h"
+
+/*
+ * 🖥️ SIMULATEUR DE RÉVEILS
+ *
+ * Enchaîne les réveils comme le ferait l'ESP32 entre deux deep sleeps (wake
+ * stub, sinon démarrage complet et chiro_wake_cycle()), sur une horloge simulée : des mois de mesures en quelques secondes.
+ * Avec -t, les mesures rejouent une trace enregistrée (sensor_trace.h) au lieu
+ * du capteur synthétique.
+ */
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-d dir] [-n réveils] [-p N] [-t trace.csv] [-T µs] [-k] [-v]\n"
+            "  -d dir  répertoire de simulation (défaut: sim_data)\n"
+            "  -n N    nombre de réveils (défaut: 17280, un jour à %d s)\n"
+            "  -p N    coupure d'alimentation tous les N réveils (0 = jamais)\n"
+            "  -t f    rejouer les mesures de la trace f (CSV de la SD ou température,humidité)\n"
+            "  -T µs   durée de conversion du capteur de la trace (défaut: 0)\n"
+            "  -k      reprendre les supports d'une simulation précédente\n"
+            "  -v      logs détaillés (niveau INFO)\n",
+            name, DEEP_SLEEP_DURATION_SEC);
+}
+
+static long sd_lines = 0;
+static long sd_size = 0;
+static long sd_files = 0;
+
+// Lignes de données d'un fichier par jour (AAAA/MM/JJ.csv, en-tête exclu)
+static int count_day_file(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    (void)st;
+    if (type != FTW_F || ftw->level != 3) {
+        return 0;
+    }
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    char chunk[65536];
+    long lines = 0;
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        sd_size += (long)n;
+        for (size_t i = 0; i < n; i++) {
+            lines += chunk[i] == '\n';
+        }
+    }
+    fclose(file);
+    sd_lines += lines > 0 ? lines - 1 : 0;
+    sd_files++;
+    return 0;
+}
+
+// Cavité simulée pour le programme ULP : cycle journalier de température et
+// d'humidité, converti en lectures ADC par l'étalonnage inverse de config.h
+static uint16_t cavity_adc(int adc_unit, int channel, int64_t now_us)
+{
+    (void)adc_unit;
+    double phase = 2.0 * M_PI * (double)(now_us % 86400000000LL) / 86400e6;
+    double raw;
+    if (channel == ULP_ADC_TEMPERATURE_CHANNEL) {
+        raw = (12.0 + 1.5 * sin(phase) - ULP_TEMPERATURE_OFFSET) / ULP_TEMPERATURE_PER_LSB;
+    } else {
+        raw = (90.0 + 4.0 * cos(phase) - ULP_HUMIDITY_OFFSET) / ULP_HUMIDITY_PER_LSB;
+    }
+    return raw < 0.0 ? 0 : (raw > 4095.0 ? 4095 : (uint16_t)lround(raw));
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = "sim_data";
+    long cycles = 86400 / DEEP_SLEEP_DURATION_SEC;
+    long power_loss_every = 0;
+    bool keep = false;
+    const char *trace_path = NULL;
+    uint32_t conversion_us = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:n:p:t:T:kvh")) != -1) {
+        switch (opt) {
+            case 'd': dir = optarg; break;
+            case 'n': cycles = atol(optarg); break;
+            case 'p': power_loss_every = atol(optarg); break;
+            case 't': trace_path = optarg; break;
+            case 'T': conversion_us = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'k': keep = true; break;
+            case 'v': host_log_level = ESP_LOG_INFO; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    // Trace lue avant de passer dans le répertoire de simulation
+    if (trace_path != NULL) {
+        if (sensor_trace_load(trace_path, conversion_us) != 0) {
+            fprintf(stderr, "%s : aucune mesure lue\n", trace_path);
+            return 1;
+        }
+        static const sensor_driver_t *const trace_drivers[] = { &sensor_driver_trace };
+        sensors_use(trace_drivers, 1);
+    }
+
+    host_ulp_adc = cavity_adc;
+    if (host_sim_open(dir, !keep) != 0) {
+        perror(dir);
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long stub_wakes = 0;
+    uint32_t sensor_reads[SENSOR_MAX_DRIVERS] = { 0 };
+    int64_t sensor_bus_us[SENSOR_MAX_DRIVERS] = { 0 };
+    int64_t sensor_wait_us[SENSOR_MAX_DRIVERS] = { 0 };
+
+    for (long cycle = 0; cycle < cycles; cycle++) {
+        bool power_loss = cycle == 0 || (power_loss_every > 0 && cycle % power_loss_every == 0);
+        host_sim_boot(power_loss);
+        if (!power_loss && wake_stub_cycle()) {
+            // Réveil traité avant le bootloader : l'application ne démarre pas
+            stub_wakes++;
+            host_sim_deep_sleep((uint64_t)wake_stub_sleep_sec() * 1000000ULL);
+            continue;
+        }
+        print_wakeup_info();
+        uint32_t sleep_sec = chiro_wake_cycle();
+        flush_buffer_wait();
+        phase_stats_record(PHASE_WAKE, esp_timer_get_time());
+        for (uint32_t i = 0; i < sensors_count(); i++) {
+            const sensor_timing_t *timing = sensors_timing(i);
+            if (timing->reads != sensor_reads[i]) {
+                sensor_reads[i] = timing->reads;
+                sensor_bus_us[i] += timing->trigger_us + timing->collect_us;
+                sensor_wait_us[i] += timing->wait_us;
+            }
+        }
+        host_sim_deep_sleep((uint64_t)chiro_prepare_sleep(sleep_sec) * 1000000ULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double host_sec = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    // Bilan : un dernier démarrage pour interroger le tampon
+    host_sim_boot(false);
+    reset_flash_buffer_session();
+    int pending = count_buffer_records();
+    nftw(SD_WORK_DIR, count_day_file, 8, FTW_PHYS);
+
+    printf("Réveils simulés : %ld (%.2f jours, éveillé %.1f s)\n", cycles,
+           (double)host_sim_now_us() / 86400e6, (double)host_sim_awake_us() / 1e6);
+    printf("Wake stub       : %ld réveils sans démarrage complet (%.1f %%)\n", stub_wakes,
+           cycles > 0 ? 100.0 * stub_wakes / cycles : 0.0);
+    printf("Durée réelle    : %.2f s (%.0f réveils/s)\n", host_sec, host_sec > 0 ? cycles / host_sec : 0.0);
+    printf("Tampon          : %d mesures en attente\n", pending);
+    printf("Carte SD        : %ld lignes, %ld octets dans %ld fichier(s) par jour de %s/%s\n", sd_lines, sd_size,
+           sd_files, dir, SD_WORK_DIR);
+    printf("NVS             : %lu écritures (ID et heure)\n", (unsigned long)host_media_stats.nvs_writes);
+    const storage_health_t *health = storage_health_last();
+    if (health != NULL) {
+        printf("Stockage        : tampon WA %.2f, %lu effacements, plein en %ld j sans SD, vie flash %ld j, SD WA %.2f\n",
+               health->flash_wa_centi / 100.0, (unsigned long)health->flash_erases, (long)health->buffer_full_days,
+               (long)health->flash_life_days, health->sd_wa_centi / 100.0);
+    }
+    for (uint32_t i = 0; i < sensors_count(); i++) {
+        printf("Capteur %-8s: %lu relevés, bus %.0f µs, conversion attendue %.0f µs en moyenne\n", sensors_name(i),
+               (unsigned long)sensor_reads[i], sensor_reads[i] > 0 ? (double)sensor_bus_us[i] / sensor_reads[i] : 0.0,
+               sensor_reads[i] > 0 ? (double)sensor_wait_us[i] / sensor_reads[i] : 0.0);
+    }
+
+    host_sim_close();
+    return 0;
+}
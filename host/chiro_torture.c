@@ -0,0 +1,702 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <esp_log.h>
+
+#include "host_sim.h"
+#include "config.h"
+#include "logger.h"
+#include "flash_buffer.h"
+#include "record.h"
+#include "record_codec.h"
+#include "staging.h"
+#include "synthetic_sensor.h"
+#include "timekeeper.h"
+#include "wake_stub.h"
+
+/*
+ * 💥 BANC DE TORTURE DU STOCKAGE
+ *
+ * Rejoue le même scénario de réveils (mesure, lot RTC, tampon flash, flush
+ * vers la SD) en injectant une faute par essai :
+ * - coupure d'alimentation avant chaque opération qui modifie la flash, la
+ *   SD ou la NVS, ou pendant un deep sleep ;
+ * - écriture ou effacement interrompu à mi-course, puis coupure ;
+ * - bit inversé dans une écriture du tampon flash ;
+ * - flash ou SD pleine, montage du tampon ou de la carte refusé, le temps
+ *   d'un cycle de flush ;
+ * - en-tête d'un bloc illisible au milieu du journal SPIFFS, pendant un deep
+ *   sleep, suivi d'une coupure un essai sur deux : seul ce bloc est perdu ;
+ * - écritures NVS refusées à partir d'une opération, ou pendant tout l'essai
+ *   avec une coupure en sommeil : les mesures continuent, sans doublon.
+ *
+ * Chaque vie de l'ESP32 (de la mise sous tension à la coupure) est un
+ * processus fils : une coupure termine le processus au milieu de
+ * l'opération, quelle que soit la tâche, et la vie suivante repart des seuls
+ * supports (fichiers, image de la partition, NVS), avec la RTC memory et les
+ * variables de src/ de la mise sous tension.
+ *
+ * En fin d'essai, le tampon est vidé sur la SD et les ID des fichiers par jour
+ * sont comparés aux ID attribués : aucune mesure perdue hors du lot RTC à la
+ * coupure (et de la mesure en cours), aucun doublon, aucun ID inconnu, et
+ * avec le capteur synthétique aucune valeur altérée. La reprise est le temps
+ * éveillé du premier réveil après la coupure.
+ */
+
+// Réveils par cycle de flush, durée d'un support plein ou refusé
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_ULP
+#define FLUSH_CYCLE_WAKES (BUFFER_FLUSH_THRESHOLD / ULP_SAMPLE_CAPACITY + 1)
+#else
+#define FLUSH_CYCLE_WAKES BUFFER_FLUSH_THRESHOLD
+#endif
+
+// Plus grande écriture de mesures en une opération flash : un bloc compressé
+// (SPIFFS) ou un lot RTC (partition brute). Un bit inversé détecté ne doit
+// pas coûter davantage.
+#define CORRUPTED_WRITE_RECORDS \
+    (STAGING_BATCH_SIZE > RECORD_BLOCK_MAX_RECORDS ? STAGING_BATCH_SIZE : RECORD_BLOCK_MAX_RECORDS)
+
+// Un essai bloqué au-delà est compté en échec (secondes réelles par vie)
+#define LIFE_TIMEOUT_SEC 60
+
+typedef enum {
+    FAULT_AT_OP,          // Faute de host_sim.h armée à une opération du support
+    FAULT_SLEEP_CUT,      // Coupure pendant le deep sleep précédant un réveil
+    FAULT_MOUNT_REFUSED,  // Support inaccessible à partir d'un réveil
+    FAULT_BLOCK_HEADER,   // En-tête d'un bloc du milieu du journal abîmé pendant le deep sleep
+    FAULT_NVS_DOWN,       // Faute armée dès la mise sous tension de chaque vie, coupure en sommeil
+} fault_mode_t;
+
+typedef struct {
+    const char *name;
+    fault_mode_t mode;
+    host_fault_kind_t kind;
+    host_media_t media;
+    uint32_t loss_tolerated;  // Mesures perdues tolérées par essai (écriture corrompue, détectée)
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    { "coupure flash", FAULT_AT_OP, HOST_FAULT_POWER_CUT, HOST_MEDIA_FLASH, 0 },
+    { "coupure SD", FAULT_AT_OP, HOST_FAULT_POWER_CUT, HOST_MEDIA_SD, 0 },
+    { "coupure NVS", FAULT_AT_OP, HOST_FAULT_POWER_CUT, HOST_MEDIA_NVS, 0 },
+    { "flash interrompue", FAULT_AT_OP, HOST_FAULT_TORN_WRITE, HOST_MEDIA_FLASH, 0 },
+    { "SD interrompue", FAULT_AT_OP, HOST_FAULT_TORN_WRITE, HOST_MEDIA_SD, 0 },
+    { "bit inversé flash", FAULT_AT_OP, HOST_FAULT_BIT_FLIP, HOST_MEDIA_FLASH, CORRUPTED_WRITE_RECORDS },
+    { "flash pleine", FAULT_AT_OP, HOST_FAULT_MEDIA_FULL, HOST_MEDIA_FLASH, 0 },
+    { "SD pleine", FAULT_AT_OP, HOST_FAULT_MEDIA_FULL, HOST_MEDIA_SD, 0 },
+    { "NVS refusée", FAULT_AT_OP, HOST_FAULT_REJECTED, HOST_MEDIA_NVS, 0 },
+    { "NVS refusée et coupure", FAULT_NVS_DOWN, HOST_FAULT_REJECTED, HOST_MEDIA_NVS, 0 },
+    { "coupure en sommeil", FAULT_SLEEP_CUT, HOST_FAULT_NONE, HOST_MEDIA_FLASH, 0 },
+    { "montage flash refusé", FAULT_MOUNT_REFUSED, HOST_FAULT_NONE, HOST_MEDIA_FLASH, 0 },
+    { "montage SD refusé", FAULT_MOUNT_REFUSED, HOST_FAULT_NONE, HOST_MEDIA_SD, 0 },
+#if BUFFER_BACKEND == BUFFER_BACKEND_SPIFFS
+    { "en-tête de bloc abîmé", FAULT_BLOCK_HEADER, HOST_FAULT_NONE, HOST_MEDIA_FLASH, RECORD_BLOCK_MAX_RECORDS },
+#endif
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct {
+    const scenario_t *scenario;  // NULL : essai de référence, sans faute
+    uint32_t index;              // Opération ou réveil de la faute
+} trial_t;
+
+// ID attribués pendant une vie : [first, end), dont [volatile_from, end)
+// pouvaient n'être qu'en RTC memory à la coupure
+typedef struct {
+    uint32_t first;
+    uint32_t volatile_from;
+    uint32_t end;
+} life_ids_t;
+
+typedef struct {
+    uint32_t lost;           // ID attribués et durables absents de la SD
+    uint32_t duplicated;     // ID présents plusieurs fois
+    uint32_t unexpected;     // ID jamais attribués
+    uint32_t altered;        // Valeurs différentes de la mesure synthétique
+    uint32_t pending;        // Mesures restées dans le tampon après le vidage
+    uint32_t lives;
+    int64_t recovery_us;     // Premier réveil après la coupure (-1 : pas de coupure)
+    uint32_t media_ops[HOST_MEDIA_COUNT];
+    long full_wakes;         // Démarrages complets
+    int64_t full_awake_us;   // Temps éveillé des démarrages complets
+} trial_result_t;
+
+// Message d'une vie à l'essai : coupure, ou bilan de l'essai
+typedef struct {
+    bool finished;
+    long wake;               // Réveil interrompu par la coupure
+    life_ids_t ids;
+    int64_t first_wake_us;
+    trial_result_t result;
+} life_report_t;
+
+#define MAX_LIVES 4
+
+static long wakes = 3 * FLUSH_CYCLE_WAKES;
+static bool verbose = false;
+
+// Vie en cours (processus fils)
+static int report_fd = -1;
+static life_report_t report;
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-d dir] [-n réveils] [-m essais] [-f scénario] [-v]\n"
+            "  -d dir  répertoire de simulation (défaut: torture_data, effacé à chaque essai)\n"
+            "  -n N    réveils par essai (défaut: %ld, trois cycles de flush)\n"
+            "  -m N    essais au plus par scénario, répartis sur les opérations (défaut: 200, 0 = toutes)\n"
+            "  -f s    seulement les scénarios dont le nom contient s\n"
+            "  -v      détail de chaque échec\n",
+            name, wakes);
+}
+
+static void send_report(void)
+{
+    const char *bytes = (const char *)&report;
+    size_t left = sizeof(report);
+    while (left > 0) {
+        ssize_t n = write(report_fd, bytes, left);
+        if (n <= 0) {
+            _exit(3);
+        }
+        bytes += n;
+        left -= (size_t)n;
+    }
+}
+
+// Coupure : lot RTC (et mesure en cours) perdus, rien d'autre
+static void cut_now(bool in_wake)
+{
+    uint32_t next = timekeeper_peek_id();
+    uint32_t volatile_count = staging_count() + (in_wake ? 1 : 0);
+    report.ids.end = next;
+    report.ids.volatile_from = next > volatile_count ? next - volatile_count : 0;
+    if (report.ids.first == 0 || report.ids.first > report.ids.volatile_from) {
+        report.ids.first = report.ids.volatile_from;
+    }
+    report.finished = false;
+    send_report();
+    _exit(0);
+}
+
+static void on_power_cut(void)
+{
+    cut_now(true);
+}
+
+// ---------------------------------------------------------------------------
+// 🔍 VÉRIFICATION DE LA SD
+// ---------------------------------------------------------------------------
+
+static uint8_t *id_seen = NULL;
+static uint32_t id_limit = 0;
+static uint32_t foreign_ids = 0;
+static uint32_t altered_values = 0;
+
+// Valeur CSV en centièmes (false si absente)
+static bool parse_centi(const char *field, int32_t *centi)
+{
+    char *end;
+    double value = strtod(field, &end);
+    if (end == field) {
+        return false;
+    }
+    *centi = (int32_t)(value * 100.0 + (value < 0 ? -0.5 : 0.5));
+    return true;
+}
+
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_CPU
+// Mesure synthétique attendue pour un ID, avec les saturations de record_make()
+static bool values_match(uint32_t id, int32_t temperature_centi, int32_t humidity_centi)
+{
+    int32_t t, h;
+    synthetic_sensor_read(id, &t, &h);
+    record_values_t values = { 0 };
+    RECORD_VALUE_SET(&values, temperature, t / 100.0f);
+    RECORD_VALUE_SET(&values, humidity, h / 100.0f);
+    chiro_record_t expected;
+    record_make(&expected, id, 0, &values, DEEP_SLEEP_DURATION_SEC);
+    return abs(expected.temperature_centi - temperature_centi) <= 1 &&
+           abs(expected.humidity_centi - humidity_centi) <= 1;
+}
+#endif
+
+// Lignes d'un fichier par jour (AAAA/MM/JJ.csv) : ID,DateTime,Temperature_C,Humidity_%,...
+static int scan_day_file(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    (void)st;
+    if (type != FTW_F || ftw->level != 3) {
+        return 0;
+    }
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] < '0' || line[0] > '9') {
+            continue;
+        }
+        char *fields[4] = { line };
+        int count = 1;
+        for (char *c = line; *c != '\0' && count < 4; c++) {
+            if (*c == ',') {
+                *c = '\0';
+                fields[count++] = c + 1;
+            }
+        }
+        unsigned long id = strtoul(fields[0], NULL, 10);
+        if (id >= id_limit) {
+            foreign_ids++;
+            continue;
+        }
+        if (id_seen[id] < UINT8_MAX) {
+            id_seen[id]++;
+        }
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_CPU
+        int32_t temperature_centi, humidity_centi;
+        if (count == 4 && parse_centi(fields[2], &temperature_centi) && parse_centi(fields[3], &humidity_centi) &&
+            !values_match((uint32_t)id, temperature_centi, humidity_centi)) {
+            altered_values++;
+        }
+#else
+        (void)parse_centi;
+#endif
+    }
+    fclose(file);
+    return 0;
+}
+
+// Comparer les ID de la SD aux ID attribués par les vies successives
+static void check_sd(const life_ids_t *lives, int life_count, trial_result_t *result)
+{
+    id_limit = 1;
+    for (int i = 0; i < life_count; i++) {
+        if (lives[i].end > id_limit) {
+            id_limit = lives[i].end;
+        }
+    }
+    id_seen = calloc(id_limit, 1);
+    if (id_seen == NULL) {
+        _exit(3);
+    }
+    foreign_ids = 0;
+    altered_values = 0;
+    nftw(SD_WORK_DIR, scan_day_file, 8, FTW_PHYS);
+
+    // ID attendus ; ceux d'une vie coupée au-delà de volatile_from sont facultatifs
+    uint8_t *expected = calloc(id_limit, 1);
+    if (expected == NULL) {
+        _exit(3);
+    }
+    for (int i = 0; i < life_count; i++) {
+        for (uint32_t id = lives[i].first; id < lives[i].end; id++) {
+            expected[id] = id < lives[i].volatile_from ? 2 : 1;
+        }
+    }
+    for (uint32_t id = 0; id < id_limit; id++) {
+        if (id_seen[id] > 1) {
+            result->duplicated++;
+        }
+        if (expected[id] == 2 && id_seen[id] == 0) {
+            result->lost++;
+        } else if (expected[id] == 0 && id_seen[id] > 0) {
+            result->unexpected++;
+        }
+    }
+    result->unexpected += foreign_ids;
+    result->altered = altered_values;
+    free(expected);
+    free(id_seen);
+    id_seen = NULL;
+}
+
+// ---------------------------------------------------------------------------
+// 🔁 VIES DE L'ESP32
+// ---------------------------------------------------------------------------
+
+#if BUFFER_BACKEND == BUFFER_BACKEND_SPIFFS
+// Inverser un bit du magic d'un bloc au milieu du journal, s'il en a au moins trois
+static void corrupt_block_header(void)
+{
+    FILE *file = fopen(BUFFER_LOG_FILE, "r+b");
+    if (file == NULL) {
+        return;
+    }
+    long offsets[STAGING_BATCH_SIZE * 4];
+    int count = 0;
+    record_block_header_t header;
+    long offset = sizeof(record_log_header_t);
+    while (count < (int)(sizeof(offsets) / sizeof(offsets[0])) && fseek(file, offset, SEEK_SET) == 0 &&
+           fread(&header, sizeof(header), 1, file) == 1 && record_block_header_check(&header)) {
+        offsets[count++] = offset;
+        offset += sizeof(header) + header.payload_size;
+    }
+    if (count >= 3 && fseek(file, offsets[count / 2], SEEK_SET) == 0 && fread(&header, sizeof(header), 1, file) == 1) {
+        header.magic ^= 0x0100;
+        fseek(file, offsets[count / 2], SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file);
+    }
+    fclose(file);
+}
+#endif
+
+static void set_present(host_media_t media, bool present)
+{
+    if (media == HOST_MEDIA_FLASH) {
+        host_sim_set_flash_present(present);
+    } else {
+        host_sim_set_sd_present(present);
+    }
+}
+
+// Processus fils : réveils de start à la fin de l'essai, ou jusqu'à la coupure
+static void run_life(const trial_t *trial, int life, long start, const life_ids_t *previous)
+{
+    const scenario_t *scenario = trial->scenario;
+    bool faulty = scenario != NULL && life == 0;
+    memset(&report, 0, sizeof(report));
+    report.first_wake_us = -1;
+    host_power_cut = on_power_cut;
+    alarm(LIFE_TIMEOUT_SEC);
+
+    if (faulty && scenario->mode == FAULT_AT_OP) {
+        host_sim_arm_fault(scenario->kind, scenario->media, trial->index);
+    }
+    // Support hors service pendant tout l'essai, vies suivantes comprises
+    if (scenario != NULL && scenario->mode == FAULT_NVS_DOWN) {
+        host_sim_arm_fault(scenario->kind, scenario->media, 0);
+    }
+    long full_since = -1;
+    long full_wakes = 0;
+    int64_t full_awake_us = 0;
+
+    for (long wake = start; wake < wakes; wake++) {
+        bool power_on = wake == start;
+        if (faulty && (scenario->mode == FAULT_SLEEP_CUT || scenario->mode == FAULT_NVS_DOWN) &&
+            wake == (long)trial->index && !power_on) {
+            report.wake = wake;
+            cut_now(false);
+        }
+#if BUFFER_BACKEND == BUFFER_BACKEND_SPIFFS
+        if (faulty && scenario->mode == FAULT_BLOCK_HEADER && wake == (long)trial->index && !power_on) {
+            corrupt_block_header();
+            if (trial->index % 2 == 1) {
+                // Reconstruction du journal au démarrage plutôt que lecture au flush
+                report.wake = wake;
+                cut_now(false);
+            }
+        }
+#endif
+        if (faulty && scenario->mode == FAULT_MOUNT_REFUSED) {
+            set_present(scenario->media, wake < (long)trial->index || wake >= (long)trial->index + FLUSH_CYCLE_WAKES);
+        }
+        report.wake = wake;
+
+        host_sim_boot(power_on);
+        if (!power_on && wake_stub_cycle()) {
+            host_sim_deep_sleep((uint64_t)wake_stub_sleep_sec() * 1000000ULL);
+            continue;
+        }
+        int64_t awake_before = host_sim_awake_us();
+        uint32_t sleep_sec = chiro_prepare_sleep(chiro_wake_cycle());
+        host_sim_deep_sleep((uint64_t)sleep_sec * 1000000ULL);
+        int64_t awake_us = host_sim_awake_us() - awake_before;
+        full_wakes++;
+        full_awake_us += awake_us;
+        if (power_on) {
+            // Première mesure de la vie : un seul ID attribué par ce réveil
+            report.first_wake_us = awake_us;
+            report.ids.first = timekeeper_peek_id() > 0 ? timekeeper_peek_id() - 1 : 0;
+        }
+
+        // Support plein le temps d'un cycle de flush après la première écriture refusée
+        if (faulty && scenario->kind == HOST_FAULT_MEDIA_FULL && host_sim_fault_triggered()) {
+            if (full_since < 0) {
+                full_since = wake;
+            } else if (wake - full_since >= FLUSH_CYCLE_WAKES) {
+                host_sim_clear_fault();
+            }
+        }
+    }
+
+    // Fin de l'essai : supports rétablis, réveil complet puis tampon vidé sur la SD
+    host_sim_clear_fault();
+    host_sim_set_flash_present(true);
+    host_sim_set_sd_present(true);
+    host_sim_boot(false);
+    chiro_wake_cycle();
+    flush_buffer_wait();
+    for (int attempt = 0; attempt < 4 && count_buffer_records() > 0; attempt++) {
+        flush_buffer_to_sd();
+        flush_buffer_wait();
+    }
+    if (report.ids.first == 0) {
+        report.ids.first = timekeeper_peek_id() > 0 ? timekeeper_peek_id() - 1 : 0;
+    }
+    report.ids.end = timekeeper_peek_id();
+    report.ids.volatile_from = report.ids.end;
+
+    trial_result_t *result = &report.result;
+    result->pending = (uint32_t)count_buffer_records();
+    memcpy(result->media_ops, host_media_ops, sizeof(result->media_ops));
+    result->full_wakes = full_wakes;
+    result->full_awake_us = full_awake_us;
+
+    life_ids_t lives[MAX_LIVES];
+    memcpy(lives, previous, (size_t)life * sizeof(lives[0]));
+    lives[life] = report.ids;
+    check_sd(lives, life + 1, result);
+
+    report.finished = true;
+    send_report();
+    _exit(0);
+}
+
+// Essai complet : vies successives jusqu'au bilan (false si un fils a échoué)
+static bool run_trial(const char *dir, const trial_t *trial, trial_result_t *result, const char **failure)
+{
+    *failure = NULL;
+    memset(result, 0, sizeof(*result));
+    result->recovery_us = -1;
+    if (host_sim_open(dir, true) != 0) {
+        *failure = "répertoire de simulation";
+        return false;
+    }
+
+    life_ids_t lives[MAX_LIVES];
+    long start = 0;
+    for (int life = 0; life < MAX_LIVES; life++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            *failure = "pipe";
+            return false;
+        }
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid < 0) {
+            *failure = "fork";
+            return false;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            report_fd = fds[1];
+            run_life(trial, life, start, lives);
+        }
+        close(fds[1]);
+
+        life_report_t received;
+        size_t got = 0;
+        ssize_t n;
+        while (got < sizeof(received) && (n = read(fds[0], (char *)&received + got, sizeof(received) - got)) > 0) {
+            got += (size_t)n;
+        }
+        close(fds[0]);
+        int status;
+        waitpid(pid, &status, 0);
+        if (got != sizeof(received)) {
+            *failure = WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM ? "blocage" : "plantage";
+            return false;
+        }
+
+        if (life == 1) {
+            result->recovery_us = received.first_wake_us;
+        }
+        if (received.finished) {
+            int64_t recovery_us = result->recovery_us;
+            *result = received.result;
+            result->recovery_us = recovery_us;
+            result->lives = (uint32_t)life + 1;
+            return true;
+        }
+        lives[life] = received.ids;
+        start = received.wake;
+    }
+    *failure = "coupures en chaîne";
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// 📋 BILAN
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t trials;
+    uint32_t failures;
+    uint32_t lost;
+    uint32_t duplicated;
+    uint32_t recoveries;
+    int64_t recovery_total_us;
+    int64_t recovery_max_us;
+} scenario_stats_t;
+
+// Colonne de largeur fixe en caractères affichés (noms accentués en UTF-8)
+static void print_cell(const char *text, int width, bool left)
+{
+    int chars = 0;
+    for (const char *c = text; *c != '\0'; c++) {
+        chars += ((unsigned char)*c & 0xC0) != 0x80;
+    }
+    int pad = width > chars ? width - chars : 0;
+    printf("%*s%s%*s", left ? 0 : pad, "", text, left ? pad : 0, "");
+}
+
+static bool result_failed(const scenario_t *scenario, const trial_result_t *result)
+{
+    return result->lost > scenario->loss_tolerated || result->duplicated > 0 || result->unexpected > 0 ||
+           result->altered > 0 || result->pending > 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = "torture_data";
+    long max_trials = 200;
+    const char *filter = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:n:m:f:vh")) != -1) {
+        switch (opt) {
+            case 'd': dir = optarg; break;
+            case 'n': wakes = atol(optarg); break;
+            case 'm': max_trials = atol(optarg); break;
+            case 'f': filter = optarg; break;
+            case 'v': verbose = true; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (wakes < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Chemin absolu : chaque essai repart du répertoire de simulation
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        perror(dir);
+        return 1;
+    }
+    char dir_path[PATH_MAX];
+    if (realpath(dir, dir_path) == NULL) {
+        perror(dir);
+        return 1;
+    }
+    host_log_level = ESP_LOG_NONE;
+
+    // Référence sans faute : opérations de chaque support, éveil d'un démarrage complet
+    trial_t reference = { NULL, 0 };
+    trial_result_t base;
+    const char *failure;
+    if (!run_trial(dir_path, &reference, &base, &failure)) {
+        fprintf(stderr, "Essai de référence : %s\n", failure);
+        return 1;
+    }
+    if (base.lost > 0 || base.duplicated > 0 || base.unexpected > 0 || base.altered > 0 || base.pending > 0) {
+        fprintf(stderr, "Essai de référence incohérent : %lu perdues, %lu doublons, %lu inconnues, %lu altérées\n",
+                (unsigned long)base.lost, (unsigned long)base.duplicated, (unsigned long)base.unexpected,
+                (unsigned long)base.altered);
+        return 1;
+    }
+    printf("Référence       : %ld réveils, opérations flash %lu, SD %lu, NVS %lu, démarrage complet %.1f ms en moyenne\n",
+           wakes, (unsigned long)base.media_ops[HOST_MEDIA_FLASH], (unsigned long)base.media_ops[HOST_MEDIA_SD],
+           (unsigned long)base.media_ops[HOST_MEDIA_NVS],
+           base.full_wakes > 0 ? (double)base.full_awake_us / base.full_wakes / 1000.0 : 0.0);
+    putchar('\n');
+    print_cell("Scénario", 22, true);
+    print_cell("Essais", 8, false);
+    print_cell("Échecs", 8, false);
+    print_cell("Perdues", 9, false);
+    print_cell("Doublons", 9, false);
+    print_cell("Reprise moy/max (ms)", 23, false);
+    putchar('\n');
+
+    uint32_t total_failures = 0;
+    unsigned long total_lost = 0;
+    for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+        const scenario_t *scenario = &scenarios[s];
+        if (filter != NULL && strstr(scenario->name, filter) == NULL) {
+            continue;
+        }
+
+        // Opérations du support, ou réveils (la coupure en sommeil précède le réveil)
+        uint32_t span = scenario->mode == FAULT_AT_OP ? base.media_ops[scenario->media] : (uint32_t)wakes;
+        uint32_t step = max_trials > 0 && span > (uint32_t)max_trials ? (span + (uint32_t)max_trials - 1) / (uint32_t)max_trials : 1;
+        scenario_stats_t stats = { 0 };
+        bool after_wake = scenario->mode == FAULT_SLEEP_CUT || scenario->mode == FAULT_BLOCK_HEADER ||
+                          scenario->mode == FAULT_NVS_DOWN;
+        for (uint32_t index = after_wake ? 1 : 0; index < span; index += step) {
+            trial_t trial = { scenario, index };
+            trial_result_t result;
+            bool ran = run_trial(dir_path, &trial, &result, &failure);
+            stats.trials++;
+            if (!ran || result_failed(scenario, &result)) {
+                stats.failures++;
+                if (verbose) {
+                    if (!ran) {
+                        printf("  ÉCHEC %s, %s %lu : %s\n", scenario->name,
+                               scenario->mode == FAULT_AT_OP ? "opération" : "réveil", (unsigned long)index, failure);
+                    } else {
+                        printf("  ÉCHEC %s, %s %lu : %lu perdues, %lu doublons, %lu inconnues, %lu altérées, "
+                               "%lu en attente\n",
+                               scenario->name, scenario->mode == FAULT_AT_OP ? "opération" : "réveil",
+                               (unsigned long)index, (unsigned long)result.lost, (unsigned long)result.duplicated,
+                               (unsigned long)result.unexpected, (unsigned long)result.altered,
+                               (unsigned long)result.pending);
+                    }
+                }
+            }
+            if (!ran) {
+                continue;
+            }
+            stats.lost += result.lost;
+            stats.duplicated += result.duplicated;
+            if (result.recovery_us >= 0) {
+                stats.recoveries++;
+                stats.recovery_total_us += result.recovery_us;
+                if (result.recovery_us > stats.recovery_max_us) {
+                    stats.recovery_max_us = result.recovery_us;
+                }
+            }
+        }
+
+        char recovery[32] = "-";
+        if (stats.recoveries > 0) {
+            snprintf(recovery, sizeof(recovery), "%.1f / %.1f",
+                     (double)stats.recovery_total_us / stats.recoveries / 1000.0,
+                     (double)stats.recovery_max_us / 1000.0);
+        }
+        print_cell(scenario->name, 22, true);
+        printf(" %7lu %7lu %8lu %8lu %22s", (unsigned long)stats.trials, (unsigned long)stats.failures,
+               (unsigned long)stats.lost, (unsigned long)stats.duplicated, recovery);
+        if (scenario->loss_tolerated > 0 && stats.lost > 0) {
+            printf("  (corruption détectée, %lu par essai tolérées)", (unsigned long)scenario->loss_tolerated);
+        }
+        putchar('\n');
+        total_failures += stats.failures;
+        total_lost += stats.lost;
+    }
+
+    host_sim_close();
+    if (total_failures > 0) {
+        printf("\nDes essais ont échoué (-v pour le détail), %lu mesures perdues\n", total_lost);
+    } else if (total_lost > 0) {
+        printf("\nAucun échec ni doublon ; %lu mesures perdues, toutes dans des écritures corrompues détectées\n",
+               total_lost);
+    } else {
+        printf("\nAucune perte ni doublon\n");
+    }
+    return total_failures == 0 ? 0 : 1;
+}
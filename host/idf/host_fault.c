@@ -0,0 +1,92 @@
+#include <stdlib.h>
+
+#include "host_sim.h"
+#include "host_storage.h"
+
+/*
+ * Injection de fautes (host_sim.h) : les stand-ins des supports appellent
+ * host_fault_check() avant chaque opération qui les modifie et appliquent la
+ * faute retournée. Une seule faute armée à la fois.
+ */
+
+uint32_t host_media_ops[HOST_MEDIA_COUNT];
+void (*host_power_cut)(void) = NULL;
+
+static host_fault_kind_t armed_kind = HOST_FAULT_NONE;
+static host_media_t armed_media = HOST_MEDIA_FLASH;
+static uint32_t armed_op = 0;
+static bool triggered = false;
+
+void host_sim_arm_fault(host_fault_kind_t kind, host_media_t media, uint32_t op)
+{
+    armed_kind = kind;
+    armed_media = media;
+    armed_op = op;
+    triggered = false;
+}
+
+bool host_sim_fault_triggered(void)
+{
+    return triggered;
+}
+
+void host_sim_clear_fault(void)
+{
+    armed_kind = HOST_FAULT_NONE;
+    triggered = false;
+}
+
+_Noreturn void host_fault_power_cut(void)
+{
+    if (host_power_cut != NULL) {
+        host_power_cut();
+    }
+    abort();
+}
+
+host_fault_kind_t host_fault_check(host_media_t media, host_op_t op)
+{
+    uint32_t index = host_media_ops[media]++;
+    if (armed_kind == HOST_FAULT_NONE || media != armed_media) {
+        return HOST_FAULT_NONE;
+    }
+    // Support plein ou NVS refusée : toutes les écritures suivantes sont refusées
+    if (triggered) {
+        if (armed_kind == HOST_FAULT_REJECTED) {
+            return HOST_FAULT_REJECTED;
+        }
+        return armed_kind == HOST_FAULT_MEDIA_FULL && op == HOST_OP_WRITE ? HOST_FAULT_MEDIA_FULL : HOST_FAULT_NONE;
+    }
+    if (index < armed_op) {
+        return HOST_FAULT_NONE;
+    }
+
+    switch (armed_kind) {
+        case HOST_FAULT_POWER_CUT:
+            triggered = true;
+            host_fault_power_cut();
+            break;
+        case HOST_FAULT_TORN_WRITE:
+            triggered = true;
+            if (op == HOST_OP_META) {
+                host_fault_power_cut();
+            }
+            return HOST_FAULT_TORN_WRITE;
+        case HOST_FAULT_BIT_FLIP:
+            // Reporté à la prochaine écriture de données
+            if (op != HOST_OP_WRITE) {
+                return HOST_FAULT_NONE;
+            }
+            triggered = true;
+            return HOST_FAULT_BIT_FLIP;
+        case HOST_FAULT_MEDIA_FULL:
+            triggered = true;
+            return op == HOST_OP_WRITE ? HOST_FAULT_MEDIA_FULL : HOST_FAULT_NONE;
+        case HOST_FAULT_REJECTED:
+            triggered = true;
+            return HOST_FAULT_REJECTED;
+        default:
+            break;
+    }
+    return HOST_FAULT_NONE;
+}
@@ -0,0 +1,168 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+
+#include "host_sim.h"
+
+/*
+ * Tâches et groupes d'événements FreeRTOS sur threads POSIX.
+ *
+ * Un seul thread s'exécute à la fois (verrou global, pris par le thread
+ * principal à la première création de tâche) : le simulateur reste
+ * déterministe et les stand-ins n'ont pas à être réentrants. Chaque tâche a
+ * sa propre horloge simulée, comme si elle tournait sur son propre cœur :
+ * une tâche part de l'heure de sa création et, en sortie d'attente, avance
+ * jusqu'à l'instant où les bits attendus ont été levés. Le travail de deux
+ * tâches se recouvre donc sur l'horloge simulée.
+ */
+
+#define HOST_EVENT_BITS 24
+
+struct host_event_group {
+    EventBits_t bits;
+    int64_t set_us[HOST_EVENT_BITS];  // Horloge de la tâche qui a levé chaque bit
+};
+
+typedef struct {
+    TaskFunction_t function;
+    void *arg;
+    int64_t start_us;
+} host_task_start_t;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+static bool main_locked = false;
+
+// Reprendre l'horloge simulée d'une tâche qui redevient active
+static void resume_clock(int64_t clock_us)
+{
+    host_sim_advance_us(clock_us - host_sim_now_us());
+}
+
+static void lock_main(void)
+{
+    if (!main_locked) {
+        pthread_mutex_lock(&lock);
+        main_locked = true;
+    }
+}
+
+static void *task_entry(void *param)
+{
+    host_task_start_t start = *(host_task_start_t *)param;
+    free(param);
+
+    pthread_mutex_lock(&lock);
+    resume_clock(start.start_us);
+    start.function(start.arg);
+
+    // Une tâche FreeRTOS ne retourne pas : vTaskDelete(NULL) attendu
+    abort();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    (void)core_id;
+    lock_main();
+
+    host_task_start_t *start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return pdFAIL;
+    }
+    start->function = function;
+    start->arg = arg;
+    start->start_us = host_sim_now_us();
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, task_entry, start) != 0) {
+        free(start);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    if (created_task != NULL) {
+        *created_task = NULL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task != NULL) {
+        abort();
+    }
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+    pthread_exit(NULL);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return calloc(1, sizeof(struct host_event_group));
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, const EventBits_t bits)
+{
+    int64_t now = host_sim_now_us();
+    for (int i = 0; i < HOST_EVENT_BITS; i++) {
+        if ((bits & (1u << i)) && !(group->bits & (1u << i))) {
+            group->set_us[i] = now;
+        }
+    }
+    group->bits |= bits;
+    pthread_cond_broadcast(&changed);
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, const EventBits_t bits)
+{
+    EventBits_t previous = group->bits;
+    group->bits &= ~bits;
+    return previous;
+}
+
+static bool bits_ready(const struct host_event_group *group, EventBits_t bits, bool wait_for_all)
+{
+    return wait_for_all ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+}
+
+// Instant où la condition d'attente a été remplie : dernier bit levé (tous),
+// premier bit levé (un seul)
+static int64_t ready_us(const struct host_event_group *group, EventBits_t bits, bool wait_for_all)
+{
+    int64_t ready = wait_for_all ? INT64_MIN : INT64_MAX;
+    for (int i = 0; i < HOST_EVENT_BITS; i++) {
+        if ((bits & group->bits & (1u << i)) == 0) {
+            continue;
+        }
+        if (wait_for_all ? group->set_us[i] > ready : group->set_us[i] < ready) {
+            ready = group->set_us[i];
+        }
+    }
+    return ready;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, const EventBits_t bits, const BaseType_t clear_on_exit,
+                                const BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    lock_main();
+
+    int64_t clock_us = host_sim_now_us();
+    while (!bits_ready(group, bits, wait_for_all)) {
+        pthread_cond_wait(&changed, &lock);
+    }
+    int64_t ready = ready_us(group, bits, wait_for_all);
+    resume_clock(ready > clock_us ? ready : clock_us);
+
+    EventBits_t result = group->bits;
+    if (clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    return result;
+}
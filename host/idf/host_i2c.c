@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <driver/i2c_master.h>
+
+#include "host_sim.h"
+
+// Bus I2C simulé : chaque transfert est confié à host_i2c_transfer (aucun
+// périphérique par défaut) et facturé sur l'horloge simulée à la fréquence SCL
+
+esp_err_t (*host_i2c_transfer)(uint16_t address, const uint8_t *write, size_t write_size, uint8_t *read,
+                               size_t read_size) = NULL;
+
+struct host_i2c_bus {
+    i2c_port_num_t port;
+};
+
+struct host_i2c_device {
+    uint16_t address;
+    uint32_t scl_speed_hz;
+};
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *bus_config, i2c_master_bus_handle_t *ret_bus_handle)
+{
+    struct host_i2c_bus *bus = calloc(1, sizeof(*bus));
+    if (bus == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    bus->port = bus_config->i2c_port;
+    *ret_bus_handle = bus;
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus_handle)
+{
+    free(bus_handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle)
+{
+    (void)bus_handle;
+    struct host_i2c_device *device = calloc(1, sizeof(*device));
+    if (device == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    device->address = dev_config->device_address;
+    device->scl_speed_hz = dev_config->scl_speed_hz > 0 ? dev_config->scl_speed_hz : 100000;
+    *ret_handle = device;
+    return ESP_OK;
+}
+
+// Octets d'adresse et de données, 9 coups d'horloge chacun
+static esp_err_t transfer(i2c_master_dev_handle_t device, const uint8_t *write, size_t write_size, uint8_t *read,
+                          size_t read_size)
+{
+    size_t bytes = write_size + read_size + (write_size > 0) + (read_size > 0);
+    host_sim_advance_us((int64_t)bytes * 9 * 1000000 / device->scl_speed_hz);
+    if (host_i2c_transfer == NULL) {
+        return ESP_ERR_INVALID_STATE;  // Pas d'acquittement : aucun périphérique
+    }
+    return host_i2c_transfer(device->address, write, write_size, read, read_size);
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    return transfer(i2c_dev, write_buffer, write_size, NULL, 0);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer, size_t read_size,
+                             int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    return transfer(i2c_dev, NULL, 0, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size,
+                                      int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    return transfer(i2c_dev, write_buffer, write_size, read_buffer, read_size);
+}
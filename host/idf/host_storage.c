@@ -0,0 +1,501 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_spiffs.h>
+#include <esp_partition.h>
+#include <esp_vfs_fat.h>
+#include <nvs_flash.h>
+#include <driver/spi_common.h>
+
+#include "host_sim.h"
+#include "host_storage.h"
+#include "config.h"
+
+/*
+ * Stand-ins stockage : répertoires pour SPIFFS et la carte SD, image mappée
+ * pour la partition brute, un fichier par clé NVS. Les états de montage sont remis à zéro à chaque
+ * démarrage simulé, comme sur l'ESP32.
+ */
+
+#define PARTITION_IMAGE HOST_PARTITION_LABEL ".img"
+#define NVS_DIR "nvs"
+#define NVS_MAX_NAMESPACES 4
+
+static const char *TAG = "HOST_STORAGE";
+
+static bool spiffs_mounted = false;
+static char spiffs_base[64];
+static bool spi_bus_ready = false;
+static bool sd_mounted = false;
+static bool sd_present = true;
+static bool flash_present = true;
+static bool nvs_ready = false;
+static char nvs_namespaces[NVS_MAX_NAMESPACES][16];
+static sdmmc_card_t sd_card = {
+    .cid = { .name = "HOSTSD", .serial = 0x12345678 },
+    .csd = { .capacity = 31116288, .sector_size = 512 },
+    .max_freq_khz = SDMMC_FREQ_HIGHSPEED,
+};
+
+static esp_partition_t partition = {
+    .type = ESP_PARTITION_TYPE_DATA,
+    .subtype = ESP_PARTITION_SUBTYPE_DATA_SPIFFS,
+    .address = HOST_PARTITION_ADDRESS,
+    .size = HOST_PARTITION_SIZE,
+    .erase_size = HOST_FLASH_SECTOR_SIZE,
+    .label = HOST_PARTITION_LABEL,
+};
+static uint8_t *flash = NULL;
+uint32_t host_partition_size = HOST_PARTITION_SIZE;
+static uint64_t sd_used_bytes;    // Fichiers de la carte (esp_vfs_fat_info)
+static bool sd_used_known = false;
+static uint64_t sd_used_written;  // host_media_stats.sd_write_bytes au relevé de sd_used_bytes
+
+static int remove_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+    (void)st;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+// Supprimer un support d'une simulation précédente (répertoire ou image)
+static void wipe(const char *path)
+{
+    if (nftw(path, remove_entry, 8, FTW_DEPTH | FTW_PHYS) != 0 && errno != ENOENT) {
+        ESP_LOGW(TAG, "Impossible de supprimer %s", path);
+    }
+}
+
+int host_storage_open(const char *dir, bool fresh)
+{
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        return -1;
+    }
+    if (chdir(dir) != 0) {
+        return -1;
+    }
+    sd_used_known = false;
+    if (flash == NULL) {
+        partition.size = host_partition_size;
+    }
+    if (fresh) {
+        wipe(BUFFER_MOUNT_POINT);
+        wipe(MOUNT_POINT);
+        wipe(PARTITION_IMAGE);
+        wipe(NVS_DIR);
+    }
+    return 0;
+}
+
+void host_storage_close(void)
+{
+    if (flash != NULL) {
+        munmap(flash, partition.size);
+        flash = NULL;
+    }
+}
+
+void host_storage_boot(void)
+{
+    spiffs_mounted = false;
+    spi_bus_ready = false;
+    sd_mounted = false;
+    nvs_ready = false;
+}
+
+void host_sim_set_sd_present(bool present)
+{
+    sd_present = present;
+}
+
+void host_sim_set_flash_present(bool present)
+{
+    flash_present = present;
+}
+
+int host_storage_sd_freq_khz(void)
+{
+    return sd_mounted ? sd_card.real_freq_khz : SDMMC_FREQ_DEFAULT;
+}
+
+// Image de la partition, créée effacée (0xFF) au premier accès
+static bool map_partition(void)
+{
+    if (flash != NULL) {
+        return true;
+    }
+
+    int fd = open(PARTITION_IMAGE, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool created = fstat(fd, &st) == 0 && st.st_size == 0;
+    if (created && ftruncate(fd, partition.size) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, partition.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    flash = map;
+    if (created) {
+        memset(flash, 0xFF, partition.size);
+    }
+    return true;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    if (type != partition.type || (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != partition.subtype)) {
+        return NULL;
+    }
+    if (label != NULL && strcmp(label, partition.label) != 0) {
+        return NULL;
+    }
+    if (!flash_present) {
+        return NULL;
+    }
+    return map_partition() ? &partition : NULL;
+}
+
+static bool in_partition(const esp_partition_t *part, size_t offset, size_t size)
+{
+    return part == &partition && flash != NULL && offset <= part->size && size <= part->size - offset;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t src_offset, void *dst, size_t size)
+{
+    if (!in_partition(part, src_offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, flash + src_offset, size);
+    host_media_stats.flash_read_bytes += size;
+    host_sim_advance_us(host_cost_model.flash_read_us_per_kb * (int64_t)size / 1024);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t dst_offset, const void *src, size_t size)
+{
+    if (!in_partition(part, dst_offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    host_fault_kind_t fault = host_fault_check(HOST_MEDIA_FLASH, HOST_OP_WRITE);
+    if (fault == HOST_FAULT_MEDIA_FULL) {
+        return ESP_FAIL;
+    }
+    size_t programmed = fault == HOST_FAULT_TORN_WRITE ? size / 2 : size;
+
+    // NOR : la programmation ne fait passer des bits que de 1 à 0
+    const uint8_t *bytes = src;
+    for (size_t i = 0; i < programmed; i++) {
+        flash[dst_offset + i] &= bytes[i];
+    }
+    host_media_stats.flash_write_bytes += programmed;
+    host_sim_advance_us(host_cost_model.flash_write_us_per_kb * (int64_t)programmed / 1024);
+    if (fault == HOST_FAULT_TORN_WRITE) {
+        host_fault_power_cut();
+    }
+    if (fault == HOST_FAULT_BIT_FLIP && size > 0) {
+        flash[dst_offset + size / 2] ^= 0x10;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size)
+{
+    if (offset % HOST_FLASH_SECTOR_SIZE != 0 || size % HOST_FLASH_SECTOR_SIZE != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!in_partition(part, offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (host_fault_check(HOST_MEDIA_FLASH, HOST_OP_ERASE) == HOST_FAULT_TORN_WRITE) {
+        // Effacement interrompu : seule la première moitié de la plage est à 0xFF
+        memset(flash + offset, 0xFF, size / 2);
+        host_fault_power_cut();
+    }
+    memset(flash + offset, 0xFF, size);
+    host_media_stats.flash_erases += size / HOST_FLASH_SECTOR_SIZE;
+    host_sim_advance_us(host_cost_model.flash_erase_us * (int64_t)(size / HOST_FLASH_SECTOR_SIZE));
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf)
+{
+    if (spiffs_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (strcmp(conf->partition_label, HOST_PARTITION_LABEL) != 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (!flash_present) {
+        return ESP_FAIL;
+    }
+    if (mkdir(conf->base_path, 0755) != 0 && errno != EEXIST) {
+        return ESP_FAIL;
+    }
+    snprintf(spiffs_base, sizeof(spiffs_base), "%s", conf->base_path);
+    spiffs_mounted = true;
+    host_sim_advance_us(host_cost_model.spiffs_mount_us);
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_spiffs_unregister(const char *partition_label)
+{
+    (void)partition_label;
+    if (!spiffs_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    spiffs_mounted = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    (void)partition_label;
+    if (!spiffs_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // SPIFFS garde ~25 % de la partition pour ses métadonnées et le ramasse-miettes
+    *total_bytes = (size_t)partition.size * 3 / 4;
+    *used_bytes = 0;
+
+    DIR *dir = opendir(spiffs_base);
+    if (dir == NULL) {
+        return ESP_OK;
+    }
+    struct dirent *entry;
+    char path[320];
+    while ((entry = readdir(dir)) != NULL) {
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", spiffs_base, entry->d_name);
+        if (entry->d_name[0] != '.' && stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+            *used_bytes += (size_t)st.st_size;
+        }
+    }
+    closedir(dir);
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, int dma_chan)
+{
+    (void)host_id;
+    (void)bus_config;
+    (void)dma_chan;
+    if (spi_bus_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    spi_bus_ready = true;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    (void)host_id;
+    spi_bus_ready = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_fat_sdspi_mount(const char *base_path, const sdmmc_host_t *host_config,
+                                  const sdspi_device_config_t *slot_config,
+                                  const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                                  sdmmc_card_t **out_card)
+{
+    (void)slot_config;
+    (void)mount_config;
+    if (!spi_bus_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!sd_present) {
+        return ESP_ERR_TIMEOUT;  // Pas de réponse de la carte
+    }
+    if (sd_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Sonde à 400 kHz puis horloge la plus haute commune à l'hôte et à la carte ;
+    // au-delà de ce que tolère le câblage, les lectures échouent au CRC
+    host_sim_advance_us(host_cost_model.sd_mount_us);
+    int freq_khz = host_config->max_freq_khz < sd_card.max_freq_khz ? host_config->max_freq_khz : sd_card.max_freq_khz;
+    if (freq_khz > host_cost_model.sd_max_freq_khz) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (mkdir(base_path, 0755) != 0 && errno != EEXIST) {
+        return ESP_FAIL;
+    }
+    sd_card.real_freq_khz = freq_khz;
+    sd_mounted = true;
+    if (out_card != NULL) {
+        *out_card = &sd_card;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_fat_sdcard_unmount(const char *base_path, sdmmc_card_t *card)
+{
+    (void)base_path;
+    (void)card;
+    if (!sd_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    sd_mounted = false;
+    return ESP_OK;
+}
+
+static int add_entry_size(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+    (void)path;
+    (void)ftw;
+    if (flag == FTW_F) {
+        sd_used_bytes += (uint64_t)st->st_size;
+    }
+    return 0;
+}
+
+esp_err_t esp_vfs_fat_info(const char *base_path, uint64_t *out_total_bytes, uint64_t *out_free_bytes)
+{
+    if (!sd_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Taille des fichiers relevée une fois par simulation, puis suivie par les
+    // octets écrits (majorée : les réécritures comptent comme de la place prise)
+    if (!sd_used_known) {
+        sd_used_bytes = 0;
+        if (nftw(base_path, add_entry_size, 8, FTW_PHYS) != 0) {
+            return ESP_FAIL;
+        }
+        sd_used_known = true;
+        sd_used_written = host_media_stats.sd_write_bytes;
+    }
+    uint64_t used = sd_used_bytes + (host_media_stats.sd_write_bytes - sd_used_written);
+    uint64_t total = (uint64_t)sd_card.csd.capacity * sd_card.csd.sector_size;
+    *out_total_bytes = total;
+    *out_free_bytes = total > used ? total - used : 0;
+    return ESP_OK;
+}
+
+void sdmmc_card_print_info(FILE *stream, const sdmmc_card_t *card)
+{
+    if (host_log_level < ESP_LOG_INFO) {
+        return;
+    }
+    // Même destination que les logs (voir host_log_output)
+    if (stream == stdout && host_log_output != NULL) {
+        stream = host_log_output;
+    }
+    fprintf(stream, "Name: %s\nType: SDHC/SDXC\nSpeed: %d kHz\nSize: %lluMB\n", card->cid.name, card->real_freq_khz,
+            (unsigned long long)card->csd.capacity * card->csd.sector_size / (1024 * 1024));
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    if (mkdir(NVS_DIR, 0755) != 0 && errno != EEXIST) {
+        return ESP_FAIL;
+    }
+    nvs_ready = true;
+    host_sim_advance_us(host_cost_model.nvs_init_us);
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    wipe(NVS_DIR);
+    nvs_ready = false;
+    return ESP_OK;
+}
+
+// Handle = index de l'espace de noms + 1
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    (void)open_mode;
+    if (!nvs_ready) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    for (int i = 0; i < NVS_MAX_NAMESPACES; i++) {
+        if (nvs_namespaces[i][0] == '\0') {
+            snprintf(nvs_namespaces[i], sizeof(nvs_namespaces[i]), "%s", namespace_name);
+        }
+        if (strcmp(nvs_namespaces[i], namespace_name) == 0) {
+            *out_handle = (nvs_handle_t)i + 1;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+static bool nvs_key_path(nvs_handle_t handle, const char *key, char *path, size_t size)
+{
+    if (!nvs_ready || handle == 0 || handle > NVS_MAX_NAMESPACES) {
+        return false;
+    }
+    snprintf(path, size, NVS_DIR "/%s.%s", nvs_namespaces[handle - 1], key);
+    return true;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    char path[64];
+    if (!nvs_key_path(handle, key, path, sizeof(path))) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    size_t read = fread(out_value, 1, *length, file);
+    bool longer = fgetc(file) != EOF;
+    fclose(file);
+    if (longer) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    *length = read;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    char path[64];
+    if (!nvs_key_path(handle, key, path, sizeof(path))) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    // Entrée NVS écrite d'un bloc : une coupure la laisse intacte ou absente
+    if (host_fault_check(HOST_MEDIA_NVS, HOST_OP_META) == HOST_FAULT_REJECTED) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return ESP_FAIL;
+    }
+    bool ok = fwrite(value, 1, length, file) == length;
+    ok = fclose(file) == 0 && ok;
+    host_media_stats.nvs_writes++;
+    host_sim_advance_us(host_cost_model.nvs_write_us);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return handle == 0 || handle > NVS_MAX_NAMESPACES ? ESP_ERR_NVS_INVALID_HANDLE : ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
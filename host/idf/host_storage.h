@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "host_sim.h"
+
+// Supports simulés (interne aux stand-ins, voir host_sim.h)
+
+int host_storage_open(const char *dir, bool fresh);
+void host_storage_close(void);
+
+// Nouveau démarrage : plus rien n'est monté ni initialisé
+void host_storage_boot(void);
+
+// Horloge SPI de la carte montée (kHz), pour facturer les transferts
+int host_storage_sd_freq_khz(void);
+
+// Opérations qui modifient un support, pour l'injection de fautes
+typedef enum {
+    HOST_OP_WRITE,  // Écriture de données (coupure à mi-course, bit inversé, support plein)
+    HOST_OP_ERASE,  // Effacement de secteurs (coupure à mi-course)
+    HOST_OP_META,   // fsync, fermeture, troncature, suppression, écriture NVS
+} host_op_t;
+
+// Avant une opération (host_fault.c) : coupure armée (ne revient pas), sinon
+// faute que le stand-in doit appliquer (HOST_FAULT_NONE : opération normale)
+host_fault_kind_t host_fault_check(host_media_t media, host_op_t op);
+
+// Coupure d'alimentation, après une écriture ou un effacement à mi-course
+_Noreturn void host_fault_power_cut(void);
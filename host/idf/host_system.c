@@ -0,0 +1,230 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <esp_heap_caps.h>
+#include <nvs.h>
+#include <driver/gpio.h>
+#include <freertos/task.h>
+#include <esp_rom_sys.h>
+
+#include "host_sim.h"
+#include "host_storage.h"
+#include "host_ulp.h"
+
+/*
+ * Stand-ins système : horloge simulée, cycle démarrage / deep sleep,
+ * RTC memory, logs, GPIO et tas.
+ */
+
+// Section des variables RTC_DATA_ATTR (voir esp_attr.h)
+extern char __start_chiro_rtc[] __attribute__((weak));
+extern char __stop_chiro_rtc[] __attribute__((weak));
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+FILE *host_log_output = NULL;
+
+host_cost_model_t host_cost_model = {
+    .spiffs_mount_us = 800000,
+    .spiffs_open_us = 2000,
+    .flash_read_us_per_kb = 100,
+    .flash_write_us_per_kb = 2800,
+    .flash_erase_us = 45000,
+    .sd_mount_us = 150000,
+    .sd_open_us = 3000,
+    .sd_read_us_per_kb = 1500,
+    .sd_write_us_per_kb = 2500,
+    .sd_bus_us_per_kb = 410,
+    .sd_max_freq_khz = 40000,
+    .sd_sync_us = 10000,
+    .nvs_init_us = 6000,
+    .nvs_write_us = 1500,
+    .log_us_per_char = 87,
+};
+
+host_media_stats_t host_media_stats;
+
+static int64_t now_us = 0;          // Horloge absolue simulée
+static int64_t boot_us = 0;         // Instant du dernier démarrage
+static int64_t awake_us = 0;        // Cumul des réveils terminés
+static uint64_t timer_wakeup_us = 0;
+static esp_sleep_wakeup_cause_t wakeup_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+static esp_sleep_wakeup_cause_t sleep_wakeup_cause = ESP_SLEEP_WAKEUP_TIMER;  // Fin du dernier deep sleep
+static char *rtc_power_on_image = NULL;
+
+static size_t rtc_size(void)
+{
+    return __start_chiro_rtc != NULL ? (size_t)(__stop_chiro_rtc - __start_chiro_rtc) : 0;
+}
+
+int host_sim_open(const char *dir, bool fresh)
+{
+    // Image de la RTC memory à la mise sous tension, avant tout réveil
+    if (rtc_power_on_image == NULL && rtc_size() > 0) {
+        rtc_power_on_image = malloc(rtc_size());
+        if (rtc_power_on_image == NULL) {
+            return -1;
+        }
+        memcpy(rtc_power_on_image, __start_chiro_rtc, rtc_size());
+    }
+    if (host_storage_open(dir, fresh) != 0) {
+        return -1;
+    }
+
+    // Horloge et compteurs partent de zéro au premier démarrage
+    now_us = 0;
+    boot_us = 0;
+    awake_us = 0;
+    memset(&host_media_stats, 0, sizeof(host_media_stats));
+    memset(host_media_ops, 0, sizeof(host_media_ops));
+    host_sim_clear_fault();
+    return 0;
+}
+
+void host_sim_close(void)
+{
+    host_storage_close();
+    free(rtc_power_on_image);
+    rtc_power_on_image = NULL;
+}
+
+void host_sim_boot(bool power_loss)
+{
+    if (power_loss) {
+        if (rtc_power_on_image != NULL) {
+            memcpy(__start_chiro_rtc, rtc_power_on_image, rtc_size());
+        }
+        wakeup_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+    } else {
+        wakeup_cause = sleep_wakeup_cause;
+    }
+    boot_us = now_us;
+    timer_wakeup_us = 0;
+    host_storage_boot();
+    host_ulp_boot(power_loss);
+}
+
+void host_sim_deep_sleep(uint64_t sleep_us)
+{
+    awake_us += now_us - boot_us;
+    int64_t timer_us = (int64_t)(sleep_us != 0 ? sleep_us : timer_wakeup_us);
+
+    // Le programme ULP tourne pendant le sommeil et peut réveiller l'ESP32 avant le timer
+    int64_t ulp_us = host_ulp_sleep(now_us, timer_us > 0 ? timer_us : INT64_MAX / 2);
+    if (ulp_us >= 0) {
+        now_us += ulp_us;
+        sleep_wakeup_cause = ESP_SLEEP_WAKEUP_ULP;
+    } else {
+        now_us += timer_us;
+        sleep_wakeup_cause = ESP_SLEEP_WAKEUP_TIMER;
+    }
+}
+
+void host_sim_advance_us(int64_t us)
+{
+    now_us += us;
+}
+
+int64_t host_sim_now_us(void)
+{
+    return now_us;
+}
+
+int64_t host_sim_awake_us(void)
+{
+    return awake_us;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return now_us - boot_us;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    return wakeup_cause;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+    timer_wakeup_us = time_in_us;
+    return ESP_OK;
+}
+
+void vTaskDelay(const TickType_t ticks)
+{
+    now_us += (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    now_us += us;
+}
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (level > host_log_level) {
+        return;
+    }
+
+    FILE *out = host_log_output != NULL ? host_log_output : stdout;
+    int chars = fprintf(out, "%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    va_list args;
+    va_start(args, format);
+    chars += vfprintf(out, format, args);
+    va_end(args);
+    fputc('\n', out);
+
+    // Temps d'émission sur l'UART, comme sur l'ESP32 quand les logs sont actifs
+    now_us += (int64_t)(chars + 1) * host_cost_model.log_us_per_char;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK:                   return "ESP_OK";
+        case ESP_FAIL:                 return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:           return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:      return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:    return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:     return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:        return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:    return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:          return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC:      return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION:  return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_NVS_NOT_FOUND:    return "ESP_ERR_NVS_NOT_FOUND";
+        default:                       return "UNKNOWN ERROR";
+    }
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    (void)gpio_num;
+    (void)level;
+    return ESP_OK;
+}
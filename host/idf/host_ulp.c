@@ -0,0 +1,198 @@
+#include <string.h>
+
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <esp32/ulp.h>
+#include <driver/adc.h>
+
+#include "host_sim.h"
+#include "host_ulp.h"
+
+/*
+ * Stand-in du coprocesseur ULP : interpréteur des instructions de
+ * host/include/esp32/ulp.h, exécuté à chaque période du timer ULP pendant
+ * le deep sleep simulé.
+ */
+
+#define HOST_ULP_MAX_PROGRAM 256
+
+// Instructions exécutées par réveil de l'ULP avant d'abandonner (programme sans HALT)
+#define HOST_ULP_MAX_STEPS 10000
+
+RTC_DATA_ATTR uint32_t host_rtc_slow_mem[2048];
+
+static uint16_t default_adc(int adc_unit, int channel, int64_t now_us)
+{
+    (void)adc_unit;
+    (void)channel;
+    (void)now_us;
+    return 2048;
+}
+
+uint16_t (*host_ulp_adc)(int adc_unit, int channel, int64_t now_us) = default_adc;
+
+// Programme chargé (étiquettes résolues en indices d'instruction)
+static ulp_insn_t program[HOST_ULP_MAX_PROGRAM];
+static size_t program_size = 0;
+static uint32_t entry = 0;
+static int64_t period_us = 0;
+static bool timer_running = false;
+static bool wakeup_enabled = false;
+
+esp_err_t ulp_process_macros_and_load(uint32_t load_addr, const ulp_insn_t *source, size_t *psize)
+{
+    // Adresse de chaque étiquette dans le programme sans pseudo-instructions
+    int32_t labels[64];
+    memset(labels, -1, sizeof(labels));
+    size_t size = 0;
+    for (size_t i = 0; i < *psize; i++) {
+        if (source[i].op != HOST_ULP_LABEL) {
+            size++;
+        } else if (source[i].label < 64) {
+            labels[source[i].label] = (int32_t)(load_addr + size);
+        } else {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (load_addr + size > HOST_ULP_MAX_PROGRAM) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t pc = load_addr;
+    for (size_t i = 0; i < *psize; i++) {
+        if (source[i].op == HOST_ULP_LABEL) {
+            continue;
+        }
+        program[pc] = source[i];
+        if (source[i].op == HOST_ULP_BL || source[i].op == HOST_ULP_BGE) {
+            if (source[i].label >= 64 || labels[source[i].label] < 0) {
+                return ESP_ERR_NOT_FOUND;
+            }
+            program[pc].label = (uint32_t)labels[source[i].label];
+        }
+        // Le programme occupe aussi la RTC slow memory
+        host_rtc_slow_mem[pc] = 0x10000000u | (uint32_t)source[i].op;
+        pc++;
+    }
+    if (pc > program_size) {
+        program_size = pc;
+    }
+    *psize = size;
+    return ESP_OK;
+}
+
+esp_err_t ulp_run(uint32_t entry_point)
+{
+    if (entry_point >= program_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    entry = entry_point;
+    timer_running = true;
+    return ESP_OK;
+}
+
+esp_err_t ulp_set_wakeup_period(size_t period_index, uint32_t period)
+{
+    if (period_index != 0 || period == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    period_us = period;
+    return ESP_OK;
+}
+
+void ulp_timer_stop(void)
+{
+    timer_running = false;
+}
+
+void ulp_timer_resume(void)
+{
+    timer_running = program_size > 0;
+}
+
+esp_err_t esp_sleep_enable_ulp_wakeup(void)
+{
+    wakeup_enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t adc1_config_width(adc_bits_width_t width_bit)
+{
+    (void)width_bit;
+    return ESP_OK;
+}
+
+esp_err_t adc1_config_channel_atten(adc1_channel_t channel, adc_atten_t atten)
+{
+    (void)channel;
+    (void)atten;
+    return ESP_OK;
+}
+
+void adc1_ulp_enable(void)
+{
+}
+
+// Un réveil de l'ULP : exécuter jusqu'à HALT, true si WAKE a été exécuté
+static bool run_once(int64_t now_us)
+{
+    uint16_t reg[4] = { 0 };
+    bool wake = false;
+    uint32_t pc = entry;
+
+    for (int steps = 0; steps < HOST_ULP_MAX_STEPS && pc < program_size; steps++) {
+        const ulp_insn_t *insn = &program[pc++];
+        switch (insn->op) {
+            case HOST_ULP_MOVI: reg[insn->rd] = (uint16_t)insn->imm; break;
+            case HOST_ULP_LD:
+                reg[insn->rd] = (uint16_t)host_rtc_slow_mem[(reg[insn->rs1] + insn->imm) & 0x7FF];
+                break;
+            case HOST_ULP_ST:
+                host_rtc_slow_mem[(reg[insn->rs1] + insn->imm) & 0x7FF] = ((pc - 1) << 21) | reg[insn->rs2];
+                break;
+            case HOST_ULP_ADC:
+                reg[insn->rd] = host_ulp_adc(insn->rs1, insn->imm, now_us) & 0xFFF;
+                break;
+            case HOST_ULP_ADDR: reg[insn->rd] = (uint16_t)(reg[insn->rs1] + reg[insn->rs2]); break;
+            case HOST_ULP_ADDI: reg[insn->rd] = (uint16_t)(reg[insn->rs1] + insn->imm); break;
+            case HOST_ULP_SUBI: reg[insn->rd] = (uint16_t)(reg[insn->rs1] - insn->imm); break;
+            case HOST_ULP_LSHI: reg[insn->rd] = (uint16_t)(reg[insn->rs1] << insn->imm); break;
+            case HOST_ULP_BL:
+                if (reg[R0] < insn->imm) {
+                    pc = insn->label;
+                }
+                break;
+            case HOST_ULP_BGE:
+                if (reg[R0] >= insn->imm) {
+                    pc = insn->label;
+                }
+                break;
+            case HOST_ULP_WAKE: wake = true; break;
+            case HOST_ULP_HALT: return wake;
+            case HOST_ULP_LABEL: break;
+        }
+    }
+    return wake;
+}
+
+int64_t host_ulp_sleep(int64_t start_us, int64_t max_us)
+{
+    if (!timer_running || period_us <= 0) {
+        return -1;
+    }
+    for (int64_t elapsed = period_us; elapsed <= max_us; elapsed += period_us) {
+        if (run_once(start_us + elapsed) && wakeup_enabled) {
+            return elapsed;
+        }
+    }
+    return -1;
+}
+
+void host_ulp_boot(bool power_loss)
+{
+    wakeup_enabled = false;
+    if (power_loss) {
+        timer_running = false;
+        program_size = 0;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Coprocesseur ULP simulé (interne aux stand-ins, voir host_sim.h)
+
+// Nouveau démarrage : réveil par l'ULP à réactiver ; power_loss arrête aussi l'ULP
+void host_ulp_boot(bool power_loss);
+
+// Deep sleep commencé à start_us : exécuter le programme à chaque période du
+// timer ULP, retourne le délai jusqu'à l'instruction WAKE (-1 : pas de réveil
+// par l'ULP avant max_us)
+int64_t host_ulp_sleep(int64_t start_us, int64_t max_us);
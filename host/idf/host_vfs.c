@@ -0,0 +1,267 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <driver/sdmmc_host.h>
+
+#include "host_sim.h"
+#include "host_storage.h"
+#include "config.h"
+
+/*
+ * Accès fichiers des sources de src/ : les appels stdio sont redirigés ici par
+ * l'option --wrap du linker (host/CMakeLists.txt). Chaque accès à la flash
+ * (BUFFER_MOUNT_POINT) ou à la carte SD (MOUNT_POINT) est compté et facturé
+ * sur l'horloge simulée selon host_cost_model, et passe par l'injection de
+ * fautes (host_fault_check()).
+ */
+
+FILE *__real_fopen(const char *path, const char *mode);
+int __real_fclose(FILE *file);
+size_t __real_fread(void *ptr, size_t size, size_t count, FILE *file);
+size_t __real_fwrite(const void *ptr, size_t size, size_t count, FILE *file);
+int __real_fputs(const char *str, FILE *file);
+int __real_fsync(int fd);
+int __real_truncate(const char *path, off_t length);
+int __real_remove(const char *path);
+int __real_stat(const char *path, struct stat *st);
+int __real_mkdir(const char *path, mode_t mode);
+
+typedef enum {
+    MEDIA_NONE,
+    MEDIA_FLASH,
+    MEDIA_SD,
+} media_t;
+
+#define MAX_OPEN_FILES 16
+
+static struct {
+    FILE *file;
+    media_t media;
+} open_files[MAX_OPEN_FILES];
+
+static bool has_prefix(const char *path, const char *prefix)
+{
+    size_t len = strlen(prefix);
+    return strncmp(path, prefix, len) == 0 && path[len] == '/';
+}
+
+static media_t media_of_path(const char *path)
+{
+    if (has_prefix(path, BUFFER_MOUNT_POINT)) {
+        return MEDIA_FLASH;
+    }
+    if (has_prefix(path, MOUNT_POINT)) {
+        return MEDIA_SD;
+    }
+    return MEDIA_NONE;
+}
+
+static media_t media_of_file(FILE *file)
+{
+    for (int i = 0; i < MAX_OPEN_FILES; i++) {
+        if (open_files[i].file == file) {
+            return open_files[i].media;
+        }
+    }
+    return MEDIA_NONE;
+}
+
+static media_t media_of_fd(int fd)
+{
+    for (int i = 0; i < MAX_OPEN_FILES; i++) {
+        if (open_files[i].file != NULL && fileno(open_files[i].file) == fd) {
+            return open_files[i].media;
+        }
+    }
+    return MEDIA_NONE;
+}
+
+static int64_t per_kb(int64_t us_per_kb, size_t bytes)
+{
+    return us_per_kb * (int64_t)bytes / 1024;
+}
+
+// Coût SD donné à 20 MHz : seule la part du bus suit l'horloge SPI de la carte
+static int64_t sd_us_per_kb(int64_t us_per_kb)
+{
+    int64_t bus = host_cost_model.sd_bus_us_per_kb;
+    return us_per_kb - bus + bus * SDMMC_FREQ_DEFAULT / host_storage_sd_freq_khz();
+}
+
+// Ouverture, suppression, troncature : coût fixe de recherche dans le système de fichiers
+static void charge_lookup(media_t media)
+{
+    if (media == MEDIA_FLASH) {
+        host_sim_advance_us(host_cost_model.spiffs_open_us);
+    } else if (media == MEDIA_SD) {
+        host_sim_advance_us(host_cost_model.sd_open_us);
+    }
+}
+
+static void charge_transfer(media_t media, size_t bytes, bool write)
+{
+    if (media == MEDIA_FLASH) {
+        if (write) {
+            host_media_stats.flash_write_bytes += bytes;
+            host_sim_advance_us(per_kb(host_cost_model.flash_write_us_per_kb, bytes));
+        } else {
+            host_media_stats.flash_read_bytes += bytes;
+            host_sim_advance_us(per_kb(host_cost_model.flash_read_us_per_kb, bytes));
+        }
+    } else if (media == MEDIA_SD) {
+        if (write) {
+            host_media_stats.sd_write_bytes += bytes;
+            host_sim_advance_us(per_kb(sd_us_per_kb(host_cost_model.sd_write_us_per_kb), bytes));
+        } else {
+            host_media_stats.sd_read_bytes += bytes;
+            host_sim_advance_us(per_kb(sd_us_per_kb(host_cost_model.sd_read_us_per_kb), bytes));
+        }
+    }
+}
+
+// Injection de fautes avant une opération sur un fichier de la flash ou de la SD
+static host_fault_kind_t check_fault(media_t media, host_op_t op)
+{
+    if (media == MEDIA_NONE) {
+        return HOST_FAULT_NONE;
+    }
+    return host_fault_check(media == MEDIA_FLASH ? HOST_MEDIA_FLASH : HOST_MEDIA_SD, op);
+}
+
+// Écriture avec la faute armée : moitié des octets puis coupure, un bit
+// inversé, ou refus (support plein). Octets écrits en retour
+static size_t write_faulty(host_fault_kind_t fault, media_t media, const void *ptr, size_t bytes, FILE *file)
+{
+    if (fault == HOST_FAULT_MEDIA_FULL) {
+        errno = ENOSPC;
+        return 0;
+    }
+    if (fault == HOST_FAULT_TORN_WRITE) {
+        size_t done = __real_fwrite(ptr, 1, bytes / 2, file);
+        fflush(file);
+        charge_transfer(media, done, true);
+        host_fault_power_cut();
+    }
+
+    uint8_t *copy = malloc(bytes > 0 ? bytes : 1);
+    if (copy == NULL) {
+        return 0;
+    }
+    memcpy(copy, ptr, bytes);
+    if (bytes > 0) {
+        copy[bytes / 2] ^= 0x10;
+    }
+    size_t done = __real_fwrite(copy, 1, bytes, file);
+    free(copy);
+    charge_transfer(media, done, true);
+    return done;
+}
+
+FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    media_t media = media_of_path(path);
+    charge_lookup(media);
+
+    FILE *file = __real_fopen(path, mode);
+    if (file != NULL && media != MEDIA_NONE) {
+        for (int i = 0; i < MAX_OPEN_FILES; i++) {
+            if (open_files[i].file == NULL) {
+                open_files[i].file = file;
+                open_files[i].media = media;
+                break;
+            }
+        }
+    }
+    return file;
+}
+
+int __wrap_fclose(FILE *file)
+{
+    // Les données encore dans le tampon stdio sont écrites à la fermeture
+    check_fault(media_of_file(file), HOST_OP_META);
+    for (int i = 0; i < MAX_OPEN_FILES; i++) {
+        if (open_files[i].file == file) {
+            open_files[i].file = NULL;
+            break;
+        }
+    }
+    return __real_fclose(file);
+}
+
+size_t __wrap_fread(void *ptr, size_t size, size_t count, FILE *file)
+{
+    size_t done = __real_fread(ptr, size, count, file);
+    charge_transfer(media_of_file(file), done * size, false);
+    return done;
+}
+
+size_t __wrap_fwrite(const void *ptr, size_t size, size_t count, FILE *file)
+{
+    media_t media = media_of_file(file);
+    host_fault_kind_t fault = check_fault(media, HOST_OP_WRITE);
+    if (fault != HOST_FAULT_NONE) {
+        return size > 0 ? write_faulty(fault, media, ptr, size * count, file) / size : 0;
+    }
+    size_t done = __real_fwrite(ptr, size, count, file);
+    charge_transfer(media_of_file(file), done * size, true);
+    return done;
+}
+
+int __wrap_fputs(const char *str, FILE *file)
+{
+    media_t media = media_of_file(file);
+    host_fault_kind_t fault = check_fault(media, HOST_OP_WRITE);
+    if (fault != HOST_FAULT_NONE) {
+        size_t length = strlen(str);
+        return write_faulty(fault, media, str, length, file) == length ? 0 : EOF;
+    }
+    int ret = __real_fputs(str, file);
+    if (ret >= 0) {
+        charge_transfer(media_of_file(file), strlen(str), true);
+    }
+    return ret;
+}
+
+int __wrap_fsync(int fd)
+{
+    check_fault(media_of_fd(fd), HOST_OP_META);
+    if (media_of_fd(fd) == MEDIA_SD) {
+        host_media_stats.sd_syncs++;
+        host_sim_advance_us(host_cost_model.sd_sync_us);
+    }
+    return __real_fsync(fd);
+}
+
+int __wrap_truncate(const char *path, off_t length)
+{
+    check_fault(media_of_path(path), HOST_OP_META);
+    charge_lookup(media_of_path(path));
+    return __real_truncate(path, length);
+}
+
+int __wrap_remove(const char *path)
+{
+    check_fault(media_of_path(path), HOST_OP_META);
+    charge_lookup(media_of_path(path));
+    return __real_remove(path);
+}
+
+// Recherche d'une entrée de répertoire sur la SD (SPIFFS n'a pas de répertoires)
+int __wrap_stat(const char *path, struct stat *st)
+{
+    if (media_of_path(path) == MEDIA_SD) {
+        charge_lookup(MEDIA_SD);
+    }
+    return __real_stat(path, st);
+}
+
+int __wrap_mkdir(const char *path, mode_t mode)
+{
+    if (media_of_path(path) == MEDIA_SD) {
+        charge_lookup(MEDIA_SD);
+    }
+    return __real_mkdir(path, mode);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host : ADC1 (lectures fournies par host_ulp_adc, host_sim.h)
+
+#include <esp_err.h>
+
+typedef int adc1_channel_t;
+
+typedef enum { ADC_WIDTH_BIT_12 = 3 } adc_bits_width_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_12 = 3 } adc_atten_t;
+
+esp_err_t adc1_config_width(adc_bits_width_t width_bit);
+esp_err_t adc1_config_channel_atten(adc1_channel_t channel, adc_atten_t atten);
+void adc1_ulp_enable(void);
@@ -0,0 +1,12 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host
+
+typedef struct {
+    int slot;
+    int max_freq_khz;
+} sdmmc_host_t;
+
+#define SDMMC_FREQ_DEFAULT   20000
+#define SDMMC_FREQ_HIGHSPEED 40000
+#define SDMMC_FREQ_PROBING   400
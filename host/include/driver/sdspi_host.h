@@ -0,0 +1,21 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host
+
+#include <driver/sdmmc_host.h>
+#include <driver/spi_common.h>
+
+typedef struct {
+    spi_host_device_t host_id;
+    int gpio_cs;
+    int gpio_cd;
+    int gpio_wp;
+    int gpio_int;
+} sdspi_device_config_t;
+
+#define SDSPI_DEFAULT_HOST 2
+#define SDSPI_DEFAULT_DMA  SPI_DMA_CH_AUTO
+
+#define SDSPI_HOST_DEFAULT() { .slot = SDSPI_DEFAULT_HOST, .max_freq_khz = SDMMC_FREQ_DEFAULT }
+#define SDSPI_DEVICE_CONFIG_DEFAULT() { .host_id = SDSPI_DEFAULT_HOST, .gpio_cs = 13, \
+                                        .gpio_cd = -1, .gpio_wp = -1, .gpio_int = -1 }
@@ -0,0 +1,21 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host
+
+#include <esp_err.h>
+
+typedef int spi_host_device_t;
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+} spi_bus_config_t;
+
+#define SPI_DMA_CH_AUTO 3
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, int dma_chan);
+esp_err_t spi_bus_free(spi_host_device_t host_id);
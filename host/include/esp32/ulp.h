@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+ * Stand-in ESP-IDF pour le build host : coprocesseur ULP (machine à états).
+ *
+ * Les macros I_* / M_* produisent des instructions lues par un petit
+ * interpréteur (idf/host_ulp.c) au lieu du codage binaire de l'ESP32 : le
+ * programme de src/ s'exécute tel quel pendant le deep sleep simulé, sur une
+ * RTC slow memory conservée comme les variables RTC_DATA_ATTR. ST écrit
+ * l'adresse de l'instruction dans les 16 bits de poids fort, comme l'ULP.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <esp_err.h>
+
+#define R0 0
+#define R1 1
+#define R2 2
+#define R3 3
+
+typedef enum {
+    HOST_ULP_MOVI,
+    HOST_ULP_LD,
+    HOST_ULP_ST,
+    HOST_ULP_ADC,
+    HOST_ULP_ADDR,
+    HOST_ULP_ADDI,
+    HOST_ULP_SUBI,
+    HOST_ULP_LSHI,
+    HOST_ULP_BL,      // Saut si R0 < imm
+    HOST_ULP_BGE,     // Saut si R0 >= imm
+    HOST_ULP_LABEL,   // Pseudo-instruction, retirée au chargement
+    HOST_ULP_WAKE,
+    HOST_ULP_HALT,
+} host_ulp_op_t;
+
+typedef struct {
+    host_ulp_op_t op;
+    uint8_t rd;
+    uint8_t rs1;
+    uint8_t rs2;
+    int32_t imm;
+    uint32_t label;
+} ulp_insn_t;
+
+#define I_MOVI(reg_dest, imm_)               { .op = HOST_ULP_MOVI, .rd = (reg_dest), .imm = (imm_) }
+#define I_LD(reg_dest, reg_addr, offset_)    { .op = HOST_ULP_LD, .rd = (reg_dest), .rs1 = (reg_addr), .imm = (offset_) }
+#define I_ST(reg_val, reg_addr, offset_)     { .op = HOST_ULP_ST, .rs1 = (reg_addr), .rs2 = (reg_val), .imm = (offset_) }
+#define I_ADC(reg_dest, adc_idx, pad_idx)    { .op = HOST_ULP_ADC, .rd = (reg_dest), .rs1 = (adc_idx), .imm = (pad_idx) }
+#define I_ADDR(reg_dest, reg_src1, reg_src2) { .op = HOST_ULP_ADDR, .rd = (reg_dest), .rs1 = (reg_src1), .rs2 = (reg_src2) }
+#define I_ADDI(reg_dest, reg_src, imm_)      { .op = HOST_ULP_ADDI, .rd = (reg_dest), .rs1 = (reg_src), .imm = (imm_) }
+#define I_SUBI(reg_dest, reg_src, imm_)      { .op = HOST_ULP_SUBI, .rd = (reg_dest), .rs1 = (reg_src), .imm = (imm_) }
+#define I_LSHI(reg_dest, reg_src, imm_)      { .op = HOST_ULP_LSHI, .rd = (reg_dest), .rs1 = (reg_src), .imm = (imm_) }
+#define M_LABEL(label_num)                   { .op = HOST_ULP_LABEL, .label = (label_num) }
+#define M_BL(label_num, imm_value)           { .op = HOST_ULP_BL, .label = (label_num), .imm = (imm_value) }
+#define M_BGE(label_num, imm_value)          { .op = HOST_ULP_BGE, .label = (label_num), .imm = (imm_value) }
+#define I_WAKE()                             { .op = HOST_ULP_WAKE }
+#define I_HALT()                             { .op = HOST_ULP_HALT }
+
+// RTC slow memory (8 Ko), dans la section chiro_rtc
+extern uint32_t host_rtc_slow_mem[2048];
+#define RTC_SLOW_MEM host_rtc_slow_mem
+
+esp_err_t ulp_process_macros_and_load(uint32_t load_addr, const ulp_insn_t *program, size_t *psize);
+esp_err_t ulp_run(uint32_t entry_point);
+esp_err_t ulp_set_wakeup_period(size_t period_index, uint32_t period_us);
+void ulp_timer_stop(void);
+void ulp_timer_resume(void);
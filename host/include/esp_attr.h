@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+ * Stand-in ESP-IDF pour le build host.
+ *
+ * Les variables RTC_DATA_ATTR sont regroupées dans la section chiro_rtc : le
+ * simulateur la conserve entre deux réveils (deep sleep) et lui rend son image
+ * de mise sous tension pour simuler une coupure d'alimentation (host_sim.h).
+ */
+#define RTC_DATA_ATTR   __attribute__((section("chiro_rtc")))
+#define RTC_NOINIT_ATTR __attribute__((section("chiro_rtc")))
+#define RTC_FAST_ATTR   __attribute__((section("chiro_rtc")))
+#define RTC_IRAM_ATTR
+#define IRAM_ATTR
+#define DRAM_ATTR
@@ -0,0 +1,7 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host : l'attente active fait avancer l'horloge simulée
+
+#include <stdint.h>
+
+void esp_rom_delay_us(uint32_t us);
@@ -0,0 +1,24 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host : la cause du réveil vient du simulateur
+
+#include <stdint.h>
+#include <esp_err.h>
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+} esp_sleep_wakeup_cause_t;
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+
+// Durée mémorisée, appliquée par host_sim_deep_sleep()
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+
+// Réveil par l'instruction WAKE du programme ULP (host_ulp.c)
+esp_err_t esp_sleep_enable_ulp_wakeup(void);
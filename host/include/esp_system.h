@@ -0,0 +1,5 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host
+
+#include <esp_err.h>
@@ -0,0 +1,8 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host : horloge simulée (host_sim.h)
+
+#include <stdint.h>
+
+// Microsecondes écoulées depuis le démarrage (réveil) simulé
+int64_t esp_timer_get_time(void);
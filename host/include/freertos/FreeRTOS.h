@@ -0,0 +1,25 @@
+#pragma once
+
+// Stand-in FreeRTOS pour le build host : un tick = 1 ms d'horloge simulée
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)  ((TickType_t)((uint64_t)(ms) * configTICK_RATE_HZ / 1000))
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFF)
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+
+// Sections critiques : les tâches simulées ne s'exécutent jamais en même temps
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
@@ -0,0 +1,17 @@
+#pragma once
+
+// Stand-in FreeRTOS pour le build host : groupes d'événements (idf/host_freertos.c).
+// Seule l'attente sans délai maximal (portMAX_DELAY) est prise en charge.
+
+#include <freertos/FreeRTOS.h>
+
+typedef struct host_event_group *EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate(void);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, const EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, const EventBits_t bits);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, const EventBits_t bits, const BaseType_t clear_on_exit,
+                                const BaseType_t wait_for_all, TickType_t ticks_to_wait);
+
+#define xEventGroupGetBits(group) xEventGroupClearBits(group, 0)
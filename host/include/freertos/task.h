@@ -0,0 +1,19 @@
+#pragma once
+
+// Stand-in FreeRTOS pour le build host : l'attente fait avancer l'horloge simulée.
+// Les tâches sont des threads exécutés un seul à la fois (idf/host_freertos.c).
+
+#include <freertos/FreeRTOS.h>
+
+typedef void (*TaskFunction_t)(void *arg);
+typedef struct host_task *TaskHandle_t;
+
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+void vTaskDelay(const TickType_t ticks);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id);
+
+// Seule la suppression de la tâche appelante (NULL) est prise en charge
+void vTaskDelete(TaskHandle_t task);
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <esp_err.h>
+
+/*
+ * 🖥️ CONTRÔLE DU SIMULATEUR HOST
+ *
+ * Les stand-ins ESP-IDF de host/include reposent sur une horloge simulée et
+ * sur des fichiers du répertoire de simulation :
+ *   buffer/           partition SPIFFS montée sur BUFFER_MOUNT_POINT
+ *   data_buffer.img   partition brute du backend RAW (image NOR mappée)
+ *   sdcard/           carte SD montée sur MOUNT_POINT
+ *   nvs/              partition NVS (un fichier par clé), conservée aux coupures
+ *
+ * Le programme ULP éventuel (idf/host_ulp.c) s'exécute pendant les deep sleeps
+ * et peut réveiller l'ESP32 avant le timer (cause ESP_SLEEP_WAKEUP_ULP).
+ *
+ * Un réveil simulé = host_sim_boot() + chiro_wake_cycle() + host_sim_deep_sleep().
+ */
+
+// Géométrie de la partition data_buffer (huge_app.csv)
+#define HOST_PARTITION_LABEL   "data_buffer"
+#define HOST_PARTITION_ADDRESS 0x110000
+#define HOST_PARTITION_SIZE    0xEF0000
+#define HOST_FLASH_SECTOR_SIZE 4096
+
+// Taille simulée de data_buffer (défaut HOST_PARTITION_SIZE, multiple de
+// HOST_FLASH_SECTOR_SIZE), à choisir avant host_sim_open()
+extern uint32_t host_partition_size;
+
+/*
+ * Modèle de coût des supports : chaque accès fait avancer l'horloge simulée,
+ * pour que les durées relevées par esp_timer_get_time() (banc de mesure)
+ * reflètent les opérations coûteuses. Ordres de grandeur pour une flash NOR
+ * SPI à 40 MHz DIO et une carte SD en SPI à 20 MHz, à recaler sur mesures.
+ */
+typedef struct {
+    int64_t spiffs_mount_us;         // esp_vfs_spiffs_register() sur 15 Mo
+    int64_t spiffs_open_us;          // fopen/remove dans SPIFFS (recherche d'objet)
+    int64_t flash_read_us_per_kb;
+    int64_t flash_write_us_per_kb;   // Programmation par pages de 256 octets
+    int64_t flash_erase_us;          // Effacement d'un secteur de 4 Ko
+    int64_t sd_mount_us;             // Initialisation de la carte + montage FAT
+    int64_t sd_open_us;              // fopen/remove/truncate/stat/mkdir (FAT + répertoire)
+    int64_t sd_read_us_per_kb;       // À SDMMC_FREQ_DEFAULT (20 MHz)
+    int64_t sd_write_us_per_kb;      // À SDMMC_FREQ_DEFAULT (20 MHz)
+    int64_t sd_bus_us_per_kb;        // Part du bus SPI dans les deux précédents, suit l'horloge
+    int sd_max_freq_khz;             // Horloge SPI tolérée par la carte et le câblage
+    int64_t sd_sync_us;              // fsync : mise à jour FAT + entrée de répertoire
+    int64_t nvs_init_us;             // nvs_flash_init() : lecture des pages NVS
+    int64_t nvs_write_us;            // nvs_set_blob() : entrée écrite (effacement de page amorti)
+    int64_t log_us_per_char;         // UART à 115200 bauds, pour chaque log affiché
+} host_cost_model_t;
+
+extern host_cost_model_t host_cost_model;
+
+// Octets réellement échangés avec les supports simulés
+typedef struct {
+    uint64_t flash_read_bytes;
+    uint64_t flash_write_bytes;
+    uint32_t flash_erases;
+    uint64_t sd_read_bytes;
+    uint64_t sd_write_bytes;
+    uint32_t sd_syncs;
+    uint32_t nvs_writes;
+} host_media_stats_t;
+
+extern host_media_stats_t host_media_stats;
+
+// Se placer dans le répertoire de simulation (créé au besoin).
+// fresh = effacer les supports d'une simulation précédente
+int host_sim_open(const char *dir, bool fresh);
+
+// Libérer l'image de la partition
+void host_sim_close(void);
+
+// Démarrage simulé : après un deep sleep, ou mise sous tension (power_loss = true)
+// qui rend à la RTC memory son contenu initial
+void host_sim_boot(bool power_loss);
+
+// Deep sleep : sleep_us = 0 reprend la durée programmée par esp_sleep_enable_timer_wakeup()
+void host_sim_deep_sleep(uint64_t sleep_us);
+
+// Faire avancer l'horloge simulée pendant un réveil
+void host_sim_advance_us(int64_t us);
+
+// Horloge simulée absolue (µs depuis le premier démarrage)
+int64_t host_sim_now_us(void);
+
+// Temps total passé éveillé (µs)
+int64_t host_sim_awake_us(void);
+
+// Lectures de l'ADC par le programme ULP simulé (défaut : mi-échelle), now_us = horloge simulée
+extern uint16_t (*host_ulp_adc)(int adc_unit, int channel, int64_t now_us);
+
+// Périphériques du bus I2C simulé (défaut NULL : aucun, pas d'acquittement) ;
+// write puis read, l'un ou l'autre vide. Durée facturée par le stand-in.
+extern esp_err_t (*host_i2c_transfer)(uint16_t address, const uint8_t *write, size_t write_size, uint8_t *read,
+                                      size_t read_size);
+
+// Carte SD présente ou non (absente = échec du montage)
+void host_sim_set_sd_present(bool present);
+
+// Partition du tampon flash accessible ou non (inaccessible = échec du montage
+// SPIFFS ou partition brute introuvable)
+void host_sim_set_flash_present(bool present);
+
+/*
+ * 💥 INJECTION DE FAUTES (banc de torture, host/chiro_torture.c)
+ *
+ * Les opérations qui modifient un support sont numérotées par support depuis
+ * host_sim_open() : écriture, troncature, suppression, fsync et fermeture de
+ * fichier (SPIFFS, SD), écriture et effacement de la partition brute,
+ * écriture NVS. Une faute armée se déclenche à l'opération choisie. Une
+ * coupure appelle host_power_cut dans la tâche qui accédait au support : les
+ * données encore dans les tampons stdio des fichiers ouverts sont perdues.
+ */
+typedef enum {
+    HOST_MEDIA_FLASH,  // Tampon : fichiers SPIFFS ou partition brute
+    HOST_MEDIA_SD,
+    HOST_MEDIA_NVS,
+    HOST_MEDIA_COUNT,
+} host_media_t;
+
+typedef enum {
+    HOST_FAULT_NONE,
+    HOST_FAULT_POWER_CUT,   // Coupure juste avant l'opération
+    HOST_FAULT_TORN_WRITE,  // Moitié des octets écrits (ou de la plage effacée), puis coupure
+    HOST_FAULT_BIT_FLIP,    // Un bit inversé dans la prochaine écriture de données, sans erreur
+    HOST_FAULT_MEDIA_FULL,  // Écritures de données refusées jusqu'à host_sim_clear_fault()
+    HOST_FAULT_REJECTED,    // NVS : écritures refusées avec une erreur jusqu'à host_sim_clear_fault()
+} host_fault_kind_t;
+
+// Opérations de chaque support depuis host_sim_open()
+extern uint32_t host_media_ops[HOST_MEDIA_COUNT];
+
+// Armer une faute à l'opération op (à partir de 0) du support media
+void host_sim_arm_fault(host_fault_kind_t kind, host_media_t media, uint32_t op);
+
+// Faute déclenchée (support plein : toujours active)
+bool host_sim_fault_triggered(void);
+
+// Désarmer la faute, libérer le support plein
+void host_sim_clear_fault(void);
+
+// Coupure d'alimentation : ne revient pas (défaut NULL : abort)
+extern void (*host_power_cut)(void);
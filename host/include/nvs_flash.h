@@ -0,0 +1,8 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host : partition NVS simulée dans nvs/
+
+#include <nvs.h>
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_erase(void);
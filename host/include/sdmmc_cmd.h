@@ -0,0 +1,25 @@
+#pragma once
+
+// Stand-in ESP-IDF pour le build host
+
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    int capacity;     // Nombre de secteurs
+    int sector_size;
+} sdmmc_csd_t;
+
+typedef struct {
+    char name[8];
+    int serial;
+} sdmmc_cid_t;
+
+typedef struct {
+    sdmmc_cid_t cid;
+    sdmmc_csd_t csd;
+    int max_freq_khz;   // Fréquence maximale annoncée par la carte
+    int real_freq_khz;  // Fréquence effective après la sonde
+} sdmmc_card_t;
+
+void sdmmc_card_print_info(FILE *stream, const sdmmc_card_t *card);
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sensor_trace.h"
+#include "record.h"
+
+static sensor_reading_t *trace = NULL;
+static uint32_t trace_length = 0;
+static uint32_t trace_next = 0;
+static uint32_t trace_conversion_us = 0;
+
+#define TRACE_MAX_FIELDS 16
+
+// Colonne CSV de chaque grandeur du catalogue (record_schema.h)
+#define TRACE_COLUMN(name, field, type, min, max, scale, column) { column, RECORD_Q_##name },
+static const struct {
+    const char *column;
+    int quantity;
+} trace_columns[] = { RECORD_CHANNEL_CATALOG(TRACE_COLUMN) };
+#undef TRACE_COLUMN
+
+// Grandeur lue dans chaque champ d'une ligne (-1 : ignoré)
+static int field_quantity[TRACE_MAX_FIELDS];
+
+// Colonnes d'un en-tête CSV de la carte SD ("ID,DateTime,...")
+static void parse_header(char *line)
+{
+    int index = 0;
+    for (char *field = strtok(line, ",\r\n"); field != NULL && index < TRACE_MAX_FIELDS;
+         field = strtok(NULL, ",\r\n"), index++) {
+        field_quantity[index] = -1;
+        for (size_t i = 0; i < sizeof(trace_columns) / sizeof(trace_columns[0]); i++) {
+            if (strcmp(field, trace_columns[i].column) == 0) {
+                field_quantity[index] = trace_columns[i].quantity;
+            }
+        }
+    }
+    while (index < TRACE_MAX_FIELDS) {
+        field_quantity[index++] = -1;
+    }
+}
+
+// Ordre par défaut : CSV de la carte SD sans en-tête (canaux historiques),
+// ou température,humidité[,pression]
+static void default_columns(int count)
+{
+    for (int i = 0; i < TRACE_MAX_FIELDS; i++) {
+        field_quantity[i] = -1;
+    }
+    int first = count >= 4 ? 2 : 0;
+    field_quantity[first] = RECORD_Q_temperature;
+    field_quantity[first + 1] = RECORD_Q_humidity;
+    if (count == 3) {
+        field_quantity[2] = RECORD_Q_pressure;
+    }
+}
+
+// Valeur d'un champ, absente s'il est vide ou vaut N/A
+static void parse_value(const char *field, int quantity, sensor_reading_t *reading)
+{
+    char *end;
+    float value = strtof(field, &end);
+    if (end == field) {
+        return;
+    }
+#define TRACE_SET(name, f, type, min, max, scale, column) \
+    if (quantity == RECORD_Q_##name) {                     \
+        RECORD_VALUE_SET(reading, name, value);            \
+    }
+    RECORD_CHANNEL_CATALOG(TRACE_SET)
+#undef TRACE_SET
+}
+
+int sensor_trace_load(const char *path, uint32_t conversion_us)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    free(trace);
+    trace = NULL;
+    trace_length = 0;
+    trace_next = 0;
+    trace_conversion_us = conversion_us;
+
+    uint32_t capacity = 0;
+    bool has_header = false;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        // En-têtes et commentaires : pas de chiffre en tête de ligne
+        if (line[0] != '-' && (line[0] < '0' || line[0] > '9')) {
+            if (strncmp(line, "ID,", 3) == 0) {
+                parse_header(line);
+                has_header = true;
+            }
+            continue;
+        }
+
+        char *fields[TRACE_MAX_FIELDS];
+        int count = 0;
+        for (char *field = strtok(line, ",\r\n"); field != NULL && count < TRACE_MAX_FIELDS;
+             field = strtok(NULL, ",\r\n")) {
+            fields[count++] = field;
+        }
+        if (count < 2) {
+            continue;
+        }
+
+        if (!has_header) {
+            default_columns(count);
+        }
+        sensor_reading_t reading = {0};
+        for (int i = 0; i < count; i++) {
+            if (field_quantity[i] >= 0) {
+                parse_value(fields[i], field_quantity[i], &reading);
+            }
+        }
+
+        if (trace_length == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 1024;
+            sensor_reading_t *grown = realloc(trace, capacity * sizeof(*trace));
+            if (grown == NULL) {
+                break;
+            }
+            trace = grown;
+        }
+        trace[trace_length++] = reading;
+    }
+    fclose(file);
+    return trace_length > 0 ? 0 : -1;
+}
+
+uint32_t sensor_trace_length(void)
+{
+    return trace_length;
+}
+
+static esp_err_t trace_trigger(uint32_t *conversion_us)
+{
+    *conversion_us = trace_conversion_us;
+    return trace_length > 0 ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+static esp_err_t trace_collect(uint32_t id, sensor_reading_t *reading)
+{
+    (void)id;
+    if (trace_length == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *reading = trace[trace_next];
+    trace_next = (trace_next + 1) % trace_length;
+    return ESP_OK;
+}
+
+const sensor_driver_t sensor_driver_trace = {
+    .name = "trace",
+    .trigger = trace_trigger,
+    .collect = trace_collect,
+};
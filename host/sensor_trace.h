@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "sensor.h"
+
+/*
+ * 🎞️ PILOTE DE CAPTEUR REJOUANT UNE TRACE (simulateur host)
+ *
+ * Une mesure par relevé, dans l'ordre du fichier, en boucle. Formats acceptés,
+ * lignes d'en-tête ignorées :
+ *   - CSV de la carte SD (ID,DateTime,Temperature_C,Humidity_%,...), colonnes
+ *     reconnues par leur nom dans l'en-tête (record_schema.h), N/A = absente
+ *   - température,humidité[,pression]
+ * conversion_us : durée de conversion simulée, attendue par sensors_collect().
+ */
+
+extern const sensor_driver_t sensor_driver_trace;
+
+// Charger la trace ; 0 si au moins une mesure a été lue
+int sensor_trace_load(const char *path, uint32_t conversion_us);
+
+// Mesures chargées
+uint32_t sensor_trace_length(void);
@@ -0,0 +1,211 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <esp_attr.h>
+
+#include "aggregates.h"
+#include "record.h"
+
+#define AGGREGATES_MAGIC 0x53474741u  // "AGGS"
+
+// Voie d'une période en cours (centièmes)
+typedef struct {
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int32_t sum;
+    int64_t sum_squares;
+} agg_channel_t;
+
+typedef struct {
+    uint32_t start;  // Début de la période (epoch aligné sur la durée du niveau)
+    agg_channel_t temperature;
+    agg_channel_t humidity;
+} agg_open_t;
+
+// Résumé d'une période terminée (24 octets)
+typedef struct __attribute__((packed)) {
+    uint32_t start;
+    uint16_t count[2];  // Mesures de température / d'humidité
+    int16_t  temperature[4];  // min, moyenne, max, écart-type (centièmes)
+    uint16_t humidity[4];
+} agg_summary_t;
+
+_Static_assert(sizeof(agg_summary_t) == 24, "résumé d'agrégat: 24 octets attendus");
+
+typedef struct {
+    uint32_t magic;  // AGGREGATES_MAGIC si l'état est cohérent
+    agg_open_t open[AGG_TIER_NUM];
+    uint16_t done_count[AGG_TIER_NUM];    // Périodes terminées en file
+    uint16_t done_next[AGG_TIER_NUM];     // Prochain emplacement de la file circulaire
+    uint32_t dropped[AGG_TIER_NUM];       // Périodes remplacées avant un flush
+    agg_summary_t minutes[AGG_MINUTE_SLOTS];
+    agg_summary_t hours[AGG_HOUR_SLOTS];
+    agg_summary_t days[AGG_DAY_SLOTS];
+} aggregates_t;
+
+// État en RTC memory : remis à zéro après une perte d'alimentation
+RTC_DATA_ATTR static aggregates_t aggregates;
+
+static const uint32_t tier_seconds[AGG_TIER_NUM] = { 60, 3600, 86400 };
+static const uint16_t tier_slots[AGG_TIER_NUM] = { AGG_MINUTE_SLOTS, AGG_HOUR_SLOTS, AGG_DAY_SLOTS };
+static const char *const tier_files[AGG_TIER_NUM] = { SD_AGG_MINUTE_FILE, SD_AGG_HOUR_FILE, SD_AGG_DAY_FILE };
+
+static agg_summary_t *tier_queue(agg_tier_t tier)
+{
+    switch (tier) {
+        case AGG_TIER_MINUTE: return aggregates.minutes;
+        case AGG_TIER_HOUR:   return aggregates.hours;
+        default:              return aggregates.days;
+    }
+}
+
+static void channel_add(agg_channel_t *channel, int32_t centi)
+{
+    if (channel->count == 0 || centi < channel->min) {
+        channel->min = centi;
+    }
+    if (channel->count == 0 || centi > channel->max) {
+        channel->max = centi;
+    }
+    channel->count++;
+    channel->sum += centi;
+    channel->sum_squares += (int64_t)centi * centi;
+}
+
+// min, moyenne, max, écart-type en centièmes (calculés à la clôture seulement)
+static void channel_summary(const agg_channel_t *channel, int32_t out[4])
+{
+    if (channel->count == 0) {
+        memset(out, 0, 4 * sizeof(int32_t));
+        return;
+    }
+    double mean = (double)channel->sum / channel->count;
+    double variance = (double)channel->sum_squares / channel->count - mean * mean;
+    out[0] = channel->min;
+    out[1] = (int32_t)lround(mean);
+    out[2] = channel->max;
+    out[3] = (int32_t)lround(variance > 0.0 ? sqrt(variance) : 0.0);
+}
+
+static void close_period(agg_tier_t tier)
+{
+    const agg_open_t *open = &aggregates.open[tier];
+    if (open->temperature.count == 0 && open->humidity.count == 0) {
+        return;
+    }
+
+    agg_summary_t *slot = &tier_queue(tier)[aggregates.done_next[tier]];
+    int32_t values[4];
+
+    slot->start = open->start;
+    slot->count[0] = open->temperature.count > UINT16_MAX ? UINT16_MAX : (uint16_t)open->temperature.count;
+    slot->count[1] = open->humidity.count > UINT16_MAX ? UINT16_MAX : (uint16_t)open->humidity.count;
+    channel_summary(&open->temperature, values);
+    for (int i = 0; i < 4; i++) {
+        slot->temperature[i] = (int16_t)values[i];
+    }
+    channel_summary(&open->humidity, values);
+    for (int i = 0; i < 4; i++) {
+        slot->humidity[i] = (uint16_t)values[i];
+    }
+
+    aggregates.done_next[tier] = (uint16_t)((aggregates.done_next[tier] + 1) % tier_slots[tier]);
+    if (aggregates.done_count[tier] < tier_slots[tier]) {
+        aggregates.done_count[tier]++;
+    } else {
+        aggregates.dropped[tier]++;
+    }
+}
+
+void aggregates_add(const chiro_record_t *record)
+{
+    if (aggregates.magic != AGGREGATES_MAGIC) {
+        memset(&aggregates, 0, sizeof(aggregates));
+        aggregates.magic = AGGREGATES_MAGIC;
+    }
+
+    uint32_t epoch = record->epoch;
+    for (int tier = 0; tier < AGG_TIER_NUM; tier++) {
+        agg_open_t *open = &aggregates.open[tier];
+        uint32_t start = epoch - epoch % tier_seconds[tier];
+        if (start != open->start) {
+            close_period(tier);
+            memset(open, 0, sizeof(*open));
+            open->start = start;
+        }
+        if (!(record->flags & RECORD_FLAG_NO(temperature))) {
+            channel_add(&open->temperature, record->temperature_centi);
+        }
+        if (!(record->flags & RECORD_FLAG_NO(humidity))) {
+            channel_add(&open->humidity, record->humidity_centi);
+        }
+    }
+}
+
+static void write_values(FILE *file, uint16_t count, const int32_t values[4])
+{
+    if (count == 0) {
+        fprintf(file, ",0,,,,");
+        return;
+    }
+    fprintf(file, ",%u", count);
+    for (int i = 0; i < 4; i++) {
+        fprintf(file, ",%s%ld.%02ld", values[i] < 0 ? "-" : "", labs((long)values[i]) / 100, labs((long)values[i]) % 100);
+    }
+}
+
+esp_err_t aggregates_write(agg_tier_t tier, FILE *file)
+{
+    if (aggregates.magic != AGGREGATES_MAGIC || tier >= AGG_TIER_NUM) {
+        return ESP_OK; // Rien de mesuré depuis la mise sous tension
+    }
+
+    // En-tête si le fichier est neuf
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        fputs("Start,Temperature_n,Temperature_min,Temperature_mean,Temperature_max,Temperature_std,"
+              "Humidity_n,Humidity_min,Humidity_mean,Humidity_max,Humidity_std\n", file);
+    }
+    if (aggregates.dropped[tier] > 0) {
+        fprintf(file, "# %lu période(s) remplacée(s) avant le flush\n", (unsigned long)aggregates.dropped[tier]);
+    }
+
+    const agg_summary_t *queue = tier_queue(tier);
+    uint16_t count = aggregates.done_count[tier];
+    uint16_t first = (uint16_t)((aggregates.done_next[tier] + tier_slots[tier] - count) % tier_slots[tier]);
+
+    for (uint16_t i = 0; i < count; i++) {
+        const agg_summary_t *summary = &queue[(first + i) % tier_slots[tier]];
+        int32_t values[4];
+
+        fprintf(file, "%lu", (unsigned long)summary->start);
+        for (int k = 0; k < 4; k++) {
+            values[k] = summary->temperature[k];
+        }
+        write_values(file, summary->count[0], values);
+        for (int k = 0; k < 4; k++) {
+            values[k] = summary->humidity[k];
+        }
+        write_values(file, summary->count[1], values);
+        fputc('\n', file);
+    }
+
+    return ferror(file) ? ESP_FAIL : ESP_OK;
+}
+
+void aggregates_clear(void)
+{
+    if (aggregates.magic != AGGREGATES_MAGIC) {
+        return;
+    }
+    for (int tier = 0; tier < AGG_TIER_NUM; tier++) {
+        aggregates.done_count[tier] = 0;
+        aggregates.dropped[tier] = 0;
+    }
+}
+
+const char *aggregates_file(agg_tier_t tier)
+{
+    return tier < AGG_TIER_NUM ? tier_files[tier] : NULL;
+}
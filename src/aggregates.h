@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <esp_err.h>
+
+#include "config.h"
+#include "record.h"
+
+/*
+ * 📉 AGRÉGATS GLISSANTS PAR MINUTE, HEURE ET JOUR
+ *
+ * À chaque mesure, les périodes en cours des trois niveaux (AGG_TIER_*) sont
+ * mises à jour en RTC memory : nombre, min, max, somme et somme des carrés
+ * par voie, en centièmes. Une période terminée est résumée (min, moyenne,
+ * max, écart-type) dans une file en RTC memory, ajoutée au fichier du niveau
+ * sur la SD au flush suivant : les contrôles de terrain lisent quelques
+ * kilo-octets au lieu de parcourir le journal.
+ *
+ * Les périodes sont alignées sur l'horodatage des mesures (epoch / durée).
+ * Si une file est pleine avant le flush, les plus anciennes périodes sont
+ * remplacées et leur nombre est noté dans le fichier ; c'est le cas de la
+ * file par minute quand l'échantillonnage s'espace (une mesure par minute,
+ * déjà présente telle quelle dans le journal). Une perte d'alimentation perd
+ * les agrégats non encore écrits.
+ */
+
+typedef enum {
+    AGG_TIER_MINUTE,
+    AGG_TIER_HOUR,
+    AGG_TIER_DAY,
+    AGG_TIER_NUM
+} agg_tier_t;
+
+// Périodes terminées gardées en RTC memory entre deux flushs, par niveau
+#ifndef AGG_MINUTE_SLOTS
+#define AGG_MINUTE_SLOTS 64
+#endif
+#ifndef AGG_HOUR_SLOTS
+#define AGG_HOUR_SLOTS 48
+#endif
+#ifndef AGG_DAY_SLOTS
+#define AGG_DAY_SLOTS 8
+#endif
+
+// Ajouter une mesure aux périodes en cours (température et humidité de l'enregistrement,
+// mêmes centièmes que le journal CSV)
+void aggregates_add(const chiro_record_t *record);
+
+// Ajouter les périodes terminées du niveau à un fichier ouvert (lignes CSV) sans les retirer
+esp_err_t aggregates_write(agg_tier_t tier, FILE *file);
+
+// Retirer les périodes terminées une fois tous les niveaux écrits
+void aggregates_clear(void);
+
+// Fichier SD d'un niveau
+const char *aggregates_file(agg_tier_t tier);
@@ -0,0 +1,150 @@
+#include <string.h>
+#include <esp_timer.h>
+
+#include "bench.h"
+#include "logger.h"
+#include "wake_stub.h"
+#include "flash_buffer.h"
+
+#define BENCH_CSV_HEADER "cycle,stub,awake_us,flash_mount_us,flash_bytes,sd_mount_us,sd_freq_khz,sd_on_us,sd_bytes,flush_us\n"
+
+static void add_cycle(bench_summary_t *summary, int64_t awake_us, uint32_t sleep_sec, bool stub)
+{
+    summary->cycles++;
+    if (stub) {
+        summary->stub_cycles++;
+        summary->stub_awake_us += awake_us;
+    }
+    summary->awake_us += awake_us;
+    if (awake_us > summary->awake_max_us) {
+        summary->awake_max_us = awake_us;
+    }
+    summary->sleep_us += (int64_t)sleep_sec * 1000000;
+
+    summary->flash_mount_us += wake_metrics.flash_mount_us;
+    summary->flash_mounts += wake_metrics.flash_mounts;
+    summary->flash_bytes += wake_metrics.flash_bytes;
+    summary->sd_mount_us += wake_metrics.sd_mount_us;
+    summary->sd_mounts += wake_metrics.sd_mounts;
+    summary->sd_probes += wake_metrics.sd_probes;
+    if (wake_metrics.sd_freq_khz > 0) {
+        summary->sd_freq_khz = wake_metrics.sd_freq_khz;
+    }
+    summary->sd_on_us += wake_metrics.sd_on_us;
+    summary->sd_bytes += wake_metrics.sd_bytes;
+
+    if (wake_metrics.flush_us > 0) {
+        summary->flushes++;
+        summary->flush_us += wake_metrics.flush_us;
+        if (wake_metrics.flush_us > summary->flush_max_us) {
+            summary->flush_max_us = wake_metrics.flush_us;
+        }
+    }
+    summary->flushed_records += wake_metrics.flushed_records;
+}
+
+// Jusqu'à cycles réveils ou sleep_limit_us de deep sleep cumulé
+static void run(uint32_t cycles, int64_t sleep_limit_us, bench_sleep_fn_t sleep_fn, FILE *per_cycle,
+                bench_summary_t *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (per_cycle != NULL) {
+        fputs(BENCH_CSV_HEADER, per_cycle);
+    }
+
+    for (uint32_t i = 0; i < cycles && summary->sleep_us < sleep_limit_us; i++) {
+        int64_t start = esp_timer_get_time();
+        bool stub = wake_stub_cycle();
+        uint32_t sleep_sec;
+        if (stub) {
+            memset(&wake_metrics, 0, sizeof(wake_metrics));
+            sleep_sec = wake_stub_sleep_sec();
+        } else {
+            sleep_sec = chiro_wake_cycle();
+            flush_buffer_wait();  // Le réveil dure jusqu'à la fin de la tâche de flush
+        }
+        int64_t awake_us = esp_timer_get_time() - start;
+
+        add_cycle(summary, awake_us, sleep_sec, stub);
+        if (per_cycle != NULL) {
+            fprintf(per_cycle, "%lu,%d,%lld,%lld,%lu,%lld,%d,%lld,%lu,%lld\n", (unsigned long)summary->cycles,
+                    stub, (long long)awake_us, (long long)wake_metrics.flash_mount_us,
+                    (unsigned long)wake_metrics.flash_bytes, (long long)wake_metrics.sd_mount_us,
+                    wake_metrics.sd_freq_khz, (long long)wake_metrics.sd_on_us, (unsigned long)wake_metrics.sd_bytes,
+                    (long long)wake_metrics.flush_us);
+        }
+
+        if (sleep_fn != NULL) {
+            sleep_fn(sleep_sec, stub);
+        }
+    }
+}
+
+void bench_run(uint32_t cycles, bench_sleep_fn_t sleep_fn, FILE *per_cycle, bench_summary_t *summary)
+{
+    run(cycles, INT64_MAX, sleep_fn, per_cycle, summary);
+}
+
+void bench_run_days(uint32_t days, bench_sleep_fn_t sleep_fn, FILE *per_cycle, bench_summary_t *summary)
+{
+    run(UINT32_MAX, (int64_t)days * 86400 * 1000000, sleep_fn, per_cycle, summary);
+}
+
+float bench_mah_per_day(const bench_summary_t *summary, const bench_power_model_t *model)
+{
+    if (summary->cycles == 0) {
+        return 0.0f;
+    }
+
+    // Charge en mA·s : éveil (démarrage complet ou ROM + stub compris), carte SD, deep sleep
+    double awake_s = (double)summary->awake_us / 1e6 + (double)summary->stub_cycles * model->stub_wake_us / 1e6 +
+                     (double)(summary->cycles - summary->stub_cycles) * model->boot_ms / 1e3;
+    double sd_s = (double)summary->sd_on_us / 1e6;
+    double sleep_s = (double)summary->sleep_us / 1e6;
+    double charge_mas = awake_s * model->active_ma + sd_s * model->sd_ma + sleep_s * model->sleep_ua / 1000.0;
+
+    double period_s = awake_s + sleep_s;
+    return period_s > 0 ? (float)(charge_mas / period_s * 86400.0 / 3600.0) : 0.0f;
+}
+
+// Moyenne en ms d'une durée cumulée en µs
+static double avg_ms(int64_t total_us, uint32_t count)
+{
+    return count > 0 ? (double)total_us / count / 1000.0 : 0.0;
+}
+
+void bench_print_summary(FILE *out, const bench_summary_t *summary, const bench_power_model_t *model)
+{
+    uint32_t cycles = summary->cycles;
+    uint32_t full_cycles = cycles - summary->stub_cycles;
+    float mah_day = bench_mah_per_day(summary, model);
+    int64_t boot_us = (int64_t)full_cycles * model->boot_ms * 1000 + (int64_t)summary->stub_cycles * model->stub_wake_us;
+
+    fprintf(out, "=== Banc de mesure : %lu cycles (seuil flush %d, lot RTC %d, sommeil %d s) ===\n",
+            (unsigned long)cycles, BUFFER_FLUSH_THRESHOLD, STAGING_BATCH_SIZE, DEEP_SLEEP_DURATION_SEC);
+    fprintf(out, "Éveil          : %.2f ms/cycle en moyenne démarrages compris, %.2f ms max hors démarrage\n",
+            avg_ms(summary->awake_us + boot_us, cycles), summary->awake_max_us / 1000.0);
+    fprintf(out, "Réveils        : %lu complets de %.2f ms (+%lu ms de démarrage), %lu par le wake stub "
+            "de %.3f ms (+%.3f ms de ROM)\n",
+            (unsigned long)full_cycles, avg_ms(summary->awake_us - summary->stub_awake_us, full_cycles),
+            (unsigned long)model->boot_ms, (unsigned long)summary->stub_cycles,
+            avg_ms(summary->stub_awake_us, summary->stub_cycles), model->stub_wake_us / 1000.0);
+    fprintf(out, "Flash          : %.1f o/cycle, %lu montages de %.2f ms en moyenne\n",
+            cycles > 0 ? (double)summary->flash_bytes / cycles : 0.0, (unsigned long)summary->flash_mounts,
+            avg_ms(summary->flash_mount_us, summary->flash_mounts));
+    fprintf(out, "Carte SD       : %llu octets, %lu montages de %.2f ms (%lu avec sonde), SPI %d kHz, "
+            "alimentée %.2f s au total\n",
+            (unsigned long long)summary->sd_bytes, (unsigned long)summary->sd_mounts,
+            avg_ms(summary->sd_mount_us, summary->sd_mounts), (unsigned long)summary->sd_probes,
+            summary->sd_freq_khz, summary->sd_on_us / 1e6);
+    fprintf(out, "Flush          : %lu flushs, %.2f ms en moyenne, %.2f ms max, %llu mesures copiées\n",
+            (unsigned long)summary->flushes, avg_ms(summary->flush_us, summary->flushes),
+            summary->flush_max_us / 1000.0, (unsigned long long)summary->flushed_records);
+    fprintf(out, "Modèle         : actif %.1f mA, SD +%.1f mA, deep sleep %.1f µA\n",
+            model->active_ma, model->sd_ma, model->sleep_ua);
+    fprintf(out, "Consommation   : %.3f mAh/jour", mah_day);
+    if (mah_day > 0.0f) {
+        fprintf(out, " -> %.0f jours sur %.0f mAh", model->battery_mah / mah_day, model->battery_mah);
+    }
+    fputc('\n', out);
+}
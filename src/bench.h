@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "metrics.h"
+
+/*
+ * ⏱️ BANC DE MESURE ÉNERGIE / LATENCE DU CYCLE DE RÉVEIL
+ *
+ * Rejoue N réveils par les mêmes chemins que l'ESP32 (wake stub, sinon
+ * chiro_wake_cycle() : lot RTC, tampon flash, flush SD), et relève pour chaque cycle le temps
+ * éveillé, les octets écrits en flash et sur la SD, les temps de montage et
+ * le coût des flushs (metrics.h). Les temps viennent d'esp_timer_get_time() :
+ * réels sur l'ESP32, simulés par les stand-ins de host/. Sans deep sleep
+ * entre les cycles (banc sur l'ESP32), le wake stub n'intervient pas.
+ */
+
+// Courants du modèle de consommation (voir BENCH_* dans config.h)
+typedef struct {
+    float active_ma;
+    float sd_ma;
+    float sleep_ua;
+    uint32_t boot_ms;
+    uint32_t stub_wake_us;
+    float battery_mah;
+} bench_power_model_t;
+
+#define BENCH_POWER_MODEL_DEFAULT() {       \
+    .active_ma = BENCH_ACTIVE_MA,           \
+    .sd_ma = BENCH_SD_MA,                   \
+    .sleep_ua = BENCH_SLEEP_UA,             \
+    .boot_ms = BENCH_BOOT_MS,               \
+    .stub_wake_us = BENCH_STUB_WAKE_US,     \
+    .battery_mah = BENCH_BATTERY_MAH,       \
+}
+
+// Cumuls d'une série de cycles
+typedef struct {
+    uint32_t cycles;
+    uint32_t stub_cycles;      // Réveils traités par le wake stub
+    int64_t stub_awake_us;
+    uint32_t flushes;
+    int64_t awake_us;
+    int64_t awake_max_us;
+    int64_t sleep_us;
+    int64_t flash_mount_us;
+    uint32_t flash_mounts;
+    uint64_t flash_bytes;
+    int64_t sd_mount_us;
+    uint32_t sd_mounts;
+    uint32_t sd_probes;        // Montages avec sonde complète (sd_card.h)
+    int sd_freq_khz;           // Horloge SPI du dernier montage
+    int64_t sd_on_us;
+    uint64_t sd_bytes;
+    int64_t flush_us;
+    int64_t flush_max_us;
+    uint64_t flushed_records;
+} bench_summary_t;
+
+// Entre deux cycles (deep sleep simulé sur l'ordinateur, rien sur l'ESP32) ;
+// stub : réveil traité par le wake stub, qui a déjà programmé le sommeil
+// suivant (ni chiro_prepare_sleep() ni timekeeper_sleep())
+typedef void (*bench_sleep_fn_t)(uint32_t sleep_sec, bool stub);
+
+// Rejouer cycles réveils ; per_cycle != NULL : une ligne CSV par cycle
+void bench_run(uint32_t cycles, bench_sleep_fn_t sleep_fn, FILE *per_cycle, bench_summary_t *summary);
+
+// Rejouer des réveils jusqu'à days jours de deep sleep cumulés (saison simulée)
+void bench_run_days(uint32_t days, bench_sleep_fn_t sleep_fn, FILE *per_cycle, bench_summary_t *summary);
+
+// Consommation moyenne estimée (mAh par jour)
+float bench_mah_per_day(const bench_summary_t *summary, const bench_power_model_t *model);
+
+// Bilan lisible de la série
+void bench_print_summary(FILE *out, const bench_summary_t *summary, const bench_power_model_t *model);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#include "config.h"
+#include "record.h"
+
+// Occupation et usure du tampon (storage_health.h)
+typedef struct {
+    uint32_t total_bytes;  // Capacité utile
+    uint32_t used_bytes;   // Mesures en attente et métadonnées
+    uint32_t sectors;      // Secteurs sur lesquels l'usure se répartit
+    uint32_t erase_max;    // Effacements du secteur le plus usé (0 : non observable)
+    bool erases_counted;   // Effacements comptés dans wake_metrics.flash_erases
+} buffer_usage_t;
+
+/*
+ * 🗄️ INTERFACE DES BACKENDS DU TAMPON FLASH
+ *
+ * Le tampon est une file d'enregistrements : ajout en fin, lecture depuis le
+ * plus ancien enregistrement en attente, puis consommation après un flush
+ * réussi. add_to_flash_buffer() / flush_buffer_to_sd() ne connaissent que
+ * cette interface, ce qui permet de comparer les backends à l'identique.
+ */
+typedef struct {
+    const char *name;
+
+    // Monter le stockage et reprendre l'état (reconstruction après perte d'alimentation)
+    esp_err_t (*init)(void);
+
+    // Ajouter des enregistrements en fin de file (ESP_ERR_NO_MEM si plein)
+    esp_err_t (*append)(const chiro_record_t *records, size_t count);
+
+    // Nombre d'enregistrements en attente de flush (coût constant)
+    uint32_t (*count)(void);
+
+    // Lire jusqu'à max enregistrements à partir du rang first (0 = plus ancien en attente)
+    esp_err_t (*read)(uint32_t first, chiro_record_t *out, size_t max, size_t *read_count);
+
+    // Retirer les count plus anciens enregistrements une fois copiés sur la SD
+    esp_err_t (*consume)(uint32_t count);
+
+    // Occupation et usure (tampon monté)
+    esp_err_t (*usage)(buffer_usage_t *usage);
+} buffer_backend_t;
+
+extern const buffer_backend_t buffer_backend_spiffs;
+extern const buffer_backend_t buffer_backend_raw;
+
+#if BUFFER_BACKEND == BUFFER_BACKEND_RAW
+    #define BUFFER_BACKEND_DEFAULT (&buffer_backend_raw)
+#else
+    #define BUFFER_BACKEND_DEFAULT (&buffer_backend_spiffs)
+#endif
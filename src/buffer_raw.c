@@ -0,0 +1,393 @@
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_partition.h>
+
+#include "buffer_backend.h"
+#include "buffer_raw.h"
+#include "metrics.h"
+#include "event_log.h"
+
+/*
+ * 🗄️ BACKEND PARTITION BRUTE (journal circulaire)
+ *
+ * Les enregistrements sont écrits directement dans la partition du tampon via
+ * l'API esp_partition_*, sans système de fichiers : aucun montage au réveil.
+ *
+ * Organisation : chaque secteur de 4 Ko commence par un en-tête de 32 octets
+ * (numéro de séquence, compteur d'effacements, masque de consommation) suivi
+ * de 254 emplacements de 16 octets. Les secteurs sont remplis dans l'ordre et
+ * en boucle, ce qui répartit uniformément les effacements (wear leveling).
+ *
+ * - Tête : prochain emplacement libre (secteur de séquence la plus haute)
+ * - Queue : plus ancien enregistrement non flushé. Le masque de consommation
+ *   n'est que programmé (bits 1 -> 0) au flush, sans effacement : un bit à 0
+ *   marque 8 emplacements flushés.
+ *
+ * Tête et queue vivent en RTC memory ; elles ne sont reconstruites depuis la
+ * flash qu'après une perte d'alimentation.
+ *
+ * Les emplacements restent de taille fixe (pas de blocs compressés comme le
+ * backend SPIFFS) : queue, masque de consommation et reprise sont des
+ * positions d'emplacement.
+ */
+
+static const char *TAG = "CHIRO_RAW";
+
+// Position dans le journal : séquence de secteur * RAW_SLOTS_PER_SECTOR + emplacement
+#define RAW_STATE_MAGIC 0x57415243u  // "CRAW"
+
+typedef struct {
+    uint32_t magic;        // RAW_STATE_MAGIC si l'état est cohérent avec la flash
+    uint32_t head_sector;  // Index du secteur de tête dans la partition
+    uint32_t head_seq;     // Séquence du secteur de tête (0 = journal vierge)
+    uint32_t head_slot;    // Prochain emplacement libre (RAW_SLOTS_PER_SECTOR = secteur plein)
+    uint32_t tail_pos;     // Position du plus ancien enregistrement en attente
+    uint32_t erase_max;    // Effacements du secteur le plus usé (relu à la reconstruction)
+    uint32_t check;
+} raw_state_t;
+
+RTC_DATA_ATTR static raw_state_t raw_state;
+
+static const esp_partition_t *partition = NULL;
+static uint32_t sector_count = 0;
+
+static uint32_t raw_state_checksum(const raw_state_t *state)
+{
+    return state->magic ^ (state->head_sector * 2654435761u) ^ (state->head_seq * 40503u) ^
+           (state->head_slot << 16) ^ ~state->tail_pos ^ (state->erase_max * 2246822519u);
+}
+
+static bool raw_state_is_valid(void)
+{
+    return raw_state.magic == RAW_STATE_MAGIC &&
+           raw_state.check == raw_state_checksum(&raw_state) &&
+           raw_state.head_sector < sector_count;
+}
+
+static void raw_state_commit(void)
+{
+    raw_state.magic = RAW_STATE_MAGIC;
+    raw_state.check = raw_state_checksum(&raw_state);
+}
+
+// Journal vierge : la première écriture ouvrira le secteur 0
+static void raw_state_reset(void)
+{
+    raw_state.head_sector = sector_count - 1;
+    raw_state.head_seq = 0;
+    raw_state.head_slot = RAW_SLOTS_PER_SECTOR;
+    raw_state.tail_pos = RAW_SLOTS_PER_SECTOR;
+    raw_state_commit();
+}
+
+static uint32_t head_pos(void)
+{
+    return raw_state.head_seq * RAW_SLOTS_PER_SECTOR + raw_state.head_slot;
+}
+
+// Index dans la partition du secteur de séquence seq (secteurs consécutifs en boucle)
+static uint32_t sector_of_seq(uint32_t seq)
+{
+    uint32_t back = (raw_state.head_seq - seq) % sector_count;
+    return (raw_state.head_sector + sector_count - back) % sector_count;
+}
+
+static size_t sector_offset(uint32_t sector)
+{
+    return (size_t)sector * RAW_SECTOR_SIZE;
+}
+
+static size_t slot_offset(uint32_t sector, uint32_t slot)
+{
+    return sector_offset(sector) + RAW_HEADER_SIZE + (size_t)slot * sizeof(chiro_record_t);
+}
+
+static bool read_sector_header(uint32_t sector, raw_sector_header_t *header)
+{
+    if (esp_partition_read(partition, sector_offset(sector), header, sizeof(*header)) != ESP_OK) {
+        return false;
+    }
+    return raw_sector_header_valid(header);
+}
+
+static bool slot_is_erased(const chiro_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    for (size_t i = 0; i < sizeof(*record); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Effacer et préparer le secteur suivant de l'anneau
+static esp_err_t open_next_sector(void)
+{
+    uint32_t target = (raw_state.head_sector + 1) % sector_count;
+    uint32_t pending = head_pos() - raw_state.tail_pos;
+
+    if (pending > 0 && target == sector_of_seq(raw_state.tail_pos / RAW_SLOTS_PER_SECTOR)) {
+        // Ne jamais écraser des mesures non flushées
+        LOG_EVENT(TAG, FLASH_RING_FULL, pending, 0);
+        return ESP_ERR_NO_MEM;
+    }
+
+    raw_sector_header_t header;
+    uint32_t erase_count = read_sector_header(target, &header) ? header.erase_count + 1 : 1;
+
+    esp_err_t ret = esp_partition_erase_range(partition, sector_offset(target), RAW_SECTOR_SIZE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    wake_metrics.flash_erases++;
+    if (erase_count > raw_state.erase_max) {
+        raw_state.erase_max = erase_count;
+    }
+
+    memset(&header, 0xFF, sizeof(header));
+    header.magic = RAW_SECTOR_MAGIC;
+    header.seq = raw_state.head_seq + 1;
+    header.erase_count = erase_count;
+    header.crc = record_crc16(&header, offsetof(raw_sector_header_t, crc));
+    header.schema_inv = (uint16_t)~RECORD_SCHEMA_ID;
+
+    ret = esp_partition_write(partition, sector_offset(target), &header, offsetof(raw_sector_header_t, consumed_mask));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    wake_metrics.flash_bytes += offsetof(raw_sector_header_t, consumed_mask);
+
+    raw_state.head_sector = target;
+    raw_state.head_seq = header.seq;
+    raw_state.head_slot = 0;
+    if (pending == 0) {
+        raw_state.tail_pos = head_pos();
+    }
+    return ESP_OK;
+}
+
+// Reconstruction de la tête et de la queue depuis la flash après une perte d'alimentation
+static void recover_raw_state(void)
+{
+    LOG_DEBUG(TAG, "🔍 Reconstruction du journal circulaire (perte d'alimentation)");
+
+    raw_sector_header_t header;
+    bool found = false;
+    uint32_t head_sector = 0, head_seq = 0, erase_max = 0;
+
+    for (uint32_t sector = 0; sector < sector_count; sector++) {
+        if (!read_sector_header(sector, &header)) {
+            continue;
+        }
+        if (header.erase_count > erase_max) {
+            erase_max = header.erase_count;
+        }
+        if (!found || header.seq > head_seq) {
+            found = true;
+            head_sector = sector;
+            head_seq = header.seq;
+        }
+    }
+
+    raw_state.erase_max = erase_max;
+    raw_state_reset();
+    if (!found) {
+        LOG_DEBUG(TAG, "✅ Journal vierge");
+        return;
+    }
+
+    // Tête : emplacement qui suit le dernier enregistrement écrit du secteur le plus récent
+    raw_state.head_sector = head_sector;
+    raw_state.head_seq = head_seq;
+    raw_state.head_slot = 0;
+
+    chiro_record_t records[FLUSH_READ_CHUNK];
+    for (uint32_t slot = 0; slot < RAW_SLOTS_PER_SECTOR; slot += FLUSH_READ_CHUNK) {
+        uint32_t n = RAW_SLOTS_PER_SECTOR - slot;
+        if (n > FLUSH_READ_CHUNK) {
+            n = FLUSH_READ_CHUNK;
+        }
+        if (esp_partition_read(partition, slot_offset(head_sector, slot), records, n * sizeof(chiro_record_t)) != ESP_OK) {
+            break;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (!slot_is_erased(&records[i])) {
+                raw_state.head_slot = slot + i + 1;
+            }
+        }
+    }
+
+    // Queue : remonter les secteurs consécutifs puis prendre le premier non entièrement flushé
+    uint32_t oldest_seq = head_seq;
+    while (head_seq - oldest_seq + 1 < sector_count && oldest_seq > 1 &&
+           read_sector_header(sector_of_seq(oldest_seq - 1), &header) && header.seq == oldest_seq - 1) {
+        oldest_seq--;
+    }
+
+    raw_state.tail_pos = head_pos();
+    for (uint32_t seq = oldest_seq; seq <= head_seq; seq++) {
+        if (!read_sector_header(sector_of_seq(seq), &header)) {
+            continue;
+        }
+        if (header.consumed_mask != 0) {
+            uint32_t slot = (uint32_t)__builtin_ctz(header.consumed_mask) * RAW_CONSUME_GRANULE;
+            uint32_t pos = seq * RAW_SLOTS_PER_SECTOR + slot;
+            if (pos < raw_state.tail_pos) {
+                raw_state.tail_pos = pos;
+            }
+            break;
+        }
+    }
+
+    raw_state_commit();
+    LOG_EVENT(TAG, FLASH_RECOVERED, head_pos() - raw_state.tail_pos, 0);
+}
+
+static esp_err_t raw_init(void)
+{
+    if (partition == NULL) {
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                             BUFFER_PARTITION_LABEL);
+        if (partition == NULL) {
+            LOG_ESSENTIAL(TAG, "❌ Partition '%s' introuvable", BUFFER_PARTITION_LABEL);
+            return ESP_ERR_NOT_FOUND;
+        }
+        sector_count = partition->size / RAW_SECTOR_SIZE;
+    }
+
+    // Après un deep sleep l'état RTC est à jour : aucune lecture de la flash
+    if (!raw_state_is_valid()) {
+        recover_raw_state();
+    }
+    return ESP_OK;
+}
+
+static esp_err_t raw_append(const chiro_record_t *records, size_t count)
+{
+    while (count > 0) {
+        if (raw_state.head_slot >= RAW_SLOTS_PER_SECTOR) {
+            raw_state.magic = 0;
+            esp_err_t ret = open_next_sector();
+            raw_state_commit();
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+
+        // Écriture contiguë dans le secteur de tête
+        size_t n = RAW_SLOTS_PER_SECTOR - raw_state.head_slot;
+        if (n > count) {
+            n = count;
+        }
+
+        raw_state.magic = 0;
+        esp_err_t ret = esp_partition_write(partition, slot_offset(raw_state.head_sector, raw_state.head_slot),
+                                            records, n * sizeof(chiro_record_t));
+        if (ret != ESP_OK) {
+            // État laissé invalide : reconstruction depuis la flash au prochain réveil
+            LOG_ESSENTIAL(TAG, "❌ Échec écriture partition: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        raw_state.head_slot += n;
+        raw_state_commit();
+        wake_metrics.flash_bytes += n * sizeof(chiro_record_t);
+
+        records += n;
+        count -= n;
+    }
+    return ESP_OK;
+}
+
+static uint32_t raw_count(void)
+{
+    return head_pos() - raw_state.tail_pos;
+}
+
+static esp_err_t raw_read(uint32_t first, chiro_record_t *out, size_t max, size_t *read_count)
+{
+    *read_count = 0;
+
+    uint32_t pending = raw_count();
+    if (first >= pending) {
+        return ESP_OK;
+    }
+
+    // Lecture contiguë limitée au secteur courant (l'appelant boucle)
+    uint32_t pos = raw_state.tail_pos + first;
+    uint32_t slot = pos % RAW_SLOTS_PER_SECTOR;
+    size_t n = RAW_SLOTS_PER_SECTOR - slot;
+    if (n > max) {
+        n = max;
+    }
+    if (n > pending - first) {
+        n = pending - first;
+    }
+
+    esp_err_t ret = esp_partition_read(partition, slot_offset(sector_of_seq(pos / RAW_SLOTS_PER_SECTOR), slot),
+                                       out, n * sizeof(chiro_record_t));
+    if (ret == ESP_OK) {
+        *read_count = n;
+    }
+    return ret;
+}
+
+static esp_err_t raw_consume(uint32_t count)
+{
+    uint32_t pending = raw_count();
+    if (count > pending) {
+        count = pending;
+    }
+
+    uint32_t new_tail = raw_state.tail_pos + count;
+    uint32_t last_seq = new_tail / RAW_SLOTS_PER_SECTOR;
+    if (last_seq > raw_state.head_seq) {
+        last_seq = raw_state.head_seq;
+    }
+
+    // Programmer les masques de consommation (bits 1 -> 0 uniquement, pas d'effacement)
+    for (uint32_t seq = raw_state.tail_pos / RAW_SLOTS_PER_SECTOR; seq <= last_seq; seq++) {
+        uint32_t mask = 0;
+        if (seq == new_tail / RAW_SLOTS_PER_SECTOR) {
+            uint32_t granules = (new_tail % RAW_SLOTS_PER_SECTOR) / RAW_CONSUME_GRANULE;
+            mask = granules >= 32 ? 0 : (0xFFFFFFFFu << granules);
+            if (mask == 0xFFFFFFFFu) {
+                continue; // Moins d'un granule consommé : rien à programmer
+            }
+        }
+        uint32_t sector = sector_of_seq(seq);
+        esp_err_t ret = esp_partition_write(partition, sector_offset(sector) + offsetof(raw_sector_header_t, consumed_mask),
+                                            &mask, sizeof(mask));
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        wake_metrics.flash_bytes += sizeof(mask);
+    }
+
+    raw_state.tail_pos = new_tail;
+    raw_state_commit();
+    return ESP_OK;
+}
+
+static esp_err_t raw_usage(buffer_usage_t *usage)
+{
+    // Secteurs de la queue à la tête : ceux qu'un ajout ne peut pas réutiliser
+    uint32_t pending = raw_count();
+    uint32_t used_sectors = pending > 0 ? raw_state.head_seq - raw_state.tail_pos / RAW_SLOTS_PER_SECTOR + 1 : 0;
+    usage->total_bytes = sector_count * RAW_SECTOR_SIZE;
+    usage->used_bytes = used_sectors * RAW_SECTOR_SIZE;
+    usage->sectors = sector_count;
+    usage->erase_max = raw_state.erase_max;
+    usage->erases_counted = true;
+    return ESP_OK;
+}
+
+const buffer_backend_t buffer_backend_raw = {
+    .name = "raw",
+    .init = raw_init,
+    .append = raw_append,
+    .count = raw_count,
+    .read = raw_read,
+    .consume = raw_consume,
+    .usage = raw_usage,
+};
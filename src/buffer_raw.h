@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "record.h"
+
+/*
+ * 🗄️ ORGANISATION DE LA PARTITION BRUTE
+ *
+ * Format sur flash du backend BUFFER_BACKEND_RAW (voir buffer_raw.c), partagé
+ * avec les outils qui relisent une image de la partition (host/chiro_export).
+ * Un emplacement effacé (tout à 0xFF) marque la fin des écritures du secteur.
+ * Les secteurs écrits avec d'autres canaux (record_schema.h) sont ignorés.
+ */
+
+#define RAW_SECTOR_SIZE      4096
+#define RAW_SECTOR_MAGIC     0x53524843u  // "CHRS"
+#define RAW_HEADER_SIZE      32
+#define RAW_SLOTS_PER_SECTOR ((RAW_SECTOR_SIZE - RAW_HEADER_SIZE) / sizeof(chiro_record_t))
+#define RAW_CONSUME_GRANULE  8
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;          // RAW_SECTOR_MAGIC
+    uint32_t seq;            // Séquence croissante d'ouverture du secteur (>= 1)
+    uint32_t erase_count;    // Nombre d'effacements subis par ce secteur
+    uint16_t crc;            // CRC-16 des 12 octets précédents
+    uint16_t schema_inv;     // ~RECORD_SCHEMA_ID : 0xFFFF (effacé) pour les canaux historiques
+    uint32_t consumed_mask;  // Bit k à 0 : emplacements [8k, 8k+8) flushés
+    uint32_t unused[3];      // Laissé effacé (0xFF)
+} raw_sector_header_t;
+
+// Secteur formaté pour les canaux de ce firmware
+static inline bool raw_sector_header_valid(const raw_sector_header_t *header)
+{
+    uint16_t schema_inv = (uint16_t)~RECORD_SCHEMA_ID;
+    return header->magic == RAW_SECTOR_MAGIC &&
+           header->crc == record_crc16(header, offsetof(raw_sector_header_t, crc)) && header->schema_inv == schema_inv;
+}
+
+_Static_assert(sizeof(raw_sector_header_t) == RAW_HEADER_SIZE, "en-tête de secteur: 32 octets attendus");
+_Static_assert(RAW_SLOTS_PER_SECTOR <= 32 * RAW_CONSUME_GRANULE, "masque de consommation trop petit");
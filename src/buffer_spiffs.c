@@ -0,0 +1,618 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <esp_attr.h>
+#include <esp_spiffs.h>
+#include <esp_partition.h>
+
+#include "buffer_backend.h"
+#include "record_codec.h"
+#include "metrics.h"
+#include "event_log.h"
+
+/*
+ * 🗄️ BACKEND SPIFFS
+ *
+ * Journal binaire BUFFER_LOG_FILE sur la partition SPIFFS : en-tête versionné
+ * (record.h) suivi de blocs compressés, un ou plusieurs par lot RTC
+ * (record_codec.h). Le champ consumed de l'en-tête mémorise les
+ * enregistrements déjà flushés tant que le fichier n'a pas été supprimé.
+ *
+ * Un journal version 1 (enregistrements de taille fixe) laissé par un ancien
+ * firmware est complété dans son format jusqu'au flush qui le supprime.
+ *
+ * Un bloc abîmé au milieu du journal ne coûte que ses enregistrements :
+ * - en-tête cohérent mais CRC faux, bloc suivant (ou fin) à sa place : le
+ *   bloc garde ses rangs, ses enregistrements sont comptés comme corrompus ;
+ * - en-tête illisible : lecture et reconstruction reprennent au prochain
+ *   RECORD_BLOCK_MAGIC dont le bloc est valide (FLASH_BLOCKS_SKIPPED).
+ * Seule une fin de journal illisible est tronquée.
+ */
+
+static const char *TAG = "CHIRO_SPIFFS";
+
+// État du tampon flash conservé en RTC memory : évite de relire le journal à chaque réveil
+#define BUFFER_STATE_MAGIC 0x42554653u  // "SFUB"
+
+typedef struct {
+    uint32_t magic;         // BUFFER_STATE_MAGIC si l'état est cohérent avec le journal
+    uint32_t record_count;  // Enregistrements présents dans le journal
+    uint32_t consumed;      // Enregistrements déjà flushés (copie de l'en-tête)
+    uint32_t write_offset;  // Taille du journal en octets (0 = journal absent)
+    uint32_t version;       // Version de l'en-tête du journal (RECORD_LOG_VERSION*)
+    uint32_t skipped_end;   // Fin du dernier passage illisible déjà décompté (0 : aucun)
+    uint32_t check;         // Contrôle simple des champs précédents
+} buffer_state_t;
+
+RTC_DATA_ATTR static buffer_state_t buffer_state;
+
+// Fichier ouvert en lecture pendant un flush (fermé à la prochaine écriture)
+static FILE *reader = NULL;
+static uint16_t reader_version = 0;
+
+// Bloc compressé en cours d'écriture ou de lecture, et ses enregistrements décodés
+static uint8_t block_buffer[RECORD_BLOCK_MAX_SIZE];
+static chiro_record_t block_records[RECORD_BLOCK_MAX_RECORDS];
+static uint32_t block_first = 0;  // Rang dans le journal du premier enregistrement décodé
+static uint32_t block_count = 0;  // Enregistrements décodés dans block_records
+
+static uint32_t buffer_state_checksum(const buffer_state_t *state)
+{
+    return state->magic ^ (state->record_count * 2654435761u) ^
+           (state->consumed * 40503u) ^ ~state->write_offset ^ (state->version << 24) ^
+           (state->skipped_end * 2246822519u);
+}
+
+static bool buffer_state_is_valid(void)
+{
+    return buffer_state.magic == BUFFER_STATE_MAGIC &&
+           buffer_state.check == buffer_state_checksum(&buffer_state);
+}
+
+static void buffer_state_set(uint32_t record_count, uint32_t consumed, uint32_t write_offset, uint32_t version)
+{
+    buffer_state.magic = BUFFER_STATE_MAGIC;
+    buffer_state.record_count = record_count;
+    buffer_state.consumed = consumed;
+    buffer_state.write_offset = write_offset;
+    buffer_state.version = version;
+    if (write_offset == 0) {
+        buffer_state.skipped_end = 0;
+    }
+    buffer_state.check = buffer_state_checksum(&buffer_state);
+}
+
+// Marquer l'état comme douteux pendant une écriture : un reset logiciel au milieu
+// (watchdog, panic) forcera la reconstruction au prochain démarrage
+static void buffer_state_invalidate(void)
+{
+    buffer_state.magic = 0;
+}
+
+static void close_reader(void)
+{
+    if (reader != NULL) {
+        fclose(reader);
+        reader = NULL;
+    }
+    block_first = 0;
+    block_count = 0;
+}
+
+// Parcours d'un journal version 1 : une écriture interrompue ne peut laisser
+// qu'une fin de journal invalide, les erreurs au milieu sont gardées pour le flush
+static void scan_fixed_records(FILE *file, uint32_t *valid_end, uint32_t *valid_size)
+{
+    chiro_record_t records[FLUSH_READ_CHUNK];
+    uint32_t scanned = 0;
+    size_t count;
+
+    while ((count = fread(records, sizeof(chiro_record_t), FLUSH_READ_CHUNK, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            scanned++;
+            if (record_is_valid(&records[i])) {
+                *valid_end = scanned;
+            }
+        }
+    }
+    *valid_size = sizeof(record_log_header_t) + *valid_end * sizeof(chiro_record_t);
+}
+
+typedef enum {
+    BLOCK_END,        // Fin du journal, ou fin illisible
+    BLOCK_VALID,      // Bloc décodé dans block_records
+    BLOCK_CORRUPTED,  // En-tête cohérent, CRC faux : header.count enregistrements perdus, rangs conservés
+} block_status_t;
+
+// Bloc complet et décodable à offset (enregistrements dans block_records), fichier placé après
+static bool read_block_at(FILE *file, long offset, record_block_header_t *header)
+{
+    uint8_t *payload = block_buffer + sizeof(*header);
+    return fseek(file, offset, SEEK_SET) == 0 && fread(header, sizeof(*header), 1, file) == 1 &&
+           record_block_header_check(header) &&
+           fread(payload, 1, header->payload_size, file) == header->payload_size &&
+           record_block_decode(header, payload, block_records);
+}
+
+// Premier bloc valide à partir de from (-1 : aucun jusqu'à la fin du journal)
+static long find_next_block(FILE *file, long from, record_block_header_t *header)
+{
+    uint8_t window[256];
+    for (long base = from;;) {
+        if (fseek(file, base, SEEK_SET) != 0) {
+            return -1;
+        }
+        size_t n = fread(window, 1, sizeof(window), file);
+        if (n < sizeof(*header)) {
+            return -1;
+        }
+        for (size_t i = 0; i + 1 < n; i++) {
+            if (window[i] == (RECORD_BLOCK_MAGIC & 0xFF) && window[i + 1] == (RECORD_BLOCK_MAGIC >> 8) &&
+                read_block_at(file, base + (long)i, header)) {
+                return base + (long)i;
+            }
+        }
+        base += (long)n - 1;  // Un magic peut chevaucher deux fenêtres
+    }
+}
+
+// Bloc suivant depuis la position courante. Après un en-tête illisible, les
+// octets jusqu'au prochain bloc valide sont sautés : *skipped octets à *skipped_at
+static block_status_t next_block(FILE *file, record_block_header_t *header, long *skipped_at, long *skipped)
+{
+    *skipped = 0;
+    long offset = ftell(file);
+    if (offset < 0) {
+        return BLOCK_END;
+    }
+    if (read_block_at(file, offset, header)) {
+        return BLOCK_VALID;
+    }
+    if (fseek(file, 0, SEEK_END) != 0 || offset >= ftell(file)) {
+        return BLOCK_END;
+    }
+    long size = ftell(file);
+
+    // CRC faux derrière un en-tête plausible : le chaînage confirme la taille du bloc
+    if (record_block_header_check(header)) {
+        long next = offset + (long)sizeof(*header) + header->payload_size;
+        record_block_header_t following;
+        if (next == size || (next < size && read_block_at(file, next, &following))) {
+            fseek(file, next, SEEK_SET);
+            return BLOCK_CORRUPTED;
+        }
+    }
+
+    long found = find_next_block(file, offset + 1, header);
+    if (found < 0) {
+        return BLOCK_END;  // Fin illisible (écriture interrompue) : tronquée à la reconstruction
+    }
+    *skipped_at = offset;
+    *skipped = found - offset;
+    return BLOCK_VALID;
+}
+
+// Parcours d'un journal de blocs : un bloc au CRC faux ou un passage illisible
+// suivis d'un bloc valide sont gardés, seule la fin illisible est retirée
+static void scan_blocks(FILE *file, uint32_t *valid_end, uint32_t *valid_size)
+{
+    record_block_header_t header;
+    uint32_t scanned = 0;
+    long skipped_at, skipped;
+    block_status_t status;
+
+    *valid_size = sizeof(record_log_header_t);
+    while ((status = next_block(file, &header, &skipped_at, &skipped)) != BLOCK_END) {
+        if (skipped > 0) {
+            LOG_EVENT(TAG, FLASH_BLOCKS_SKIPPED, skipped, skipped_at);
+            buffer_state.skipped_end = (uint32_t)(skipped_at + skipped);
+        }
+        scanned += header.count;
+        if (status == BLOCK_VALID) {
+            *valid_end = scanned;
+            *valid_size = (uint32_t)ftell(file);
+        }
+    }
+}
+
+// Reconstruction de l'état après une perte d'alimentation (RTC memory effacée) :
+// seul cas où le journal est relu en entier
+static void recover_buffer_state(void)
+{
+    LOG_DEBUG(TAG, "🔍 Reconstruction de l'état du tampon (perte d'alimentation)");
+    close_reader();
+    buffer_state.skipped_end = 0;
+
+    FILE *file = fopen(BUFFER_LOG_FILE, "rb");
+    if (file == NULL) {
+        buffer_state_set(0, 0, 0, RECORD_LOG_VERSION);
+        return;
+    }
+
+    record_log_header_t header;
+    if (fread(&header, sizeof(header), 1, file) != 1) {
+        // En-tête incomplet : coupure pendant la création, rien d'exploitable
+        fclose(file);
+        remove(BUFFER_LOG_FILE);
+        LOG_ESSENTIAL(TAG, "🧹 Tampon vide tronqué supprimé");
+        buffer_state_set(0, 0, 0, RECORD_LOG_VERSION);
+        return;
+    }
+
+    if (!record_log_header_check(&header)) {
+        // Version inconnue : ne rien toucher, le flush conservera le fichier
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fclose(file);
+        buffer_state_set((uint32_t)((size - sizeof(header)) / sizeof(chiro_record_t)), 0, (uint32_t)size,
+                         header.version);
+        return;
+    }
+
+    uint32_t valid_end = 0;
+    uint32_t valid_size = 0;
+    if (header.version == RECORD_LOG_VERSION_FIXED) {
+        scan_fixed_records(file, &valid_end, &valid_size);
+    } else {
+        scan_blocks(file, &valid_end, &valid_size);
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    if ((uint32_t)size != valid_size) {
+        LOG_EVENT(TAG, FLASH_TRIMMED, size, valid_size);
+        if (truncate(BUFFER_LOG_FILE, valid_size) != 0) {
+            LOG_ESSENTIAL(TAG, "⚠️  Troncature impossible, enregistrements invalides ignorés au flush");
+            valid_size = (uint32_t)size;
+            if (header.version == RECORD_LOG_VERSION_FIXED) {
+                valid_end = (uint32_t)((size - sizeof(header)) / sizeof(chiro_record_t));
+            }
+        }
+    }
+
+    uint32_t consumed = header.consumed <= valid_end ? header.consumed : valid_end;
+    buffer_state_set(valid_end, consumed, valid_size, header.version);
+    LOG_EVENT(TAG, FLASH_RECOVERED, valid_end - consumed, 0);
+}
+
+// Lecture d'un champ numérique de l'ancien CSV ("N/A" = mesure absente)
+static bool parse_legacy_value(const char *field, float *value)
+{
+    if (field == NULL || strncmp(field, "N/A", 3) == 0) {
+        return false;
+    }
+    *value = strtof(field, NULL);
+    return true;
+}
+
+// Conversion unique de l'ancien tampon texte (firmware 1.0.x) en enregistrements binaires
+static void migrate_legacy_buffer(void)
+{
+    FILE *legacy_file = fopen(BUFFER_LEGACY_CSV_FILE, "r");
+    if (legacy_file == NULL) {
+        return;
+    }
+
+    LOG_ESSENTIAL(TAG, "📄 Conversion de l'ancien tampon CSV au format binaire");
+
+    char line[256];
+    chiro_record_t records[FLUSH_READ_CHUNK];
+    size_t pending = 0;
+    int converted = 0;
+    bool ok = true;
+    bool first_line = true;
+
+    while (ok && fgets(line, sizeof(line), legacy_file)) {
+        if (first_line) {
+            first_line = false;
+            continue; // Ignorer l'en-tête
+        }
+
+        char *fields[4] = {0};
+        char *cursor = line;
+        for (int i = 0; i < 4 && cursor != NULL; i++) {
+            fields[i] = cursor;
+            cursor = strchr(cursor, ',');
+            if (cursor != NULL) {
+                *cursor++ = '\0';
+            }
+        }
+        if (fields[1] == NULL) {
+            continue; // Ligne incomplète
+        }
+
+        // Ancien tampon : température et humidité seulement
+        record_values_t values = {0};
+        if (parse_legacy_value(fields[2], &values.temperature)) {
+            values.present |= RECORD_VALUE_BIT(temperature);
+        }
+        if (parse_legacy_value(fields[3], &values.humidity)) {
+            values.present |= RECORD_VALUE_BIT(humidity);
+        }
+        record_make(&records[pending++], (uint32_t)strtoul(fields[0], NULL, 10),
+                    (uint32_t)strtoul(fields[1], NULL, 10), &values, 0);
+        converted++;
+
+        if (pending == FLUSH_READ_CHUNK) {
+            ok = buffer_backend_spiffs.append(records, pending) == ESP_OK;
+            pending = 0;
+        }
+    }
+    fclose(legacy_file);
+
+    if (ok && pending > 0) {
+        ok = buffer_backend_spiffs.append(records, pending) == ESP_OK;
+    }
+
+    if (ok) {
+        remove(BUFFER_LEGACY_CSV_FILE);
+        LOG_ESSENTIAL(TAG, "✅ %d mesures converties", converted);
+    } else {
+        LOG_ESSENTIAL(TAG, "⚠️  Conversion interrompue, ancien tampon conservé");
+    }
+}
+
+static esp_err_t spiffs_init(void)
+{
+    LOG_DEBUG(TAG, "🔋 Initialisation du tampon flash énergétique...");
+
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = BUFFER_MOUNT_POINT,
+        .partition_label = BUFFER_PARTITION_LABEL,
+        .max_files = 5,
+        .format_if_mount_failed = true
+    };
+
+    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    if (ret != ESP_OK) {
+        if (ret == ESP_FAIL) {
+            LOG_ESSENTIAL(TAG, "❌ Impossible de monter la partition SPIFFS");
+        } else if (ret == ESP_ERR_NOT_FOUND) {
+            LOG_ESSENTIAL(TAG, "❌ Partition '%s' introuvable", BUFFER_PARTITION_LABEL);
+        } else {
+            LOG_ESSENTIAL(TAG, "❌ Erreur montage SPIFFS: %s", esp_err_to_name(ret));
+        }
+        return ret;
+    }
+
+    LOG_DEBUG(TAG, "✅ Tampon flash monté sur %s", BUFFER_MOUNT_POINT);
+
+    // Vérifier l'espace disponible
+    size_t total = 0, used = 0;
+    ret = esp_spiffs_info(BUFFER_PARTITION_LABEL, &total, &used);
+    if (ret == ESP_OK) {
+        LOG_DEBUG(TAG, "📊 Espace tampon: %zu Ko utilisés / %zu Ko total",
+                used / 1024, total / 1024);
+    }
+
+    // Après un deep sleep l'état RTC est à jour : pas de lecture du journal
+    if (!buffer_state_is_valid()) {
+        recover_buffer_state();
+        migrate_legacy_buffer();
+    }
+
+    return ESP_OK;
+}
+
+// Écrire des enregistrements en blocs compressés, retourne le nombre d'enregistrements codés
+static size_t write_blocks(const chiro_record_t *records, size_t count, FILE *file, uint32_t *bytes, bool *write_ok)
+{
+    size_t appended = 0;
+
+    while (count > 0 && *write_ok) {
+        size_t used = 0;
+        size_t encoded = 0;
+        size_t size = record_block_encode(records, count, block_buffer, &used, &encoded);
+        if (size > 0) {
+            *write_ok = fwrite(block_buffer, 1, size, file) == size;
+            *bytes += size;
+        }
+        appended += encoded;
+        records += used;
+        count -= used;
+    }
+    return appended;
+}
+
+static esp_err_t spiffs_append(const chiro_record_t *records, size_t count)
+{
+    close_reader();
+
+    FILE *file = fopen(BUFFER_LOG_FILE, "ab");
+    if (file == NULL) {
+        LOG_ESSENTIAL(TAG, "❌ Impossible d'ouvrir le tampon: %s", BUFFER_LOG_FILE);
+        return ESP_FAIL;
+    }
+
+    uint32_t record_count = buffer_state.record_count;
+    uint32_t consumed = buffer_state.consumed;
+    uint32_t write_offset = buffer_state.write_offset;
+    uint32_t version = buffer_state.version;
+    buffer_state_invalidate();
+
+    // Tampon vide : écrire l'en-tête versionné avant le premier enregistrement
+    bool write_ok = true;
+    uint32_t bytes = 0;
+    if (write_offset == 0) {
+        LOG_DEBUG(TAG, "📄 Création du tampon binaire avec en-tête");
+        record_log_header_t header;
+        record_log_header_init(&header);
+        write_ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        bytes = sizeof(header);
+        version = header.version;
+    }
+
+    size_t appended = 0;
+    if (version == RECORD_LOG_VERSION) {
+        appended = write_blocks(records, count, file, &bytes, &write_ok);
+    } else if (write_ok) {
+        write_ok = fwrite(records, sizeof(chiro_record_t), count, file) == count;
+        bytes += count * sizeof(chiro_record_t);
+        appended = count;
+    }
+
+    if (fclose(file) != 0 || !write_ok) {
+        // État laissé invalide : il sera reconstruit depuis le journal au prochain réveil
+        LOG_ESSENTIAL(TAG, "❌ Échec écriture dans le tampon: %s", BUFFER_LOG_FILE);
+        return ESP_FAIL;
+    }
+
+    wake_metrics.flash_bytes += bytes;
+    buffer_state_set(record_count + appended, consumed, write_offset + bytes, version);
+    return ESP_OK;
+}
+
+static uint32_t spiffs_count(void)
+{
+    // Compte tenu à jour en RTC memory : coût constant quel que soit le remplissage
+    if (!buffer_state_is_valid()) {
+        recover_buffer_state();
+    }
+    return buffer_state.record_count - buffer_state.consumed;
+}
+
+// Lecture dans un journal de blocs : les blocs sont décodés un à un en avançant
+// dans le fichier, le flush lisant les enregistrements dans l'ordre
+static esp_err_t read_blocks(uint32_t pos, chiro_record_t *out, size_t max, size_t *read_count)
+{
+    if (pos < block_first) {
+        if (fseek(reader, sizeof(record_log_header_t), SEEK_SET) != 0) {
+            return ESP_FAIL;
+        }
+        block_first = 0;
+        block_count = 0;
+    }
+
+    record_block_header_t header;
+
+    while (pos >= block_first + block_count) {
+        block_first += block_count;
+        block_count = 0;
+
+        long skipped_at, skipped;
+        block_status_t status = next_block(reader, &header, &skipped_at, &skipped);
+        if (status == BLOCK_END) {
+            return ESP_OK; // Fin du journal
+        }
+        if (skipped > 0 && (uint32_t)(skipped_at + skipped) > buffer_state.skipped_end) {
+            // Passage illisible apparu depuis la dernière reconstruction : ses enregistrements
+            // manquent au compte, l'état sera reconstruit au retrait des mesures flushées
+            buffer_state_invalidate();
+        }
+        if (status == BLOCK_CORRUPTED) {
+            // CRC du bloc faux : rendre des enregistrements invalides, comptés comme corrompus au flush
+            memset(block_records, 0, header.count * sizeof(chiro_record_t));
+            for (int i = 0; i < header.count; i++) {
+                block_records[i].crc = (uint16_t)~record_crc16(&block_records[i], offsetof(chiro_record_t, crc));
+            }
+        }
+        block_count = header.count;
+    }
+
+    size_t n = block_first + block_count - pos;
+    if (n > max) {
+        n = max;
+    }
+    memcpy(out, &block_records[pos - block_first], n * sizeof(chiro_record_t));
+    *read_count = n;
+    return ESP_OK;
+}
+
+static esp_err_t spiffs_read(uint32_t first, chiro_record_t *out, size_t max, size_t *read_count)
+{
+    *read_count = 0;
+
+    if (reader == NULL) {
+        reader = fopen(BUFFER_LOG_FILE, "rb");
+        if (reader == NULL) {
+            return ESP_ERR_NOT_FOUND;
+        }
+
+        record_log_header_t header;
+        if (fread(&header, sizeof(header), 1, reader) != 1 || !record_log_header_check(&header)) {
+            ESP_LOGE(TAG, "❌ En-tête du tampon invalide ou version inconnue");
+            close_reader();
+            return ESP_ERR_INVALID_VERSION;
+        }
+        reader_version = header.version;
+    }
+
+    if (reader_version == RECORD_LOG_VERSION) {
+        return read_blocks(buffer_state.consumed + first, out, max, read_count);
+    }
+
+    long offset = sizeof(record_log_header_t) + (long)(buffer_state.consumed + first) * sizeof(chiro_record_t);
+    if (fseek(reader, offset, SEEK_SET) != 0) {
+        return ESP_FAIL;
+    }
+
+    *read_count = fread(out, sizeof(chiro_record_t), max, reader);
+    return ESP_OK;
+}
+
+static esp_err_t spiffs_consume(uint32_t count)
+{
+    close_reader();
+
+    uint32_t pending = spiffs_count();
+    if (count >= pending) {
+        // Tout a été flushé : supprimer le journal
+        if (remove(BUFFER_LOG_FILE) != 0) {
+            ESP_LOGW(TAG, "⚠️  Impossible de vider le tampon");
+            return ESP_FAIL;
+        }
+        buffer_state_set(0, 0, 0, RECORD_LOG_VERSION);
+        return ESP_OK;
+    }
+
+    // Flush partiel : mémoriser la progression dans l'en-tête du journal (dans sa version)
+    FILE *file = fopen(BUFFER_LOG_FILE, "r+b");
+    if (file == NULL) {
+        return ESP_FAIL;
+    }
+
+    record_log_header_t header;
+    record_log_header_init(&header);
+    header.version = (uint16_t)buffer_state.version;
+    header.consumed = buffer_state.consumed + count;
+
+    bool write_ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (fclose(file) != 0 || !write_ok) {
+        return ESP_FAIL;
+    }
+    wake_metrics.flash_bytes += sizeof(header);
+
+    buffer_state_set(buffer_state.record_count, header.consumed, buffer_state.write_offset, buffer_state.version);
+    return ESP_OK;
+}
+
+static esp_err_t spiffs_usage(buffer_usage_t *usage)
+{
+    size_t total = 0, used = 0;
+    esp_err_t ret = esp_spiffs_info(BUFFER_PARTITION_LABEL, &total, &used);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // Usure répartie par SPIFFS sur toute la partition, effacements non observables
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                                BUFFER_PARTITION_LABEL);
+    usage->total_bytes = (uint32_t)total;
+    usage->used_bytes = (uint32_t)used;
+    usage->sectors = partition != NULL ? partition->size / partition->erase_size : (uint32_t)(total / 4096);
+    usage->erase_max = 0;
+    usage->erases_counted = false;
+    return ESP_OK;
+}
+
+const buffer_backend_t buffer_backend_spiffs = {
+    .name = "spiffs",
+    .init = spiffs_init,
+    .append = spiffs_append,
+    .count = spiffs_count,
+    .read = spiffs_read,
+    .consume = spiffs_consume,
+    .usage = spiffs_usage,
+};
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <esp_log.h>
+
+/*
+ * ⚙️ CONFIGURATION COMMUNE DU CHIRO LOGGER
+ *
+ * Paramètres partagés par app_main() et les modules de stockage.
+ * Les valeurs protégées par #ifndef peuvent être redéfinies à la compilation
+ * (platformio.ini, ou host/CMakeLists.txt pour le simulateur).
+ */
+
+// Point de montage de la carte SD
+#ifndef MOUNT_POINT
+#define MOUNT_POINT "/sdcard"
+#endif
+
+// Point de montage du tampon flash (partition SPIFFS)
+#ifndef BUFFER_MOUNT_POINT
+#define BUFFER_MOUNT_POINT "/buffer"
+#endif
+
+// Partition du tampon flash (voir huge_app.csv)
+#define BUFFER_PARTITION_LABEL "data_buffer"
+
+// Configuration du deep sleep (en secondes, intervalle fixe si ADAPTIVE_SAMPLING vaut 0)
+#ifndef DEEP_SLEEP_DURATION_SEC
+#define DEEP_SLEEP_DURATION_SEC 5
+#endif
+
+/*
+ * 🕰️ ÉCHANTILLONNAGE ADAPTATIF (scheduler.h)
+ *
+ * L'intervalle entre deux mesures varie entre SAMPLE_INTERVAL_MIN_SEC et
+ * SAMPLE_INTERVAL_MAX_SEC selon la variation des mesures ; un écart de
+ * SAMPLE_CHANGE_* entre deux mesures ramène immédiatement à l'intervalle
+ * minimal. L'intervalle choisi est enregistré avec chaque mesure (colonne
+ * Interval_s du CSV).
+ */
+#ifndef ADAPTIVE_SAMPLING
+#define ADAPTIVE_SAMPLING 1
+#endif
+#ifndef SAMPLE_INTERVAL_MIN_SEC
+#define SAMPLE_INTERVAL_MIN_SEC DEEP_SLEEP_DURATION_SEC
+#endif
+#ifndef SAMPLE_INTERVAL_MAX_SEC
+#define SAMPLE_INTERVAL_MAX_SEC 300
+#endif
+#ifndef SAMPLE_CHANGE_TEMPERATURE
+#define SAMPLE_CHANGE_TEMPERATURE 0.05f  // °C
+#endif
+#ifndef SAMPLE_CHANGE_HUMIDITY
+#define SAMPLE_CHANGE_HUMIDITY 0.5f      // %
+#endif
+
+/*
+ * 🕰️ ID ET HEURE PERSISTANTS (timekeeper.h)
+ *
+ * Les ID sont réservés en NVS par blocs de TIME_ID_RESERVE (une écriture par
+ * bloc) ; l'heure avance de la durée de chaque deep sleep. Sans point de
+ * contrôle NVS, l'heure part de TIME_INITIAL_EPOCH (epoch UTC), ou de la date
+ * de compilation s'il vaut 0.
+ */
+#ifndef TIME_ID_RESERVE
+#define TIME_ID_RESERVE 1024
+#endif
+#ifndef TIME_INITIAL_EPOCH
+#define TIME_INITIAL_EPOCH 0
+#endif
+// Bootloader au réveil, avant le départ d'esp_timer (non compté par esp_timer_get_time)
+#ifndef TIME_BOOT_OFFSET_MS
+#define TIME_BOOT_OFFSET_MS BENCH_BOOT_MS
+#endif
+// Réveil traité par le wake stub : ROM de démarrage et stub, avant le retour en sommeil
+#ifndef TIME_STUB_OFFSET_US
+#define TIME_STUB_OFFSET_US BENCH_STUB_WAKE_US
+#endif
+
+/*
+ * ⚡ RÉVEIL RAPIDE, CAPTEUR SYNTHÉTIQUE SEULEMENT (wake_stub.h)
+ *
+ * Avec FAST_WAKE, les réveils ordinaires sont traités par un wake stub exécuté
+ * depuis la RTC fast memory, avant le bootloader : mesure, mise dans le lot
+ * RTC et retour en deep sleep, sans charger l'application. Démarrage complet
+ * seulement quand le lot doit être écrit en flash, qu'un flush est dû, que
+ * l'intervalle doit changer ou que le bloc d'ID réservés est épuisé.
+ *
+ * Le stub ne sait lire que le capteur synthétique : activé par défaut
+ * seulement sans pilote réel (SENSOR_SYNTHETIC_ONLY, voir 🌡️ CAPTEURS), absent
+ * des firmwares de production qui définissent SENSOR_DRIVERS.
+ */
+#ifndef FAST_WAKE
+#define FAST_WAKE SENSOR_SYNTHETIC_ONLY
+#endif
+
+/*
+ * 🛰️ MOTEUR D'ACQUISITION (ulp_sampler.h)
+ *
+ * - SAMPLING_ENGINE_CPU : chaque mesure réveille l'ESP32 (wake stub ou démarrage complet)
+ * - SAMPLING_ENGINE_ULP : le coprocesseur ULP lit les capteurs analogiques sur
+ *                         l'ADC1 pendant le deep sleep et accumule jusqu'à
+ *                         ULP_SAMPLE_CAPACITY mesures en RTC slow memory ; les
+ *                         cœurs ne démarrent que pour écrire le lot ou flusher
+ *
+ * Étalonnage : valeur = ULP_*_OFFSET + lecture ADC (0-4095) * ULP_*_PER_LSB.
+ * Défauts pour un TMP36 et un HIH-5030 alimentés en 3.3 V, atténuation 12 dB.
+ */
+#define SAMPLING_ENGINE_CPU 0
+#define SAMPLING_ENGINE_ULP 1
+
+#ifndef SAMPLING_ENGINE
+#define SAMPLING_ENGINE SAMPLING_ENGINE_CPU
+#endif
+#ifndef ULP_SAMPLE_CAPACITY
+#define ULP_SAMPLE_CAPACITY STAGING_BATCH_SIZE
+#endif
+#ifndef ULP_ADC_TEMPERATURE_CHANNEL
+#define ULP_ADC_TEMPERATURE_CHANNEL 6  // ADC1_CHANNEL_6, GPIO34
+#endif
+#ifndef ULP_ADC_HUMIDITY_CHANNEL
+#define ULP_ADC_HUMIDITY_CHANNEL 7     // ADC1_CHANNEL_7, GPIO35
+#endif
+#ifndef ULP_TEMPERATURE_PER_LSB
+#define ULP_TEMPERATURE_PER_LSB 0.0806f  // °C (10 mV/°C)
+#endif
+#ifndef ULP_TEMPERATURE_OFFSET
+#define ULP_TEMPERATURE_OFFSET -50.0f    // °C (500 mV à 0 °C)
+#endif
+#ifndef ULP_HUMIDITY_PER_LSB
+#define ULP_HUMIDITY_PER_LSB 0.0384f     // %
+#endif
+#ifndef ULP_HUMIDITY_OFFSET
+#define ULP_HUMIDITY_OFFSET -23.82f      // %
+#endif
+
+/*
+ * 🌡️ CAPTEURS (sensor.h)
+ *
+ * Pilotes interrogés pour chaque mesure des cœurs, dans l'ordre de la liste :
+ * chaque grandeur vient du premier pilote qui la fournit. Pilotes disponibles :
+ * &sensor_driver_synthetic, &sensor_driver_sht3x, &sensor_driver_sht4x,
+ * &sensor_driver_bme280. Depuis platformio.ini, par exemple :
+ *   -D'SENSOR_DRIVERS=&sensor_driver_sht4x,&sensor_driver_bme280'
+ *
+ * Le wake stub ne sait reproduire que le capteur synthétique : avec un capteur
+ * réel, chaque mesure passe par un démarrage complet et FAST_WAKE vaut 0.
+ * SENSOR_SYNTHETIC_ONLY vaut 1 seulement avec la liste par défaut.
+ */
+#ifndef SENSOR_DRIVERS
+#define SENSOR_DRIVERS &sensor_driver_synthetic
+#ifndef SENSOR_SYNTHETIC_ONLY
+#define SENSOR_SYNTHETIC_ONLY 1
+#endif
+#endif
+#ifndef SENSOR_SYNTHETIC_ONLY
+#define SENSOR_SYNTHETIC_ONLY 0
+#endif
+#define SENSOR_MAX_DRIVERS 4
+#ifndef SENSOR_I2C_PORT
+#define SENSOR_I2C_PORT 0
+#endif
+#ifndef SENSOR_I2C_SDA_GPIO
+#define SENSOR_I2C_SDA_GPIO 21
+#endif
+#ifndef SENSOR_I2C_SCL_GPIO
+#define SENSOR_I2C_SCL_GPIO 22
+#endif
+#ifndef SENSOR_I2C_SPEED_HZ
+#define SENSOR_I2C_SPEED_HZ 400000
+#endif
+#ifndef SENSOR_SHT3X_ADDRESS
+#define SENSOR_SHT3X_ADDRESS 0x44  // 0x45 avec ADDR à VDD
+#endif
+#ifndef SENSOR_SHT4X_ADDRESS
+#define SENSOR_SHT4X_ADDRESS 0x44
+#endif
+#ifndef SENSOR_BME280_ADDRESS
+#define SENSOR_BME280_ADDRESS 0x76  // 0x77 avec SDO à VDDIO
+#endif
+
+/*
+ * 📐 CANAUX ENREGISTRÉS (record_schema.h)
+ *
+ * Température et humidité toujours enregistrées, puis les canaux activés
+ * ci-dessous, dans cet ordre (colonnes CSV). Le tampon flash doit être
+ * flushé avant de changer de canaux : un tampon écrit avec d'autres canaux
+ * n'est pas relu (journal SPIFFS conservé tel quel, secteurs RAW réutilisés).
+ * Ex. -DCHIRO_DEFINITIONS="RECORD_PRESSURE=1"
+ */
+#ifndef RECORD_PRESSURE
+#define RECORD_PRESSURE 0    // hPa (BME280)
+#endif
+#ifndef RECORD_CO2
+#define RECORD_CO2 0         // ppm
+#endif
+#ifndef RECORD_BATTERY
+#define RECORD_BATTERY 0     // Tension batterie (V)
+#endif
+#ifndef RECORD_BAT_PASSES
+#define RECORD_BAT_PASSES 0  // Passages de chauves-souris comptés
+#endif
+
+// Liste complète, à redéfinir seulement pour un autre ordre (RECORD_CHANNEL_* de record_schema.h)
+#ifndef RECORD_CHANNELS
+#define RECORD_CHANNELS(X)                                                                       \
+    RECORD_CHANNEL_TEMPERATURE(X) RECORD_CHANNEL_HUMIDITY(X) RECORD_OPTIONAL_PRESSURE(X)         \
+    RECORD_OPTIONAL_CO2(X) RECORD_OPTIONAL_BATTERY(X) RECORD_OPTIONAL_BAT_PASSES(X)
+#endif
+
+// Clignotements LED à chaque réveil complet (30 + 100 ms d'éveil, diagnostic seulement)
+#ifndef LED_CYCLE_BLINK
+#define LED_CYCLE_BLINK 0
+#endif
+
+// Configuration des logs pour économie d'énergie (décommenter pour production)
+// -DDEVELOPMENT_MODE garde tous les logs sans modifier ce fichier (comparaison au banc de mesure)
+#ifndef DEVELOPMENT_MODE
+#define PRODUCTION_MODE  // Désactive la plupart des logs pour économiser l'énergie
+#endif
+
+/*
+ * 💡 OPTIMISATION ÉNERGÉTIQUE - LOGS :
+ *
+ * Les ESP_LOGI/ESP_LOGE consomment de l'énergie car ils :
+ * - Maintiennent l'UART actif (~10-20 mA)
+ * - Prolongent le temps d'activité avant deep sleep
+ * - Formatent et transmettent les chaînes
+ *
+ * EN PRODUCTION : Décommenter #define PRODUCTION_MODE
+ * - Garde uniquement les logs essentiels (erreurs, compteur)
+ * - Flush, montage SD et reprises : événements binaires en RTC memory, sans
+ *   formatage (event_log.h)
+ * - Supprime les logs de debug/verbose
+ * - Économie estimée : 5-10% d'autonomie supplémentaire
+ */
+
+// Événements gardés en RTC memory entre deux flushs (16 octets chacun, voir event_log.h)
+#ifndef EVENT_LOG_SIZE
+#define EVENT_LOG_SIZE 32
+#endif
+
+// Configuration du tampon flash pour économie d'énergie
+#ifndef BUFFER_FLUSH_THRESHOLD
+#define BUFFER_FLUSH_THRESHOLD 500  // Nombre de mesures avant flush vers SD (optimisé pour autonomie)
+#endif
+
+// Flush repoussé tant que les mesures varient (échantillonnage adaptatif), au plus jusqu'à ce nombre
+#ifndef BUFFER_FLUSH_DEFER_MAX
+#define BUFFER_FLUSH_DEFER_MAX (2 * BUFFER_FLUSH_THRESHOLD)
+#endif
+
+// Mesures accumulées en RTC memory avant une écriture groupée en flash (voir staging.h)
+#ifndef STAGING_BATCH_SIZE
+#define STAGING_BATCH_SIZE 32
+#endif
+
+/*
+ * 🗄️ BACKEND DE STOCKAGE DU TAMPON
+ *
+ * - BUFFER_BACKEND_SPIFFS : journal binaire dans un fichier SPIFFS (historique)
+ * - BUFFER_BACKEND_RAW    : journal circulaire écrit directement dans la partition,
+ *                           sans montage de système de fichiers au réveil
+ *
+ * ⚠️ Les deux backends utilisent la même partition : flusher le tampon vers la SD
+ * avant de changer de backend, sinon les mesures en attente sont perdues.
+ * Sélection possible depuis platformio.ini : -DBUFFER_BACKEND=BUFFER_BACKEND_RAW
+ */
+#define BUFFER_BACKEND_SPIFFS 0
+#define BUFFER_BACKEND_RAW    1
+
+#ifndef BUFFER_BACKEND
+#define BUFFER_BACKEND BUFFER_BACKEND_SPIFFS
+#endif
+
+// Cycles d'effacement garantis par secteur de la flash SPI (fiche technique), pour
+// la projection de durée de vie (storage_health.h)
+#ifndef FLASH_ENDURANCE_CYCLES
+#define FLASH_ENDURANCE_CYCLES 100000
+#endif
+
+// Journal binaire du tampon (en-tête versionné + enregistrements de taille fixe, voir record.h)
+#define BUFFER_LOG_FILE BUFFER_MOUNT_POINT "/data_buffer.bin"
+
+// Ancien tampon texte des firmwares 1.0.x, converti au premier montage pour ne rien perdre
+#define BUFFER_LEGACY_CSV_FILE BUFFER_MOUNT_POINT "/data_buffer.csv"
+
+// Répertoire de travail du projet sur la carte SD
+#define SD_WORK_DIR MOUNT_POINT "/CHIRO"
+
+// Fichiers de données sur la carte SD : un CSV par jour, SD_WORK_DIR/AAAA/MM/JJ.csv (sd_log.h)
+#define SD_DAY_PATH_FORMAT "/%04d/%02d/%02d.csv"
+
+// Index des fichiers par jour (horodatage et ID -> fichier et position)
+#define SD_INDEX_FILE SD_WORK_DIR "/index.bin"
+
+// Fichier unique des firmwares antérieurs, laissé tel quel (n'est plus complété)
+#define SD_DATA_FILE SD_WORK_DIR "/data.csv"
+
+// Marqueur de validation du flush (fichier du jour, taille validée + dernier ID copié)
+#define SD_COMMIT_FILE SD_WORK_DIR "/data.commit"
+
+// Statistiques de durée des phases du réveil, complétées à chaque flush (phase_stats.h)
+#define SD_STATS_FILE SD_WORK_DIR "/stats.csv"
+
+// État du stockage (usure, remplissage, projections), une ligne par flush (storage_health.h)
+#define SD_HEALTH_FILE SD_WORK_DIR "/health.csv"
+
+// Événements binaires vidés depuis la RTC memory à chaque flush (event_log.h, lus par chiro_events)
+#define SD_EVENTS_FILE SD_WORK_DIR "/events.bin"
+
+// Agrégats min/moyenne/max/écart-type par minute, heure et jour (aggregates.h)
+#define SD_AGG_MINUTE_FILE SD_WORK_DIR "/agg_1min.csv"
+#define SD_AGG_HOUR_FILE   SD_WORK_DIR "/agg_1h.csv"
+#define SD_AGG_DAY_FILE    SD_WORK_DIR "/agg_1d.csv"
+
+// Nombre d'enregistrements lus par bloc lors du flush (deux tranches alternées)
+#define FLUSH_READ_CHUNK 64
+
+// Tâche d'écriture sur la SD pendant le flush (flash_buffer.c) : second cœur,
+// la tâche principale lit le tampon flash pendant ce temps
+#ifndef FLUSH_TASK_CORE
+#if CONFIG_FREERTOS_UNICORE
+#define FLUSH_TASK_CORE 0
+#else
+#define FLUSH_TASK_CORE 1
+#endif
+#endif
+#define FLUSH_TASK_STACK_SIZE 6144
+#define FLUSH_TASK_PRIORITY 5
+
+// Taille d'un bloc d'écriture vers la SD = taille de cluster FAT (allocation_unit_size)
+#define SD_FLUSH_BLOCK_SIZE (16 * 1024)
+
+// Horloge SPI de la carte SD (kHz) : après la sonde à 400 kHz, la plus haute
+// tolérée (SDMMC_FREQ_HIGHSPEED), sinon repli sur SDMMC_FREQ_DEFAULT (sd_card.h)
+#ifndef SD_SPI_FREQ_KHZ_MAX
+#define SD_SPI_FREQ_KHZ_MAX 40000
+#endif
+#define SD_SPI_FREQ_KHZ_SAFE 20000
+
+/*
+ * ⏱️ BANC DE MESURE (bench.h)
+ *
+ * Courants utilisés pour convertir les temps mesurés en consommation (mAh/jour).
+ * Valeurs par défaut issues des mesures du README, à ajuster pour chaque montage.
+ * Compiler avec -DBENCH_CYCLES=N pour que app_main() rejoue N cycles au lieu de
+ * dormir, et écrive le bilan dans BENCH_REPORT_FILE.
+ */
+#ifndef BENCH_ACTIVE_MA
+#define BENCH_ACTIVE_MA 80.0f      // ESP32 éveillé à 240 MHz
+#endif
+#ifndef BENCH_SD_MA
+#define BENCH_SD_MA 40.0f          // Supplément quand la carte SD est alimentée
+#endif
+#ifndef BENCH_SLEEP_UA
+#define BENCH_SLEEP_UA 15.0f       // Deep sleep (10-20 µA mesurés)
+#endif
+#ifndef BENCH_BOOT_MS
+#define BENCH_BOOT_MS 150          // Bootloader avant esp_timer, invisible pour le banc
+#endif
+#ifndef BENCH_STUB_WAKE_US
+#define BENCH_STUB_WAKE_US 1000    // Réveil par le wake stub : ROM + stub, à mesurer à l'oscilloscope
+#endif
+#ifndef BENCH_BATTERY_MAH
+#define BENCH_BATTERY_MAH 1000     // Batterie pour la projection d'autonomie
+#endif
+
+#define BENCH_REPORT_FILE SD_WORK_DIR "/bench.txt"
+
+// Macros pour logs économes en énergie
+#ifdef PRODUCTION_MODE
+    #define LOG_ESSENTIAL(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+    #define LOG_DEBUG(tag, format, ...) // Pas de log en production
+    #define LOG_VERBOSE(tag, format, ...) // Pas de log en production
+#else
+    #define LOG_ESSENTIAL(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+    #define LOG_DEBUG(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+    #define LOG_VERBOSE(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+#endif
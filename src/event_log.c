@@ -0,0 +1,127 @@
+#include <string.h>
+#include <esp_attr.h>
+#include <freertos/FreeRTOS.h>
+
+#include "event_log.h"
+#include "metrics.h"
+#include "record.h"
+#include "timekeeper.h"
+
+#define EVENT_LOG_MAGIC 0x54564545u  // "EEVT"
+
+typedef struct {
+    uint32_t magic;     // EVENT_LOG_MAGIC si l'anneau est cohérent
+    uint32_t next;      // Nombre d'événements ajoutés (position d'écriture modulo EVENT_LOG_SIZE)
+    uint32_t count;     // Événements en attente de vidage (au plus EVENT_LOG_SIZE)
+    uint32_t dropped;   // Événements remplacés avant d'avoir été vidés
+    event_entry_t entries[EVENT_LOG_SIZE];
+} event_ring_t;
+
+// Anneau en RTC memory : vidé après une perte d'alimentation
+RTC_DATA_ATTR static event_ring_t ring;
+
+// Tâche principale et tâche SD du flush peuvent journaliser en même temps
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void event_log(event_id_t event, int32_t arg0, int32_t arg1)
+{
+    uint32_t epoch = timekeeper_now();
+
+    portENTER_CRITICAL(&ring_lock);
+    if (ring.magic != EVENT_LOG_MAGIC || ring.count > EVENT_LOG_SIZE) {
+        memset(&ring, 0, sizeof(ring));
+        ring.magic = EVENT_LOG_MAGIC;
+    }
+    event_entry_t *entry = &ring.entries[ring.next % EVENT_LOG_SIZE];
+    entry->epoch = epoch;
+    entry->args[0] = arg0;
+    entry->args[1] = arg1;
+    entry->event = (uint16_t)event;
+    ring.next++;
+    if (ring.count < EVENT_LOG_SIZE) {
+        ring.count++;
+    } else {
+        ring.dropped++;
+    }
+    portEXIT_CRITICAL(&ring_lock);
+}
+
+#ifndef PRODUCTION_MODE
+static const event_info_t event_infos[EVENT_COUNT] = { EVENT_CATALOG(EVENT_INFO) };
+
+void event_log_print(const char *tag, event_id_t event, int32_t arg0, int32_t arg1)
+{
+    event_log(event, arg0, arg1);
+
+    const event_info_t *info = &event_infos[event];
+    char text[160];
+    snprintf(text, sizeof(text), info->format, (long)arg0, (long)arg1);
+    if (info->level == 'E') {
+        ESP_LOGE(tag, "%s", text);
+    } else if (info->level == 'W') {
+        ESP_LOGW(tag, "%s", text);
+    } else {
+        ESP_LOGI(tag, "%s", text);
+    }
+}
+#endif
+
+static bool write_entry(FILE *file, event_entry_t *entry)
+{
+    entry->crc = record_crc16(entry, offsetof(event_entry_t, crc));
+    if (fwrite(entry, sizeof(*entry), 1, file) != 1) {
+        return false;
+    }
+    wake_metrics.sd_bytes += sizeof(*entry);
+    return true;
+}
+
+esp_err_t event_log_write(FILE *file)
+{
+    // Copie de l'anneau : l'écriture sur la SD se fait hors section critique
+    event_entry_t entries[EVENT_LOG_SIZE];
+    portENTER_CRITICAL(&ring_lock);
+    bool valid = ring.magic == EVENT_LOG_MAGIC && ring.count <= EVENT_LOG_SIZE;
+    uint32_t count = valid ? ring.count : 0;
+    uint32_t first = ring.next - count;
+    uint32_t dropped = valid ? ring.dropped : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i] = ring.entries[(first + i) % EVENT_LOG_SIZE];
+    }
+    portEXIT_CRITICAL(&ring_lock);
+
+    if (count == 0) {
+        return ESP_OK;
+    }
+
+    bool ok = true;
+    if (dropped > 0) {
+        event_entry_t overflow = {
+            .epoch = entries[0].epoch,
+            .args = { (int32_t)dropped, 0 },
+            .event = EVENT_LOG_OVERFLOW,
+        };
+        ok = write_entry(file, &overflow);
+    }
+    for (uint32_t i = 0; i < count && ok; i++) {
+        ok = write_entry(file, &entries[i]);
+    }
+    if (!ok) {
+        return ESP_FAIL;
+    }
+
+    // Retirer les événements écrits, garder ceux ajoutés entre-temps
+    portENTER_CRITICAL(&ring_lock);
+    uint32_t added = ring.next - (first + count);
+    if (ring.count > added) {
+        ring.count = added;
+    }
+    ring.dropped -= dropped;
+    portEXIT_CRITICAL(&ring_lock);
+    return ESP_OK;
+}
+
+uint32_t event_log_count(void)
+{
+    return ring.magic == EVENT_LOG_MAGIC && ring.count <= EVENT_LOG_SIZE ? ring.count : 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <esp_err.h>
+#include <esp_log.h>
+
+#include "config.h"
+
+/*
+ * 📟 JOURNAL D'ÉVÉNEMENTS BINAIRE
+ *
+ * En production, les messages du flush, du montage SD et des reprises après
+ * coupure ne sont ni formatés ni envoyés sur l'UART : LOG_EVENT ajoute un
+ * numéro d'événement, l'heure et deux arguments entiers à un anneau de
+ * EVENT_LOG_SIZE entrées en RTC memory. L'anneau est vidé dans
+ * SD_EVENTS_FILE à chaque flush réussi.
+ *
+ * Les messages ne sont décrits qu'une fois, dans EVENT_CATALOG :
+ *   X(nom, niveau, format)
+ * - niveau : 'E', 'W' ou 'I' (ESP_LOGE/W/I en développement)
+ * - format : printf avec au plus deux conversions %ld / %lu
+ * Le firmware de production ne contient que les numéros ; chiro_events
+ * retrouve les messages sur l'ordinateur depuis ce même catalogue. Sans
+ * PRODUCTION_MODE, chaque événement est aussi affiché comme avant.
+ *
+ * Anneau plein : les plus anciens événements sont remplacés et comptés
+ * (EVENT_LOG_OVERFLOW au vidage suivant). Une perte d'alimentation vide
+ * l'anneau ; les reprises qui la suivent sont, elles, journalisées. Avant
+ * que l'heure ne soit restaurée (timekeeper.h), la reconstruction du tampon
+ * est datée en secondes depuis le démarrage.
+ */
+
+#define EVENT_CATALOG(X)                                                                        \
+    X(LOG_OVERFLOW, 'W', "%ld événement(s) perdu(s), anneau plein")                             \
+    X(SD_SPI_BUS_FAILED, 'E', "Erreur initialisation bus SPI (esp_err %ld)")                    \
+    X(SD_MOUNT_RETRY, 'W', "Montage SD échoué à %ld kHz (esp_err %ld), nouvel essai plus lent") \
+    X(SD_MOUNT_FAILED, 'E', "Montage SD impossible (esp_err %ld)")                              \
+    X(SD_MOUNTED, 'I', "Carte SD montée en %ld ms à %ld kHz")                                   \
+    X(SD_CARD_PROBED, 'I', "Nouvelle carte SD : %ld secteurs de %ld octets")                    \
+    X(SD_WORK_DIR_FAILED, 'E', "Répertoire de travail non créé")                                \
+    X(SD_LOG_TRUNCATED, 'W', "Fin non validée du fichier du jour retirée (%ld -> %ld octets)")  \
+    X(SD_LOG_LINE_TRIMMED, 'W', "Ligne incomplète retirée du fichier du jour (%ld -> %ld octets)") \
+    X(FLASH_INIT_FAILED, 'E', "Tampon flash indisponible (esp_err %ld)")                        \
+    X(FLASH_APPEND_FAILED, 'E', "Échec écriture du lot dans le tampon (esp_err %ld), %ld mesures déjà en flash") \
+    X(FLASH_RING_FULL, 'E', "Journal circulaire plein (%ld mesures en attente)")                \
+    X(FLASH_RECOVERED, 'W', "Tampon reconstruit après coupure : %ld mesures en attente")        \
+    X(FLASH_TRIMMED, 'W', "Fin de tampon incomplète retirée (%ld -> %ld octets)")               \
+    X(STAGING_TO_SD, 'W', "%ld mesures du lot RTC écrites directement sur la SD")               \
+    X(STAGING_KEPT, 'W', "Tampon et SD indisponibles, %ld mesures gardées en RTC memory")       \
+    X(FLUSH_START, 'I', "Flush de %ld mesures vers la SD")                                      \
+    X(FLUSH_SD_FAILED, 'E', "SD indisponible pour le flush (esp_err %ld)")                      \
+    X(FLUSH_LOG_FAILED, 'E', "Journal SD non repris pour le flush")                             \
+    X(FLUSH_TASK_FAILED, 'E', "Tâche de flush non créée")                                       \
+    X(FLUSH_READ_FAILED, 'E', "Lecture du tampon impossible (esp_err %ld) à la mesure %ld")     \
+    X(FLUSH_CORRUPTED, 'W', "%ld enregistrement(s) corrompu(s) ignoré(s)")                      \
+    X(FLUSH_DUPLICATES, 'W', "%ld mesure(s) déjà présentes sur la SD ignorées (reprise)")       \
+    X(FLUSH_CONSUME_FAILED, 'W', "Impossible de retirer %ld mesures du tampon")                 \
+    X(FLUSH_FAILED, 'E', "Erreur pendant le flush, %ld mesures restent dans le tampon")         \
+    X(FLUSH_DONE, 'I', "%ld lignes copiées vers la SD, %ld mesures retirées du tampon")         \
+    X(FLUSH_WRITTEN, 'I', "Flush : %ld octets écrits en %ld ms")                                \
+    X(FLUSH_SD_POWERED, 'I', "SD alimentée %ld ms pour le flush")                               \
+    X(TIME_RESTORED, 'W', "Reprise après coupure : ID #%lu, heure %lu")                         \
+    X(TIME_NO_CHECKPOINT, 'W', "Aucun point de contrôle NVS (esp_err %ld), premier démarrage")  \
+    X(TIME_CHECKPOINT_FAILED, 'E', "Point de contrôle NVS non écrit (esp_err %ld)")             \
+    X(TIME_NVS_RESET, 'W', "Partition NVS réinitialisée (esp_err %ld)")                         \
+    X(TIME_IDS_SKIPPED, 'W', "ID #%lu déjà sur la SD : numérotation reprise à #%lu")             \
+    X(FLASH_BLOCKS_SKIPPED, 'W', "Tampon : %ld octets illisibles sautés à l'offset %ld, blocs suivants relus") \
+    X(TIME_IDS_PROVISIONAL, 'W', "NVS en échec : ID #%lu à #%lu réservés en RTC seulement")
+
+#define EVENT_ENUM(name, level, format) EVENT_##name,
+typedef enum { EVENT_CATALOG(EVENT_ENUM) EVENT_COUNT } event_id_t;
+#undef EVENT_ENUM
+
+// Entrée de l'anneau et de SD_EVENTS_FILE (16 octets)
+typedef struct __attribute__((packed)) {
+    uint32_t epoch;    // Heure de l'événement (timekeeper)
+    int32_t args[2];
+    uint16_t event;    // event_id_t
+    uint16_t crc;      // CRC-16 des 14 octets précédents (calculé au vidage)
+} event_entry_t;
+
+_Static_assert(sizeof(event_entry_t) == 16, "entrée d'événement: 16 octets attendus");
+
+// Description d'un événement (tables construites depuis EVENT_CATALOG)
+typedef struct {
+    const char *name;
+    char level;
+    const char *format;
+} event_info_t;
+
+#define EVENT_INFO(name, level, format) { #name, level, format },
+
+// Ajouter un événement à l'anneau (sans formatage)
+void event_log(event_id_t event, int32_t arg0, int32_t arg1);
+
+// Ajouter un événement et l'afficher (développement)
+void event_log_print(const char *tag, event_id_t event, int32_t arg0, int32_t arg1);
+
+// Vider l'anneau à la fin d'un fichier ouvert (carte montée) ; les événements
+// ajoutés pendant l'écriture restent pour le vidage suivant
+esp_err_t event_log_write(FILE *file);
+
+// Événements en attente dans l'anneau
+uint32_t event_log_count(void);
+
+#ifdef PRODUCTION_MODE
+#define LOG_EVENT(tag, event, arg0, arg1) ((void)(tag), event_log(EVENT_##event, (int32_t)(arg0), (int32_t)(arg1)))
+#else
+#define LOG_EVENT(tag, event, arg0, arg1) event_log_print(tag, EVENT_##event, (int32_t)(arg0), (int32_t)(arg1))
+#endif
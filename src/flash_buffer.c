@@ -0,0 +1,608 @@
+#include <stdio.h>
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+#include <esp_vfs_fat.h>
+
+#include "flash_buffer.h"
+#include "buffer_backend.h"
+#include "staging.h"
+#include "sd_card.h"
+#include "led.h"
+#include "metrics.h"
+#include "phase_stats.h"
+#include "aggregates.h"
+#include "sd_log.h"
+#include "timekeeper.h"
+#include "storage_health.h"
+#include "event_log.h"
+
+static const char *TAG = "CHIRO_BUFFER";
+
+// Backend de stockage du tampon flash (sélection dans config.h)
+static const buffer_backend_t *flash_buffer = BUFFER_BACKEND_DEFAULT;
+
+// Le tampon flash n'est monté que lorsqu'un lot doit y être écrit
+static bool flash_buffer_ready = false;
+
+// Copie en RTC memory du nombre de mesures en attente dans le tampon flash,
+// pour décider d'un flush sans monter le tampon
+#define FLASH_PENDING_MAGIC 0x50454E44u  // "DNEP"
+RTC_DATA_ATTR static uint32_t flash_pending_magic = 0;
+RTC_DATA_ATTR static uint32_t flash_pending_count = 0;
+
+// Début de réveil : le tampon n'est pas encore monté pour ce cycle
+void reset_flash_buffer_session(void)
+{
+    flash_buffer_ready = false;
+}
+
+// Fonction d'initialisation du tampon flash (backend choisi dans config.h)
+esp_err_t init_flash_buffer(void)
+{
+    if (flash_buffer_ready) {
+        return ESP_OK;
+    }
+    
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = flash_buffer->init();
+    int64_t mount_us = esp_timer_get_time() - start;
+    wake_metrics.flash_mount_us += mount_us;
+    wake_metrics.flash_mounts++;
+    phase_stats_record(PHASE_FLASH_MOUNT, mount_us);
+    if (ret != ESP_OK) {
+        LOG_EVENT(TAG, FLASH_INIT_FAILED, ret, 0);
+        return ret;
+    }
+    
+    flash_buffer_ready = true;
+    flash_pending_count = flash_buffer->count();
+    flash_pending_magic = FLASH_PENDING_MAGIC;
+    LOG_DEBUG(TAG, "✅ Tampon flash prêt (backend %s)", flash_buffer->name);
+    return ESP_OK;
+}
+
+// Montage anticipé, recouvert par la conversion des capteurs (sensor.h)
+void prepare_flash_buffer(void)
+{
+    if (staging_count() + 1 >= STAGING_BATCH_SIZE || flash_pending_magic != FLASH_PENDING_MAGIC) {
+        init_flash_buffer();  // En cas d'échec, l'ajout ou le comptage réessaieront
+    }
+}
+
+// Écrire le lot RTC dans le tampon flash en une seule opération
+esp_err_t commit_staging_to_flash(void)
+{
+    uint32_t count = staging_count();
+    if (count == 0) {
+        return ESP_OK;
+    }
+    
+    esp_err_t ret = init_flash_buffer();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    uint32_t stored_before = flash_buffer->count();
+    ret = flash_buffer->append(staging_records(), count);
+    if (ret != ESP_OK) {
+        // Le lot reste en RTC memory : rien n'est perdu tant que l'alimentation tient.
+        // Début du lot déjà en flash (échec au changement de secteur) : ne pas le garder
+        // aussi dans le lot, il partirait deux fois sur la SD
+        uint32_t stored_after = flash_buffer->count();
+        uint32_t stored = 0;
+        if (stored_after > stored_before && stored_after - stored_before < count) {
+            stored = stored_after - stored_before;
+            staging_drop(stored);
+            wake_metrics.buffered_records += stored;
+            flash_pending_count = stored_after;
+        }
+        LOG_EVENT(TAG, FLASH_APPEND_FAILED, ret, stored);
+        return ret;
+    }
+    
+    staging_clear();
+    wake_metrics.buffered_records += count;
+    flash_pending_count = flash_buffer->count();
+    LOG_DEBUG(TAG, "✅ Lot de %lu mesures écrit dans le tampon flash", (unsigned long)count);
+    return ESP_OK;
+}
+
+// Fonction pour ajouter une mesure dans le tampon flash avec ID unique
+esp_err_t add_to_flash_buffer(const chiro_record_t *record)
+{
+    LOG_DEBUG(TAG, "🔋 Ajout mesure au lot RTC...");
+    
+    // Lot encore plein après un échec précédent : le vider avant d'ajouter
+    if (staging_is_full()) {
+        esp_err_t ret = commit_staging_to_flash();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    staging_push(record);
+    
+    // Lot complet : une seule écriture flash pour STAGING_BATCH_SIZE mesures
+    if (staging_is_full()) {
+        esp_err_t ret = commit_staging_to_flash();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    
+#if LED_CYCLE_BLINK
+    // Clignotement LED : 1 fois pour ajout au tampon
+    blink_led(1, 100);
+#endif
+    
+    return ESP_OK;
+}
+
+// Fonction pour compter les mesures en attente (lot RTC + tampon flash)
+int count_buffer_records(void)
+{
+    // Après une perte d'alimentation la copie RTC est perdue : interroger le backend
+    if (flash_pending_magic != FLASH_PENDING_MAGIC && init_flash_buffer() != ESP_OK) {
+        return (int)staging_count();
+    }
+    return (int)(flash_pending_count + staging_count());
+}
+
+// Dernière mesure du tampon flash (reprise des ID et de l'heure après une coupure)
+esp_err_t read_last_buffer_record(chiro_record_t *record)
+{
+    esp_err_t ret = init_flash_buffer();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint32_t count = flash_buffer->count();
+    if (count == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t read_count = 0;
+    ret = flash_buffer->read(count - 1, record, 1, &read_count);
+    if (ret != ESP_OK || read_count != 1 || !record_is_valid(record)) {
+        return ret != ESP_OK ? ret : ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
+
+esp_err_t read_sd_committed_id(uint32_t *last_id)
+{
+    flush_buffer_wait();
+    esp_err_t ret = init_sd_card();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    *last_id = sd_log_committed_id();
+    unmount_sd_card();
+    return ESP_OK;
+}
+
+// Tampon DMA réutilisé par tous les flushs du réveil
+static char *sd_flush_block = NULL;
+
+// Allouer le tampon d'écriture avant d'alimenter la SD
+static esp_err_t alloc_sd_flush_block(void)
+{
+    if (sd_flush_block == NULL) {
+        sd_flush_block = heap_caps_malloc(SD_FLUSH_BLOCK_SIZE, MALLOC_CAP_DMA);
+        if (sd_flush_block == NULL) {
+            ESP_LOGE(TAG, "❌ Mémoire DMA insuffisante pour le flush");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
+
+// Mode dégradé : écrire directement le lot RTC sur la SD (un seul montage pour tout le lot)
+esp_err_t write_staging_to_sd(void)
+{
+    flush_buffer_wait();
+    // Lot vide : ni bloc de flush ni montage de la carte
+    if (staging_count() == 0) {
+        return ESP_OK;
+    }
+    esp_err_t ret = alloc_sd_flush_block();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = init_sd_card();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    // L'ID validé reste celui du dernier flush du tampon
+    sd_log_writer_t writer;
+    if (sd_log_open(&writer, sd_flush_block, false) != ESP_OK) {
+        unmount_sd_card();
+        return ESP_FAIL;
+    }
+    
+    const chiro_record_t *records = staging_records();
+    int lines = 0;
+    for (uint32_t i = 0; i < staging_count(); i++) {
+        if (record_is_valid(&records[i])) {
+            sd_log_add(&writer, &records[i]);
+            lines++;
+        }
+    }
+    
+    if (sd_log_close(&writer) != ESP_OK) {
+        unmount_sd_card();
+        return ESP_FAIL;
+    }
+    
+    staging_clear();
+    unmount_sd_card();
+    LOG_EVENT(TAG, STAGING_TO_SD, lines, 0);
+    return ESP_OK;
+}
+
+/*
+ * Flush asynchrone : la tâche SD, épinglée sur FLUSH_TASK_CORE, monte la
+ * carte et écrit le CSV pendant que la tâche principale lit le tampon flash
+ * dans deux tranches de FLUSH_READ_CHUNK enregistrements, remplies tour à
+ * tour. Bits du groupe d'événements :
+ *   FULL(i)  tranche i lue en flash, à écrire     FREE(i) tranche i réutilisable
+ *   END      plus de tranche à venir              COPIED  journal validé et fermé
+ *   DONE     tâche SD terminée (carte démontée) : deep sleep possible
+ */
+#define FLUSH_BIT_FULL(i) (1u << (i))
+#define FLUSH_BIT_FREE(i) (1u << (2 + (i)))
+#define FLUSH_BIT_END     (1u << 4)
+#define FLUSH_BIT_COPIED  (1u << 5)
+#define FLUSH_BIT_DONE    (1u << 6)
+
+typedef struct {
+    chiro_record_t chunks[2][FLUSH_READ_CHUNK];
+    size_t chunk_count[2];
+    sd_log_writer_t writer;
+    volatile bool read_failed;  // Lecture du tampon impossible (tâche principale)
+    volatile bool sd_failed;    // Carte ou journal indisponible (tâche SD)
+    // Reprise : début du tampon déjà validé sur la SD, IDs croissants jusqu'au dernier ID validé
+    bool skipping;
+    uint32_t previous_id;
+    int lines_copied;
+    int corrupted;
+    int duplicates;
+    // Occupation du tampon et heure relevées par la tâche principale avant le flush
+    buffer_usage_t usage;
+    bool usage_ok;
+    uint32_t epoch;
+} flush_job_t;
+
+static flush_job_t flush_job;
+static EventGroupHandle_t flush_events = NULL;
+static bool flush_task_running = false;
+
+// Convertir une tranche d'enregistrements en CSV sur la SD (tâche SD)
+static void copy_chunk(flush_job_t *job, const chiro_record_t *records, size_t count)
+{
+    sd_log_writer_t *writer = &job->writer;
+    for (size_t i = 0; i < count && !writer->error; i++) {
+        if (!record_is_valid(&records[i])) {
+            job->corrupted++;
+            writer->block_records++;
+            continue;
+        }
+        
+        if (job->skipping) {
+            uint32_t id = records[i].id;
+            if (id <= writer->committed_id && id > job->previous_id) {
+                job->previous_id = id;
+                job->duplicates++;
+                if (writer->fill == 0) {
+                    writer->committed++;
+                } else {
+                    writer->block_records++;
+                }
+                continue;
+            }
+            job->skipping = false;
+        }
+        
+        sd_log_add(writer, &records[i]);
+        writer->block_records++;
+        job->lines_copied++;
+    }
+}
+
+// Ajouter les statistiques de durée des phases à SD_STATS_FILE
+static void write_phase_stats(void)
+{
+    FILE *file = fopen(SD_STATS_FILE, "a");
+    if (file == NULL) {
+        ESP_LOGW(TAG, "⚠️  Impossible d'ouvrir %s", SD_STATS_FILE);
+        return;
+    }
+    long start = ftell(file);
+    esp_err_t ret = phase_stats_write(file);
+    long end = ftell(file);
+    if (fclose(file) != 0 || ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  Statistiques des phases non écrites");
+        return;
+    }
+    if (end > start) {
+        wake_metrics.sd_bytes += (uint32_t)(end - start);
+    }
+}
+
+// Vider l'anneau d'événements de la RTC memory dans SD_EVENTS_FILE (tâche SD)
+static void write_events(void)
+{
+    if (event_log_count() == 0) {
+        return;
+    }
+    FILE *file = fopen(SD_EVENTS_FILE, "ab");
+    if (file == NULL) {
+        ESP_LOGW(TAG, "⚠️  Impossible d'ouvrir %s", SD_EVENTS_FILE);
+        return;
+    }
+    esp_err_t ret = event_log_write(file);
+    if (fclose(file) != 0 || ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  Événements non écrits, nouvel essai au prochain flush");
+    }
+}
+
+// Ajouter la ligne d'état du stockage à SD_HEALTH_FILE (tâche SD)
+static void write_storage_health(const flush_job_t *job)
+{
+    if (!job->usage_ok) {
+        return;
+    }
+    uint64_t sd_total = 0, sd_free = 0;
+    if (esp_vfs_fat_info(MOUNT_POINT, &sd_total, &sd_free) != ESP_OK) {
+        sd_free = 0;
+    }
+    
+    FILE *file = fopen(SD_HEALTH_FILE, "a");
+    if (file == NULL) {
+        ESP_LOGW(TAG, "⚠️  Impossible d'ouvrir %s", SD_HEALTH_FILE);
+        return;
+    }
+    long start = ftell(file);
+    esp_err_t ret = storage_health_write(file, job->epoch, flash_buffer->name, &job->usage, sd_free);
+    long end = ftell(file);
+    if (fclose(file) != 0 || ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  État du stockage non écrit");
+        return;
+    }
+    if (end > start) {
+        wake_metrics.sd_bytes += (uint32_t)(end - start);
+    }
+}
+
+// Ajouter les agrégats terminés à leurs fichiers, retirés de la RTC memory si tout est écrit
+static void write_aggregates(void)
+{
+    bool ok = true;
+    
+    for (int tier = 0; tier < AGG_TIER_NUM && ok; tier++) {
+        FILE *file = fopen(aggregates_file(tier), "a");
+        if (file == NULL) {
+            ok = false;
+            break;
+        }
+        long start = ftell(file);
+        esp_err_t ret = aggregates_write(tier, file);
+        long end = ftell(file);
+        ok = fclose(file) == 0 && ret == ESP_OK;
+        if (end > start) {
+            wake_metrics.sd_bytes += (uint32_t)(end - start);
+        }
+    }
+    
+    if (!ok) {
+        ESP_LOGW(TAG, "⚠️  Agrégats non écrits, nouvel essai au prochain flush");
+        return;
+    }
+    aggregates_clear();
+}
+
+// Tâche SD : montage, copie des tranches au fil de leur lecture, statistiques, démontage
+static void sd_flush_task(void *arg)
+{
+    flush_job_t *job = arg;
+    sd_log_writer_t *writer = &job->writer;
+    
+    // Initialiser la carte SD (début du temps d'alimentation de la SD)
+    int64_t sd_on_start = esp_timer_get_time();
+    esp_err_t ret = init_sd_card();
+    if (ret != ESP_OK) {
+        LOG_EVENT(TAG, FLUSH_SD_FAILED, ret, 0);
+        job->sd_failed = true;
+        xEventGroupSetBits(flush_events, FLUSH_BIT_COPIED | FLUSH_BIT_DONE);
+        vTaskDelete(NULL);
+        return;
+    }
+    
+    // Remettre le journal de la SD dans son dernier état validé
+    if (sd_log_open(writer, sd_flush_block, true) != ESP_OK) {
+        LOG_EVENT(TAG, FLUSH_LOG_FAILED, 0, 0);
+        job->sd_failed = true;
+        unmount_sd_card();
+        xEventGroupSetBits(flush_events, FLUSH_BIT_COPIED | FLUSH_BIT_DONE);
+        vTaskDelete(NULL);
+        return;
+    }
+    
+    // Numérotation antérieure au suivi des ID en NVS : ne pas réutiliser les ID de la SD
+    timekeeper_skip_ids(writer->committed_id);
+    job->skipping = writer->committed_id != 0;
+    
+    // Copier les tranches dans l'ordre de lecture, bloc par bloc validé
+    int64_t write_start = esp_timer_get_time();
+    for (int slot = 0;; slot ^= 1) {
+        EventBits_t bits = xEventGroupWaitBits(flush_events, FLUSH_BIT_FULL(slot) | FLUSH_BIT_END, pdFALSE,
+                                               pdFALSE, portMAX_DELAY);
+        if (!(bits & FLUSH_BIT_FULL(slot))) {
+            break;
+        }
+        xEventGroupClearBits(flush_events, FLUSH_BIT_FULL(slot));
+        if (!writer->error) {
+            copy_chunk(job, job->chunks[slot], job->chunk_count[slot]);
+        }
+        xEventGroupSetBits(flush_events, FLUSH_BIT_FREE(slot));
+    }
+    bool close_ok = sd_log_close(writer) == ESP_OK;
+    int64_t write_us = esp_timer_get_time() - write_start;
+    bool ok = close_ok && !job->read_failed;
+    
+    if (ok) {
+        // Statistiques des phases avant de rendre la main : la tâche principale va en ajouter
+        write_phase_stats();
+        write_storage_health(job);
+        write_events();
+    }
+    xEventGroupSetBits(flush_events, FLUSH_BIT_COPIED);
+    
+    if (ok) {
+        // Agrégats depuis le flush précédent (la carte est déjà montée)
+        write_aggregates();
+    }
+    
+    // Démonter la SD pour économiser l'énergie
+    unmount_sd_card();
+    int64_t sd_on_us = esp_timer_get_time() - sd_on_start;
+    
+    if (ok) {
+        LOG_EVENT(TAG, FLUSH_WRITTEN, writer->written, write_us / 1000);
+        LOG_EVENT(TAG, FLUSH_SD_POWERED, sd_on_us / 1000, 0);
+        
+        // Clignotement LED : 10 fois pour flush vers SD (après démontage, la SD n'est plus alimentée)
+        blink_led(10, 30);
+    }
+    
+    xEventGroupSetBits(flush_events, FLUSH_BIT_DONE);
+    vTaskDelete(NULL);
+}
+
+// Attendre la fin de la tâche SD d'un flush précédent
+void flush_buffer_wait(void)
+{
+    if (flush_task_running) {
+        xEventGroupWaitBits(flush_events, FLUSH_BIT_DONE, pdFALSE, pdFALSE, portMAX_DELAY);
+        flush_task_running = false;
+    }
+}
+
+// Lire le tampon flash tranche par tranche pour la tâche SD (tâche principale)
+static void feed_sd_task(flush_job_t *job, uint32_t total)
+{
+    uint32_t first = 0;
+    for (int slot = 0; first < total; slot ^= 1) {
+        // Tranche libre, sauf si la tâche SD a renoncé (carte absente, écriture échouée)
+        EventBits_t bits = xEventGroupWaitBits(flush_events, FLUSH_BIT_FREE(slot) | FLUSH_BIT_COPIED, pdFALSE,
+                                               pdFALSE, portMAX_DELAY);
+        if ((bits & FLUSH_BIT_COPIED) || job->writer.error) {
+            break;
+        }
+        xEventGroupClearBits(flush_events, FLUSH_BIT_FREE(slot));
+        
+        size_t wanted = total - first < FLUSH_READ_CHUNK ? total - first : FLUSH_READ_CHUNK;
+        size_t count = 0;
+        esp_err_t ret = flash_buffer->read(first, job->chunks[slot], wanted, &count);
+        if (ret != ESP_OK || count == 0) {
+            LOG_EVENT(TAG, FLUSH_READ_FAILED, ret, first);
+            job->read_failed = true;
+            break;
+        }
+        job->chunk_count[slot] = count;
+        xEventGroupSetBits(flush_events, FLUSH_BIT_FULL(slot));
+        first += count;
+    }
+    xEventGroupSetBits(flush_events, FLUSH_BIT_END);
+}
+
+// Copie du tampon flash vers la carte SD (corps de flush_buffer_to_sd)
+static esp_err_t copy_buffer_to_sd(void)
+{
+    flush_buffer_wait();
+    
+    // Le lot RTC rejoint le tampon flash avant la copie (il reste en RTC en cas d'échec)
+    commit_staging_to_flash();
+    if (init_flash_buffer() != ESP_OK) {
+        return ESP_FAIL;
+    }
+    
+    // Vérifier si le tampon contient des mesures
+    uint32_t buffer_records = flash_buffer->count();
+    if (buffer_records == 0) {
+        LOG_DEBUG(TAG, "ℹ️  Aucun tampon à flusher");
+        return ESP_OK;
+    }
+    LOG_EVENT(TAG, FLUSH_START, buffer_records, 0);
+    
+    // Tampon d'écriture alloué avant d'alimenter la SD
+    esp_err_t ret = alloc_sd_flush_block();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (flush_events == NULL && (flush_events = xEventGroupCreate()) == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // Tâche SD lancée : le montage de la carte recouvre la lecture des premières tranches
+    memset(&flush_job, 0, sizeof(flush_job));
+    flush_job.usage_ok = flash_buffer->usage(&flush_job.usage) == ESP_OK;
+    flush_job.epoch = timekeeper_now();
+    xEventGroupClearBits(flush_events, FLUSH_BIT_FULL(0) | FLUSH_BIT_FULL(1) | FLUSH_BIT_END | FLUSH_BIT_COPIED |
+                                       FLUSH_BIT_DONE);
+    xEventGroupSetBits(flush_events, FLUSH_BIT_FREE(0) | FLUSH_BIT_FREE(1));
+    if (xTaskCreatePinnedToCore(sd_flush_task, "chiro_sd_flush", FLUSH_TASK_STACK_SIZE, &flush_job,
+                                FLUSH_TASK_PRIORITY, NULL, FLUSH_TASK_CORE) != pdPASS) {
+        LOG_EVENT(TAG, FLUSH_TASK_FAILED, 0, 0);
+        return ESP_ERR_NO_MEM;
+    }
+    flush_task_running = true;
+    
+    feed_sd_task(&flush_job, buffer_records);
+    xEventGroupWaitBits(flush_events, FLUSH_BIT_COPIED, pdFALSE, pdFALSE, portMAX_DELAY);
+    if (flush_job.sd_failed) {
+        return ESP_FAIL;
+    }
+    
+    sd_log_writer_t *writer = &flush_job.writer;
+    if (flush_job.corrupted > 0) {
+        LOG_EVENT(TAG, FLUSH_CORRUPTED, flush_job.corrupted, 0);
+    }
+    if (flush_job.duplicates > 0) {
+        LOG_EVENT(TAG, FLUSH_DUPLICATES, flush_job.duplicates, 0);
+    }
+    
+    // Libérer ce qui est validé sur la SD, même en cas d'échec : une nouvelle
+    // tentative ne renverra que la fin manquante. La tâche SD termine pendant ce temps.
+    if (writer->committed > 0) {
+        if (flash_buffer->consume(writer->committed) == ESP_OK) {
+            wake_metrics.flushed_records += writer->committed;
+        } else {
+            LOG_EVENT(TAG, FLUSH_CONSUME_FAILED, writer->committed, 0);
+        }
+        flash_pending_count = flash_buffer->count();
+    }
+    
+    if (writer->error || flush_job.read_failed) {
+        LOG_EVENT(TAG, FLUSH_FAILED, flash_pending_count, 0);
+        return ESP_FAIL;
+    }
+    
+    LOG_EVENT(TAG, FLUSH_DONE, flush_job.lines_copied, writer->committed);
+    return ESP_OK;
+}
+
+// Fonction pour transférer le tampon flash vers la carte SD
+esp_err_t flush_buffer_to_sd(void)
+{
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = copy_buffer_to_sd();
+    int64_t flush_us = esp_timer_get_time() - start;
+    wake_metrics.flush_us += flush_us;
+    phase_stats_record(PHASE_FLUSH, flush_us);
+    return ret;
+}
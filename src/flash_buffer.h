@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <esp_err.h>
+
+#include "config.h"
+#include "record.h"
+
+/*
+ * 🔋 TAMPON FLASH ET FLUSH VERS LA SD
+ *
+ * Les mesures passent par le lot RTC (staging.h), puis par le tampon flash
+ * (buffer_backend.h), avant d'être copiées en CSV sur la carte SD quand
+ * BUFFER_FLUSH_THRESHOLD est atteint.
+ */
+
+// Début de réveil : le tampon n'est pas encore monté pour ce cycle
+void reset_flash_buffer_session(void);
+
+// Fonction d'initialisation du tampon flash (backend choisi dans config.h)
+esp_err_t init_flash_buffer(void);
+
+// Pendant la conversion des capteurs : monter le tampon dès maintenant si ce
+// réveil va s'en servir (lot RTC complet après la mesure, compteur RTC perdu)
+void prepare_flash_buffer(void);
+
+// Écrire le lot RTC dans le tampon flash en une seule opération
+esp_err_t commit_staging_to_flash(void);
+
+// Fonction pour ajouter une mesure dans le tampon flash avec ID unique
+// (enregistrement préparé par record_make(), voir logger.c)
+esp_err_t add_to_flash_buffer(const chiro_record_t *record);
+
+// Fonction pour compter les mesures en attente (lot RTC + tampon flash)
+int count_buffer_records(void);
+
+// Dernière mesure du tampon flash (ESP_ERR_NOT_FOUND si vide)
+esp_err_t read_last_buffer_record(chiro_record_t *record);
+
+// Dernier ID validé sur la SD (montage de la carte, reprise des ID sans NVS)
+esp_err_t read_sd_committed_id(uint32_t *last_id);
+
+// Mode dégradé : écrire directement le lot RTC sur la SD (un seul montage pour tout le lot)
+esp_err_t write_staging_to_sd(void);
+
+// Fonction pour transférer le tampon flash vers la carte SD. La copie est
+// faite par une tâche sur FLUSH_TASK_CORE, alimentée en tranches lues dans le
+// tampon flash ; retour une fois le journal validé et le tampon libéré, la
+// tâche finit seule (agrégats, démontage, LED)
+esp_err_t flush_buffer_to_sd(void);
+
+// Attendre la fin de la tâche de flush (avant le deep sleep ou un autre accès à la SD)
+void flush_buffer_wait(void);
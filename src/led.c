@@ -0,0 +1,38 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <driver/gpio.h>
+
+#include "led.h"
+
+// Fonction d'initialisation de la LED
+esp_err_t init_led(void)
+{
+    gpio_config_t io_conf = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = (1ULL << LED_PIN),
+        .pull_down_en = 0,
+        .pull_up_en = 0,
+    };
+    
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret == ESP_OK) {
+        gpio_set_level(LED_PIN, 0); // LED éteinte au démarrage
+        // ESP_LOGI(TAG, "✅ LED initialisée sur pin %d", LED_PIN);
+    }
+    return ret;
+}
+
+// Fonction pour faire clignoter la LED
+void blink_led(int count, int delay_ms)
+{
+    // ESP_LOGI(TAG, "💡 LED: %d clignotement(s)", count);
+    for (int i = 0; i < count; i++) {
+        gpio_set_level(LED_PIN, 1); // Allumer
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        gpio_set_level(LED_PIN, 0); // Éteindre
+        if (i < count - 1) { // Pas de délai après le dernier clignotement
+            vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        }
+    }
+}
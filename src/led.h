@@ -0,0 +1,12 @@
+#pragma once
+
+#include <esp_err.h>
+
+// Configuration LED pour feedback visuel
+#define LED_PIN 5  // LED intégrée sur LOLIN D32 PRO (alternative si GPIO 2 ne fonctionne pas)
+
+// Fonction d'initialisation de la LED
+esp_err_t init_led(void);
+
+// Fonction pour faire clignoter la LED
+void blink_led(int count, int delay_ms);
@@ -0,0 +1,239 @@
+#include <stdint.h>
+#include <string.h>
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+#include "logger.h"
+#include "record.h"
+#include "flash_buffer.h"
+#include "staging.h"
+#include "led.h"
+#include "metrics.h"
+#include "phase_stats.h"
+#include "scheduler.h"
+#include "aggregates.h"
+#include "timekeeper.h"
+#include "wake_stub.h"
+#include "sensor.h"
+#include "ulp_sampler.h"
+#include "storage_health.h"
+#include "event_log.h"
+
+static const char *TAG = "CHIRO_LOGGER";
+
+// Mesures du réveil en cours (voir metrics.h)
+wake_metrics_t wake_metrics;
+
+// Fonction de diagnostic du réveil
+void print_wakeup_info(void)
+{
+    esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
+    
+    switch(wakeup_reason) {
+        case ESP_SLEEP_WAKEUP_TIMER:
+            LOG_ESSENTIAL(TAG, "⏰ Réveil du deep sleep (timer)");
+            break;
+        case ESP_SLEEP_WAKEUP_ULP:
+            LOG_ESSENTIAL(TAG, "🛰️  Réveil par le coprocesseur ULP (lot de mesures)");
+            break;
+        case ESP_SLEEP_WAKEUP_UNDEFINED:
+            // ID et heure reprennent depuis la NVS (timekeeper.h)
+            LOG_ESSENTIAL(TAG, "🚀 Démarrage initial du système");
+            break;
+        default:
+            LOG_ESSENTIAL(TAG, "🔄 Réveil pour cause inconnue (%d)", wakeup_reason);
+            break;
+    }
+}
+
+// Mesures en attente à la fin du cycle (tampon flash + lot RTC), pour la mise en sommeil
+static uint32_t cycle_pending = 0;
+
+// Mesure prise par les cœurs : capteurs, ordonnanceur, agrégats, lot RTC
+// (centièmes de la mesure enregistrée en retour, pour le wake stub)
+static esp_err_t record_cpu_reading(uint32_t *sleep_sec, int32_t *temp_centi, int32_t *humidity_centi)
+{
+    uint32_t id = timekeeper_next_id(); // Unique même après une coupure (réservé en NVS)
+    
+    LOG_ESSENTIAL(TAG, "📊 Cycle de mesure #%lu", (unsigned long)id);
+    
+#if LED_CYCLE_BLINK
+    // Signal LED de début de cycle
+    blink_led(1, 30);
+#endif
+    
+    // Horodatage epoch UTC de la conversion en cours (cumul des deep sleeps, voir timekeeper.h)
+    uint32_t timestamp = timekeeper_now();
+    
+    // Pendant la conversion : montage du tampon s'il va servir à ce réveil
+    prepare_flash_buffer();
+    
+    // Relever la mesure (attente de la fin de conversion seulement)
+    int64_t phase_start = esp_timer_get_time();
+    sensor_reading_t reading;
+    if (sensors_collect(id, &reading) != ESP_OK) {
+        LOG_ESSENTIAL(TAG, "⚠️  Aucun capteur n'a répondu - mesure #%lu enregistrée sans valeurs", (unsigned long)id);
+    }
+    phase_stats_record(PHASE_SENSOR_READ, esp_timer_get_time() - phase_start);
+    
+    LOG_DEBUG(TAG, "🌡️  Mesure: T=%.1f°C, H=%.1f%%", reading.temperature, reading.humidity);
+    
+    // Intervalle avant la mesure suivante, enregistré avec la mesure
+    *sleep_sec = scheduler_update(&reading);
+    
+    // Un seul enregistrement binaire pour les agrégats, le lot RTC et le wake stub
+    chiro_record_t record;
+    record_make(&record, id, timestamp, &reading, *sleep_sec);
+    aggregates_add(&record);
+    *temp_centi = record.temperature_centi;
+    *humidity_centi = record.humidity_centi;
+    
+    // Ajouter la mesure au lot RTC (écrit en flash par lots) avec ID unique
+    phase_start = esp_timer_get_time();
+    esp_err_t ret = add_to_flash_buffer(&record);
+    phase_stats_record(PHASE_APPEND, esp_timer_get_time() - phase_start);
+    return ret;
+}
+
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_ULP
+// Mesures accumulées par l'ULP pendant le deep sleep, même chemin qu'une mesure
+// des cœurs ; ESP_ERR_NOT_FOUND si aucune (premier démarrage, coupure, ULP arrêté)
+static esp_err_t record_ulp_samples(uint32_t *sleep_sec)
+{
+    ulp_sample_t samples[ULP_SAMPLE_CAPACITY];
+    uint32_t period_sec = 0;
+    int64_t phase_start = esp_timer_get_time();
+    uint32_t count = ulp_sampler_collect(samples, ULP_SAMPLE_CAPACITY, &period_sec);
+    phase_stats_record(PHASE_SENSOR_READ, esp_timer_get_time() - phase_start);
+    if (count == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    LOG_ESSENTIAL(TAG, "🛰️  %lu mesures ULP (période %lu s)", (unsigned long)count, (unsigned long)period_sec);
+    
+    // La dernière mesure vient de réveiller l'ESP32, les précédentes sont espacées de la période
+    uint32_t now = timekeeper_now();
+    esp_err_t ret = ESP_OK;
+    phase_start = esp_timer_get_time();
+    for (uint32_t i = 0; i < count && ret == ESP_OK; i++) {
+        record_values_t values = {0};
+        RECORD_VALUE_SET(&values, temperature, ulp_sample_temperature(samples[i].temperature_raw));
+        RECORD_VALUE_SET(&values, humidity, ulp_sample_humidity(samples[i].humidity_raw));
+        uint32_t timestamp = now - (count - 1 - i) * period_sec;
+        
+        // Intervalle réellement appliqué : la période de l'ULP, sauf après la dernière mesure
+        *sleep_sec = scheduler_update(&values);
+        chiro_record_t record;
+        record_make(&record, timekeeper_next_id(), timestamp, &values, i + 1 < count ? period_sec : *sleep_sec);
+        aggregates_add(&record);
+        ret = add_to_flash_buffer(&record);
+    }
+    phase_stats_record(PHASE_APPEND, esp_timer_get_time() - phase_start);
+    return ret;
+}
+#endif
+
+// Effectuer un cycle de réveil complet, retourne la durée du deep sleep suivant (secondes)
+uint32_t chiro_wake_cycle(void)
+{
+    // Nouveau réveil : rien n'est encore monté ni mesuré
+    reset_flash_buffer_session();
+    memset(&wake_metrics, 0, sizeof(wake_metrics));
+    
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_CPU
+    // Conversions lancées tout de suite, relevées après l'heure, l'ID et le tampon
+    sensors_trigger();
+#endif
+    
+    // Heure avancée de la durée du deep sleep (ou reprise après une coupure)
+    timekeeper_boot();
+    
+    // Mesures prises par le wake stub depuis le dernier démarrage complet
+    wake_stub_replay();
+    
+    uint32_t sleep_sec = 0;
+    int32_t temp_centi = 0, humidity_centi = 0;
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_ULP
+    // Lot de l'ULP, ou une mesure des cœurs s'il n'a encore rien relevé
+    esp_err_t buffer_result = record_ulp_samples(&sleep_sec);
+    if (buffer_result == ESP_ERR_NOT_FOUND) {
+        buffer_result = record_cpu_reading(&sleep_sec, &temp_centi, &humidity_centi);
+    }
+#else
+    esp_err_t buffer_result = record_cpu_reading(&sleep_sec, &temp_centi, &humidity_centi);
+#endif
+    
+    if (buffer_result == ESP_OK) {
+        LOG_DEBUG(TAG, "🔋 Mesure stockée (lot RTC: %lu/%d)", (unsigned long)staging_count(), STAGING_BATCH_SIZE);
+        
+        // Vérifier si il faut faire un flush vers la SD
+        int64_t phase_start = esp_timer_get_time();
+        int buffer_count = count_buffer_records();
+        phase_stats_record(PHASE_BUFFER_COUNT, esp_timer_get_time() - phase_start);
+        LOG_ESSENTIAL(TAG, "📊 Tampon: %d/%d mesures", buffer_count, BUFFER_FLUSH_THRESHOLD);
+        
+        if (scheduler_flush_due((uint32_t)buffer_count)) {
+            LOG_DEBUG(TAG, "🔄 Seuil atteint - flush vers la carte SD...");
+            esp_err_t flush_result = flush_buffer_to_sd();
+            if (flush_result == ESP_OK) {
+                LOG_DEBUG(TAG, "✅ Flush réussi - tampon vidé");
+                timekeeper_checkpoint();
+                buffer_count = count_buffer_records();
+            } else {
+                LOG_DEBUG(TAG, "⚠️  Flush échoué - données conservées dans le tampon");
+            }
+        }
+        cycle_pending = (uint32_t)buffer_count;
+        
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_CPU
+        // Réveils suivants confiés au wake stub tant que rien d'autre n'est à
+        // faire, s'il sait reproduire les capteurs
+        if (sensors_stub_capable()) {
+            wake_stub_arm(sleep_sec, temp_centi, humidity_centi, cycle_pending);
+        }
+#endif
+    } else {
+        LOG_DEBUG(TAG, "⚠️  Échec stockage tampon - tentative écriture directe SD");
+        
+        // Mode dégradé: écriture directe du lot RTC sur SD
+        esp_err_t sd_result = write_staging_to_sd();
+        if (sd_result != ESP_OK) {
+            LOG_EVENT(TAG, STAGING_KEPT, staging_count(), 0);
+        }
+        cycle_pending = staging_count();
+    }
+    
+    return sleep_sec;
+}
+
+uint32_t chiro_prepare_sleep(uint32_t sleep_sec)
+{
+    // Carte SD démontée par la tâche de flush avant de couper les cœurs
+    flush_buffer_wait();
+    
+    // Octets écrits et secteurs effacés du réveil, cumulés pour les projections d'usure
+    storage_health_add_wake();
+    
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_ULP
+    // Réveil des cœurs quand le lot est à écrire ou qu'un flush peut être dû
+    uint32_t limit = cycle_pending < BUFFER_FLUSH_THRESHOLD ? BUFFER_FLUSH_THRESHOLD : BUFFER_FLUSH_DEFER_MAX;
+    uint32_t wake_after = limit > cycle_pending ? limit - cycle_pending : 1;
+    if (wake_after > ULP_SAMPLE_CAPACITY) {
+        wake_after = ULP_SAMPLE_CAPACITY;
+    }
+    if (ulp_sampler_start(sleep_sec, wake_after) == ESP_OK && esp_sleep_enable_ulp_wakeup() == ESP_OK) {
+        // Timer de secours une période après le réveil attendu (ULP bloqué)
+        timekeeper_sleep_ulp(wake_after * sleep_sec, (wake_after + 1) * sleep_sec);
+        return (wake_after + 1) * sleep_sec;
+    }
+    LOG_ESSENTIAL(TAG, "⚠️  ULP indisponible - réveil par le timer");
+#else
+    // Réveils ordinaires traités sans démarrage complet (wake_stub.h)
+    wake_stub_install();
+#endif
+    
+    // Heure d'entrée en sommeil, pour dater les mesures du prochain réveil
+    timekeeper_sleep(sleep_sec);
+    return sleep_sec;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+/*
+ * 🦇 CYCLE DE RÉVEIL DU CHIRO LOGGER
+ *
+ * Tout ce qu'un réveil fait entre le démarrage et le deep sleep : mesure,
+ * lot RTC / tampon flash, flush éventuel vers la SD. app_main() n'ajoute que
+ * le diagnostic du réveil, l'initialisation matérielle et la mise en sommeil,
+ * ce qui permet de rejouer le même cycle dans le simulateur host/ et au banc
+ * de mesure (bench.h).
+ */
+
+// Fonction de diagnostic du réveil
+void print_wakeup_info(void);
+
+// Effectuer un cycle de réveil complet, retourne la durée du deep sleep suivant (secondes)
+uint32_t chiro_wake_cycle(void);
+
+// Avant le deep sleep : fin de la tâche de flush, heure d'entrée en sommeil,
+// wake stub ou programme ULP (config.h, SAMPLING_ENGINE) ; retourne la durée
+// du timer de réveil (secondes)
+uint32_t chiro_prepare_sleep(uint32_t sleep_sec);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * 📏 MESURES DU RÉVEIL EN COURS
+ *
+ * Remplies au fil du cycle par les modules de stockage et remises à zéro au
+ * début de chiro_wake_cycle(). Le banc de mesure (bench.h) les relève après
+ * chaque cycle. Durées en µs (esp_timer_get_time), tailles en octets.
+ */
+typedef struct {
+    int64_t flash_mount_us;   // init_flash_buffer() : montage + reprise de l'état
+    uint32_t flash_mounts;
+    uint32_t flash_bytes;     // Octets écrits dans le tampon flash (par le backend, après compression,
+                              // métadonnées comprises)
+    uint32_t flash_erases;    // Secteurs effacés par le backend (RAW ; non observable avec SPIFFS)
+    uint32_t buffered_records; // Enregistrements écrits dans le tampon flash (lots RTC)
+    int64_t sd_mount_us;      // init_sd_card()
+    uint32_t sd_mounts;
+    uint32_t sd_probes;       // Montages d'une carte inconnue de la session précédente (sd_card.h)
+    int sd_freq_khz;          // Horloge SPI effective du dernier montage (0 = aucun)
+    int64_t sd_on_us;         // Carte SD alimentée (début du montage -> démontage)
+    uint32_t sd_bytes;        // CSV + marqueur de validation écrits sur la SD
+    int64_t flush_us;         // Durée de flush_buffer_to_sd()
+    uint32_t flushed_records; // Enregistrements retirés du tampon par le flush
+} wake_metrics_t;
+
+extern wake_metrics_t wake_metrics;
@@ -0,0 +1,147 @@
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_err.h>
+
+#include "phase_stats.h"
+#include "sensor.h"
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint16_t histogram[PHASE_HISTOGRAM_BINS];  // Saturé à UINT16_MAX
+} phase_counter_t;
+
+#define PHASE_STATS_MAGIC 0x53544850u  // "PHTS"
+
+typedef struct {
+    uint32_t magic;    // PHASE_STATS_MAGIC si les compteurs sont cohérents
+    uint32_t period;   // Numéro de la période en cours (une période = entre deux flushs)
+    phase_counter_t phases[PHASE_NUM];
+    phase_counter_t sensors[SENSOR_MAX_DRIVERS];  // Pilotes de capteurs, dans l'ordre de la liste
+} phase_stats_t;
+
+// Compteurs en RTC memory : remis à zéro après une perte d'alimentation
+RTC_DATA_ATTR static phase_stats_t phase_stats;
+
+static const char *const phase_names[PHASE_NUM] = {
+    [PHASE_BOOT] = "boot",
+    [PHASE_LED_INIT] = "led_init",
+    [PHASE_FLASH_MOUNT] = "flash_mount",
+    [PHASE_SENSOR_READ] = "sensor_read",
+    [PHASE_APPEND] = "append",
+    [PHASE_BUFFER_COUNT] = "count",
+    [PHASE_FLUSH] = "flush",
+    [PHASE_SD_MOUNT] = "sd_mount",
+    [PHASE_SD_PROBE] = "sd_probe",
+    [PHASE_SD_UNMOUNT] = "sd_unmount",
+    [PHASE_WAKE] = "wake",
+};
+
+static void reset_counters(void)
+{
+    memset(phase_stats.phases, 0, sizeof(phase_stats.phases));
+    memset(phase_stats.sensors, 0, sizeof(phase_stats.sensors));
+    for (int i = 0; i < PHASE_NUM; i++) {
+        phase_stats.phases[i].min_us = UINT32_MAX;
+    }
+    for (int i = 0; i < SENSOR_MAX_DRIVERS; i++) {
+        phase_stats.sensors[i].min_us = UINT32_MAX;
+    }
+}
+
+static int histogram_bin(uint32_t duration_us)
+{
+    int bin = 0;
+    for (uint32_t v = duration_us >> PHASE_HISTOGRAM_MIN_SHIFT; v != 0 && bin < PHASE_HISTOGRAM_BINS - 1; v >>= 1) {
+        bin++;
+    }
+    return bin;
+}
+
+static void counter_add(phase_counter_t *counter, int64_t duration_us)
+{
+    if (phase_stats.magic != PHASE_STATS_MAGIC) {
+        reset_counters();
+        phase_stats.period = 0;
+        phase_stats.magic = PHASE_STATS_MAGIC;
+    }
+
+    uint32_t us = duration_us < 0 ? 0 : duration_us > UINT32_MAX ? UINT32_MAX : (uint32_t)duration_us;
+    counter->count++;
+    counter->total_us += us;
+    if (us < counter->min_us) {
+        counter->min_us = us;
+    }
+    if (us > counter->max_us) {
+        counter->max_us = us;
+    }
+    uint16_t *bin = &counter->histogram[histogram_bin(us)];
+    if (*bin < UINT16_MAX) {
+        (*bin)++;
+    }
+}
+
+void phase_stats_record(wake_phase_t phase, int64_t duration_us)
+{
+    if (phase >= PHASE_NUM) {
+        return;
+    }
+    counter_add(&phase_stats.phases[phase], duration_us);
+}
+
+void phase_stats_record_sensor(uint32_t index, int64_t duration_us)
+{
+    if (index >= SENSOR_MAX_DRIVERS) {
+        return;
+    }
+    counter_add(&phase_stats.sensors[index], duration_us);
+}
+
+// Ligne CSV d'un compteur (rien s'il est vide)
+static void counter_write(FILE *file, const char *name, const char *suffix, const phase_counter_t *counter)
+{
+    if (counter->count == 0) {
+        return;
+    }
+    fprintf(file, "%lu,%s%s,%lu,%lu,%lu,%lu", (unsigned long)phase_stats.period, name, suffix,
+            (unsigned long)counter->count, (unsigned long)counter->min_us,
+            (unsigned long)(counter->total_us / counter->count), (unsigned long)counter->max_us);
+    for (int bin = 0; bin < PHASE_HISTOGRAM_BINS; bin++) {
+        fprintf(file, ",%u", counter->histogram[bin]);
+    }
+    fputc('\n', file);
+}
+
+esp_err_t phase_stats_write(FILE *file)
+{
+    if (phase_stats.magic != PHASE_STATS_MAGIC) {
+        return ESP_OK; // Rien de mesuré depuis la mise sous tension
+    }
+
+    // En-tête si le fichier est neuf
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        fputs("period,phase,count,min_us,mean_us,max_us", file);
+        for (int bin = 0; bin < PHASE_HISTOGRAM_BINS - 1; bin++) {
+            fprintf(file, ",lt%luus", 1UL << (bin + PHASE_HISTOGRAM_MIN_SHIFT));
+        }
+        fprintf(file, ",ge%luus", 1UL << (PHASE_HISTOGRAM_BINS - 2 + PHASE_HISTOGRAM_MIN_SHIFT));
+        fputc('\n', file);
+    }
+
+    for (int i = 0; i < PHASE_NUM; i++) {
+        counter_write(file, phase_names[i], "", &phase_stats.phases[i]);
+    }
+    for (uint32_t i = 0; i < SENSOR_MAX_DRIVERS; i++) {
+        counter_write(file, "sensor:", sensors_name(i), &phase_stats.sensors[i]);
+    }
+
+    if (ferror(file)) {
+        return ESP_FAIL;
+    }
+    reset_counters();
+    phase_stats.period++;
+    return ESP_OK;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "config.h"
+
+/*
+ * 📈 STATISTIQUES DE DURÉE PAR PHASE DU RÉVEIL
+ *
+ * Chaque phase du réveil est chronométrée avec esp_timer_get_time() et
+ * cumulée en RTC memory (nombre, min, max, somme, histogramme). Les
+ * compteurs sont ajoutés à SD_STATS_FILE à chaque flush puis remis à zéro :
+ * une ligne par phase et par période entre deux flushs, lisible sans câble
+ * série même quand les logs sont désactivés. Le numéro de période repart de
+ * 0 après une perte d'alimentation.
+ *
+ * Les pilotes de capteurs (sensor.h) ont chacun leur ligne sensor:<nom> :
+ * déclenchement + lecture sur le bus, sans l'attente de la conversion.
+ */
+
+typedef enum {
+    PHASE_BOOT,          // Démarrage jusqu'à app_main()
+    PHASE_LED_INIT,
+    PHASE_FLASH_MOUNT,   // init_flash_buffer() : montage + reprise de l'état
+    PHASE_SENSOR_READ,
+    PHASE_APPEND,        // add_to_flash_buffer()
+    PHASE_BUFFER_COUNT,  // count_buffer_records()
+    PHASE_FLUSH,         // flush_buffer_to_sd() complet
+    PHASE_SD_MOUNT,      // init_sd_card() avec l'état de session en RTC memory
+    PHASE_SD_PROBE,      // init_sd_card() d'une carte inconnue : sonde, infos, répertoires
+    PHASE_SD_UNMOUNT,
+    PHASE_WAKE,          // Réveil complet, du démarrage au deep sleep
+    PHASE_NUM
+} wake_phase_t;
+
+// Histogramme en puissances de 2 : classe 0 < 128 µs, classe i < 2^(i+7) µs,
+// dernière classe >= 2^21 µs (~2,1 s)
+#define PHASE_HISTOGRAM_BINS 16
+#define PHASE_HISTOGRAM_MIN_SHIFT 7
+
+// Ajouter une durée aux compteurs de la phase
+void phase_stats_record(wake_phase_t phase, int64_t duration_us);
+
+// Ajouter une durée aux compteurs du pilote de capteur index (sensor.h)
+void phase_stats_record_sensor(uint32_t index, int64_t duration_us);
+
+// Ajouter les compteurs à un fichier ouvert (lignes CSV) puis les remettre à zéro
+esp_err_t phase_stats_write(FILE *file);
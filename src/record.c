@@ -0,0 +1,178 @@
+#include "record.h"
+
+#include <math.h>
+#include <string.h>
+
+// Table par quartet (32 octets) : 4x moins d'itérations que le calcul bit à bit
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t record_crc16(const void *data, size_t len)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < len; i++) {
+        crc = (uint16_t)(crc << 4) ^ crc16_nibble[(crc >> 12) ^ (bytes[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ crc16_nibble[(crc >> 12) ^ (bytes[i] & 0x0F)];
+    }
+    return crc;
+}
+
+// Conversion float -> virgule fixe avec saturation sur la plage du champ
+static inline int32_t to_fixed(float value, float scale, int32_t min, int32_t max)
+{
+    float scaled = roundf(value * scale);
+    if (scaled < (float)min) {
+        return min;
+    }
+    if (scaled > (float)max) {
+        return max;
+    }
+    return (int32_t)scaled;
+}
+
+uint8_t record_interval_code(uint32_t seconds)
+{
+    if (seconds <= RECORD_INTERVAL_FINE_MAX) {
+        return (uint8_t)seconds;
+    }
+    if (seconds >= RECORD_INTERVAL_MAX_SEC) {
+        return 255;
+    }
+    uint32_t steps = (seconds - RECORD_INTERVAL_FINE_MAX + RECORD_INTERVAL_COARSE_STEP / 2) / RECORD_INTERVAL_COARSE_STEP;
+    return (uint8_t)(RECORD_INTERVAL_FINE_MAX + steps);
+}
+
+uint32_t record_interval_seconds(uint8_t code)
+{
+    if (code <= RECORD_INTERVAL_FINE_MAX) {
+        return code;
+    }
+    return RECORD_INTERVAL_FINE_MAX + (uint32_t)(code - RECORD_INTERVAL_FINE_MAX) * RECORD_INTERVAL_COARSE_STEP;
+}
+
+void record_make(chiro_record_t *record, uint32_t id, uint32_t epoch, const record_values_t *values,
+                 uint32_t interval_sec)
+{
+    memset(record, 0, sizeof(*record));
+    record->id = id;
+    record->epoch = epoch;
+    record->interval_code = record_interval_code(interval_sec);
+
+#define PACK_CHANNEL(name, field, type, min, max, scale, column)                       \
+    if (RECORD_VALUE_HAS(values, name)) {                                              \
+        record->field = (type)to_fixed(values->name, (float)(scale), (min), (max));    \
+    } else {                                                                           \
+        record->flags |= RECORD_FLAG_NO(name);                                         \
+    }
+    RECORD_CHANNELS(PACK_CHANNEL)
+#undef PACK_CHANNEL
+
+    record->crc = record_crc16(record, offsetof(chiro_record_t, crc));
+}
+
+void record_values(const chiro_record_t *record, record_values_t *values)
+{
+    memset(values, 0, sizeof(*values));
+#define UNPACK_CHANNEL(name, field, type, min, max, scale, column)            \
+    if (!(record->flags & RECORD_FLAG_NO(name))) {                           \
+        RECORD_VALUE_SET(values, name, (float)record->field / (float)(scale)); \
+    }
+    RECORD_CHANNELS(UNPACK_CHANNEL)
+#undef UNPACK_CHANNEL
+}
+
+bool record_is_valid(const chiro_record_t *record)
+{
+    return record->crc == record_crc16(record, offsetof(chiro_record_t, crc));
+}
+
+void record_log_header_init(record_log_header_t *header)
+{
+    memset(header, 0, sizeof(*header));
+    header->magic = RECORD_LOG_MAGIC;
+    header->version = RECORD_LOG_VERSION;
+    header->record_size = sizeof(chiro_record_t);
+    header->schema = RECORD_SCHEMA_ID;
+}
+
+bool record_log_header_check(const record_log_header_t *header)
+{
+    return header->magic == RECORD_LOG_MAGIC &&
+           (header->version == RECORD_LOG_VERSION || header->version == RECORD_LOG_VERSION_FIXED) &&
+           header->record_size == sizeof(chiro_record_t) && header->schema == RECORD_SCHEMA_ID;
+}
+
+// Écriture décimale d'un entier non signé, retourne le nombre de chiffres
+static size_t put_uint(char *out, uint32_t value)
+{
+    char digits[10];
+    size_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = digits[n - 1 - i];
+    }
+    return n;
+}
+
+// Écriture d'une valeur en virgule fixe au format "%.<decimals>f" ; appelée avec
+// des constantes par canal, elle est spécialisée à la compilation
+static inline size_t put_fixed(char *out, int32_t value, uint32_t scale, int decimals)
+{
+    size_t n = 0;
+    if (value < 0) {
+        out[n++] = '-';
+        value = -value;
+    }
+    n += put_uint(out + n, (uint32_t)value / scale);
+    if (decimals > 0) {
+        uint32_t fraction = (uint32_t)value % scale;
+        out[n++] = '.';
+        for (int i = decimals - 1; i >= 0; i--) {
+            out[n + i] = (char)('0' + fraction % 10);
+            fraction /= 10;
+        }
+        n += decimals;
+    }
+    return n;
+}
+
+size_t record_to_csv(const chiro_record_t *record, char *out, size_t size)
+{
+    // Mise en forme entière : pas de printf flottant dans la boucle de flush
+    if (size < RECORD_CSV_MAX_LEN) {
+        return 0;
+    }
+
+    size_t n = put_uint(out, record->id);
+    out[n++] = ',';
+    n += put_uint(out + n, record->epoch);
+    out[n++] = ',';
+
+#define CSV_CHANNEL(name, field, type, min, max, scale, column)                          \
+    if (record->flags & RECORD_FLAG_NO(name)) {                                         \
+        memcpy(out + n, "N/A", 3);                                                      \
+        n += 3;                                                                         \
+    } else {                                                                            \
+        n += put_fixed(out + n, record->field, (scale), RECORD_SCALE_DECIMALS(scale));  \
+    }                                                                                   \
+    out[n++] = ',';
+    RECORD_CHANNELS(CSV_CHANNEL)
+#undef CSV_CHANNEL
+
+    // Champ vide pour les mesures enregistrées avant l'échantillonnage adaptatif
+    if (record->interval_code != 0) {
+        n += put_uint(out + n, record_interval_seconds(record->interval_code));
+    }
+    out[n++] = '\n';
+    out[n] = '\0';
+
+    return n;
+}
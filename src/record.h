@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "record_schema.h"
+
+/*
+ * 📦 FORMAT BINAIRE DES MESURES
+ *
+ * Le tampon flash contient un en-tête versionné suivi des mesures : blocs
+ * compressés (version 2, voir record_codec.h) ou enregistrements de taille
+ * fixe (version 1). Aucune mise en forme texte n'a lieu au réveil : la
+ * conversion en CSV est faite uniquement au flush vers la SD (ou sur
+ * l'ordinateur avec host/chiro_export).
+ *
+ * Les canaux de mesure sont déclarés dans record_schema.h : structure,
+ * bits d'absence, CSV et codage en sont générés à la compilation. Le même
+ * chemin sert au tampon, au flush vers la SD et aux outils de host/.
+ *
+ * Toute évolution du format doit incrémenter RECORD_LOG_VERSION et garder la
+ * lecture des versions précédentes.
+ */
+
+#define RECORD_LOG_MAGIC   0x42524843u  // "CHRB" en little-endian
+#define RECORD_LOG_VERSION 2        // Blocs compressés (record_codec.h)
+#define RECORD_LOG_VERSION_FIXED 1  // Enregistrements de 16 octets, toujours relus
+
+// Drapeaux d'un enregistrement : un bit par canal absent, dans l'ordre de RECORD_CHANNELS
+#define RECORD_FLAG_NO(name) (1u << RECORD_CH_##name)
+#define RECORD_FLAG_NONE_PRESENT ((1u << RECORD_CHANNEL_COUNT) - 1)
+
+// En-tête CSV commun au tampon, à la SD et aux outils
+#define RECORD_CSV_HEADER "ID,DateTime" RECORD_CHANNELS(RECORD_CSV_COLUMN) ",Interval_s\n"
+
+// Intervalle d'échantillonnage sur un octet (0 = inconnu, mesures antérieures) :
+// codes 1..RECORD_INTERVAL_FINE_MAX en secondes, puis pas de RECORD_INTERVAL_COARSE_STEP
+// secondes jusqu'à RECORD_INTERVAL_MAX_SEC (70 min)
+#define RECORD_INTERVAL_FINE_MAX     120
+#define RECORD_INTERVAL_COARSE_STEP  30
+#define RECORD_INTERVAL_MAX_SEC      (RECORD_INTERVAL_FINE_MAX + (255 - RECORD_INTERVAL_FINE_MAX) * RECORD_INTERVAL_COARSE_STEP)
+
+// Longueur maximale d'une ligne CSV produite par record_to_csv() : ID, horodatage
+// et intervalle, puis au plus 8 caractères par canal ("-327.68,")
+#define RECORD_CSV_MAX_LEN (32 + 8 * RECORD_CHANNEL_COUNT)
+
+// Mesure avant conversion : une valeur par grandeur du catalogue, bit
+// RECORD_VALUE_BIT(nom) de present si elle a été mesurée
+#define RECORD_VALUE_MEMBER(name, field, type, min, max, scale, column) float name;
+typedef struct {
+    uint32_t present;
+    RECORD_CHANNEL_CATALOG(RECORD_VALUE_MEMBER)
+} record_values_t;
+#undef RECORD_VALUE_MEMBER
+
+#define RECORD_VALUE_BIT(name) (1u << RECORD_Q_##name)
+#define RECORD_VALUE_HAS(values, name) (((values)->present & RECORD_VALUE_BIT(name)) != 0)
+#define RECORD_VALUE_SET(values, name, value) \
+    ((values)->name = (value), (values)->present |= RECORD_VALUE_BIT(name))
+
+// En-tête du journal binaire (16 octets)
+typedef struct __attribute__((packed)) {
+    uint32_t magic;        // RECORD_LOG_MAGIC
+    uint16_t version;      // RECORD_LOG_VERSION
+    uint16_t record_size;  // sizeof(chiro_record_t) une fois décodé
+    uint32_t consumed;     // Enregistrements déjà copiés sur la SD (flush partiel)
+    uint16_t schema;       // RECORD_SCHEMA_ID (0 : canaux historiques température + humidité)
+    uint16_t reserved;
+} record_log_header_t;
+
+// Enregistrement d'une mesure (16 octets avec les canaux par défaut)
+#define RECORD_FIELD_MEMBER(name, field, type, min, max, scale, column) type field;
+typedef struct __attribute__((packed)) {
+    uint32_t id;                 // Numéro de cycle unique
+    uint32_t epoch;              // Horodatage en secondes
+    RECORD_CHANNELS(RECORD_FIELD_MEMBER)  // Canaux en virgule fixe (record_schema.h)
+    uint8_t  flags;              // RECORD_FLAG_NO(canal) pour chaque canal absent
+    uint8_t  interval_code;      // Intervalle avant la mesure suivante (record_interval_code)
+    uint16_t crc;                // CRC-16 des octets précédents
+} chiro_record_t;
+#undef RECORD_FIELD_MEMBER
+
+_Static_assert(sizeof(record_log_header_t) == 16, "en-tête de journal: 16 octets attendus");
+
+// CRC-16/CCITT-FALSE (polynôme 0x1021, valeur initiale 0xFFFF)
+uint16_t record_crc16(const void *data, size_t len);
+
+// Construire un enregistrement à partir d'une mesure (grandeurs hors RECORD_CHANNELS
+// ignorées, interval_sec = 0 si inconnu)
+void record_make(chiro_record_t *record, uint32_t id, uint32_t epoch, const record_values_t *values,
+                 uint32_t interval_sec);
+
+// Valeurs des canaux présents d'un enregistrement (arrondies à l'échelle du canal)
+void record_values(const chiro_record_t *record, record_values_t *values);
+
+// Coder un intervalle en secondes (arrondi au code le plus proche, saturé) et inversement
+uint8_t record_interval_code(uint32_t seconds);
+uint32_t record_interval_seconds(uint8_t code);
+
+// Vérifier le CRC d'un enregistrement
+bool record_is_valid(const chiro_record_t *record);
+
+// Préparer / vérifier l'en-tête d'un journal binaire (check accepte toutes les versions
+// lisibles écrites avec les mêmes canaux)
+void record_log_header_init(record_log_header_t *header);
+bool record_log_header_check(const record_log_header_t *header);
+
+// Convertir un enregistrement en ligne CSV terminée par "\n" puis '\0'.
+// Retourne la longueur de la ligne (sans le '\0'), 0 si la place manque.
+size_t record_to_csv(const chiro_record_t *record, char *out, size_t size);
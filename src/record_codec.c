@@ -0,0 +1,179 @@
+#include <string.h>
+
+#include "record_codec.h"
+
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static size_t put_varint(uint8_t *out, uint64_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+// Lecture d'un varint d'au plus 5 octets, false si la charge utile est trop courte
+static bool get_varint(const uint8_t *in, size_t size, size_t *pos, uint64_t *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= size) {
+            return false;
+        }
+        uint8_t byte = in[(*pos)++];
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Valeurs de référence du codage différentiel (début de bloc = tout à zéro)
+typedef struct {
+    uint32_t id;
+    uint32_t epoch;
+    int32_t  interval;
+#define CODEC_STATE_MEMBER(name, field, type, min, max, scale, column) type field;
+    RECORD_CHANNELS(CODEC_STATE_MEMBER)
+#undef CODEC_STATE_MEMBER
+    uint8_t  flags;
+    uint8_t  interval_code;
+} codec_state_t;
+
+static uint16_t block_crc(const record_block_header_t *header, const uint8_t *payload)
+{
+    // CRC-16 enchaîné : en-tête sans le champ crc, puis charge utile
+    uint8_t buffer[offsetof(record_block_header_t, crc) + RECORD_BLOCK_MAX_PAYLOAD];
+    memcpy(buffer, header, offsetof(record_block_header_t, crc));
+    memcpy(buffer + offsetof(record_block_header_t, crc), payload, header->payload_size);
+    return record_crc16(buffer, offsetof(record_block_header_t, crc) + header->payload_size);
+}
+
+size_t record_block_encode(const chiro_record_t *records, size_t count, uint8_t *out,
+                           size_t *used, size_t *encoded)
+{
+    record_block_header_t header = { .magic = RECORD_BLOCK_MAGIC, .format = RECORD_BLOCK_FORMAT_INTERVAL };
+    uint8_t *payload = out + sizeof(header);
+    size_t size = 0;
+    codec_state_t prev = {0};
+
+    *used = 0;
+    while (*used < count && header.count < RECORD_BLOCK_MAX_RECORDS) {
+        const chiro_record_t *record = &records[(*used)++];
+        if (!record_is_valid(record)) {
+            continue; // Enregistrement abîmé en RTC memory : ne pas lui refaire un CRC valide
+        }
+
+        int32_t interval = (int32_t)(record->epoch - prev.epoch);
+        bool flags_changed = record->flags != prev.flags;
+        bool interval_changed = record->interval_code != prev.interval_code;
+        uint64_t id_field = ((uint64_t)zigzag((int32_t)(record->id - prev.id - 1)) << 2) |
+                            ((uint64_t)interval_changed << 1) | flags_changed;
+
+        size += put_varint(payload + size, id_field);
+        if (flags_changed) {
+            payload[size++] = record->flags;
+        }
+        if (interval_changed) {
+            payload[size++] = record->interval_code;
+        }
+        size += put_varint(payload + size, zigzag(interval - prev.interval));
+#define ENCODE_CHANNEL(name, field, type, min, max, scale, column)                                   \
+        size += put_varint(payload + size, zigzag((int32_t)record->field - (int32_t)prev.field)); \
+        prev.field = record->field;
+        RECORD_CHANNELS(ENCODE_CHANNEL)
+#undef ENCODE_CHANNEL
+
+        prev.id = record->id;
+        prev.epoch = record->epoch;
+        prev.interval = interval;
+        prev.flags = record->flags;
+        prev.interval_code = record->interval_code;
+        header.count++;
+    }
+
+    *encoded = header.count;
+    if (header.count == 0) {
+        return 0;
+    }
+    header.payload_size = (uint16_t)size;
+    header.crc = block_crc(&header, payload);
+    memcpy(out, &header, sizeof(header));
+    return sizeof(header) + size;
+}
+
+bool record_block_header_check(const record_block_header_t *header)
+{
+    return header->magic == RECORD_BLOCK_MAGIC && header->format <= RECORD_BLOCK_FORMAT_INTERVAL &&
+           header->count >= 1 && header->count <= RECORD_BLOCK_MAX_RECORDS &&
+           header->payload_size <= (size_t)header->count * RECORD_BLOCK_MAX_RECORD_SIZE;
+}
+
+bool record_block_decode(const record_block_header_t *header, const uint8_t *payload, chiro_record_t *out)
+{
+    if (!record_block_header_check(header) || block_crc(header, payload) != header->crc) {
+        return false;
+    }
+
+    codec_state_t prev = {0};
+    size_t pos = 0;
+    uint64_t value;
+    int change_bits = header->format == RECORD_BLOCK_FORMAT_DELTA ? 1 : 2;
+
+    for (int i = 0; i < header->count; i++) {
+        if (!get_varint(payload, header->payload_size, &pos, &value)) {
+            return false;
+        }
+        if (value & 1) {
+            if (pos >= header->payload_size) {
+                return false;
+            }
+            prev.flags = payload[pos++];
+        }
+        if (change_bits == 2 && (value & 2)) {
+            if (pos >= header->payload_size) {
+                return false;
+            }
+            prev.interval_code = payload[pos++];
+        }
+        prev.id += (uint32_t)unzigzag((uint32_t)(value >> change_bits)) + 1;
+
+        if (!get_varint(payload, header->payload_size, &pos, &value)) {
+            return false;
+        }
+        prev.interval += unzigzag((uint32_t)value);
+        prev.epoch += (uint32_t)prev.interval;
+
+#define DECODE_CHANNEL(name, field, type, min, max, scale, column)                 \
+        if (!get_varint(payload, header->payload_size, &pos, &value)) {        \
+            return false;                                                      \
+        }                                                                      \
+        prev.field = (type)((int32_t)prev.field + unzigzag((uint32_t)value));
+        RECORD_CHANNELS(DECODE_CHANNEL)
+#undef DECODE_CHANNEL
+
+        chiro_record_t *record = &out[i];
+        memset(record, 0, sizeof(*record));
+        record->id = prev.id;
+        record->epoch = prev.epoch;
+#define COPY_CHANNEL(name, field, type, min, max, scale, column) record->field = prev.field;
+        RECORD_CHANNELS(COPY_CHANNEL)
+#undef COPY_CHANNEL
+        record->flags = prev.flags;
+        record->interval_code = prev.interval_code;
+        record->crc = record_crc16(record, offsetof(chiro_record_t, crc));
+    }
+    return pos == header->payload_size;
+}
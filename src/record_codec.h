@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "record.h"
+
+/*
+ * 🗜️ BLOCS COMPRESSÉS D'ENREGISTREMENTS (journal version 2)
+ *
+ * Entre deux mesures, l'ID augmente de 1, l'horodatage d'un intervalle presque
+ * constant et les valeurs de quelques centièmes : chaque enregistrement est
+ * codé par différence avec le précédent du bloc, en varints zigzag.
+ *
+ *   ID         : (delta - 1), suivi de 2 bits : drapeaux modifiés, intervalle modifié
+ *   drapeaux   : 1 octet, seulement s'ils changent
+ *   intervalle : 1 octet (interval_code), seulement s'il change
+ *   horodatage : delta de delta (intervalle régulier -> 0)
+ *   canaux     : delta en virgule fixe, dans l'ordre de RECORD_CHANNELS
+ *
+ * Une mesure toutes les 5 s tient en ~4 octets au lieu de 16. Le CRC de
+ * chaque enregistrement est recalculé au décodage ; l'intégrité en flash est
+ * assurée par le CRC du bloc.
+ *
+ * Les blocs RECORD_BLOCK_FORMAT_DELTA (sans intervalle, 1 seul bit après l'ID)
+ * écrits avant l'échantillonnage adaptatif restent lisibles.
+ */
+
+#define RECORD_BLOCK_MAGIC 0xB10Cu
+
+// Format de la charge utile (champ format de l'en-tête)
+#define RECORD_BLOCK_FORMAT_DELTA    0  // Drapeaux seulement
+#define RECORD_BLOCK_FORMAT_INTERVAL 1  // Drapeaux et intervalle d'échantillonnage
+
+// Enregistrements par bloc (un lot RTC de STAGING_BATCH_SIZE peut donner plusieurs blocs)
+#define RECORD_BLOCK_MAX_RECORDS 32
+
+// Pire cas par enregistrement : ID 5 + drapeaux 1 + intervalle 1 + horodatage 5 + 3 octets par canal
+#define RECORD_BLOCK_MAX_RECORD_SIZE (12 + 3 * RECORD_CHANNEL_COUNT)
+
+// En-tête d'un bloc (8 octets)
+typedef struct __attribute__((packed)) {
+    uint16_t magic;         // RECORD_BLOCK_MAGIC
+    uint8_t  count;         // Enregistrements du bloc (1..RECORD_BLOCK_MAX_RECORDS)
+    uint8_t  format;        // RECORD_BLOCK_FORMAT_*
+    uint16_t payload_size;  // Octets codés qui suivent l'en-tête
+    uint16_t crc;           // CRC-16 des 6 octets précédents puis de la charge utile
+} record_block_header_t;
+
+_Static_assert(sizeof(record_block_header_t) == 8, "en-tête de bloc: 8 octets attendus");
+
+#define RECORD_BLOCK_MAX_PAYLOAD (RECORD_BLOCK_MAX_RECORDS * RECORD_BLOCK_MAX_RECORD_SIZE)
+#define RECORD_BLOCK_MAX_SIZE    (sizeof(record_block_header_t) + RECORD_BLOCK_MAX_PAYLOAD)
+
+// Coder jusqu'à RECORD_BLOCK_MAX_RECORDS enregistrements dans out (RECORD_BLOCK_MAX_SIZE octets).
+// *used = enregistrements pris en entrée (les enregistrements au CRC invalide sont écartés),
+// *encoded = enregistrements effectivement codés. Retourne la taille du bloc (0 = bloc vide).
+size_t record_block_encode(const chiro_record_t *records, size_t count, uint8_t *out,
+                           size_t *used, size_t *encoded);
+
+// Vérifier la vraisemblance d'un en-tête de bloc (avant de lire la charge utile)
+bool record_block_header_check(const record_block_header_t *header);
+
+// Décoder un bloc dans out (header->count enregistrements). false si CRC ou codage invalide.
+bool record_block_decode(const record_block_header_t *header, const uint8_t *payload, chiro_record_t *out);
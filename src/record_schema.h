@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+/*
+ * 📐 CANAUX DES ENREGISTREMENTS
+ *
+ * Chaque grandeur mesurable est décrite une fois ici :
+ *   X(nom, champ, type, min, max, échelle, colonne CSV)
+ * - champ : membre de chiro_record_t, en virgule fixe (valeur * échelle)
+ * - type, min, max : stockage et saturation de la valeur en virgule fixe
+ * - échelle : 1, 10, 100 ou 1000, donne aussi les décimales du CSV
+ *
+ * RECORD_CHANNELS (config.h, réglages RECORD_PRESSURE...) choisit les
+ * canaux enregistrés, dans l'ordre des champs et des colonnes. Structure, bits d'absence, en-tête CSV,
+ * conversion en CSV et codage différentiel (record_codec.h) en sont déduits
+ * à la compilation : aucune boucle ni table de format par enregistrement.
+ *
+ * Température et humidité restent obligatoires (ordonnanceur, agrégats,
+ * wake stub, ULP). Avec les seuls canaux par défaut, l'enregistrement garde
+ * le format historique de 16 octets.
+ */
+
+#define RECORD_CHANNEL_TEMPERATURE(X) X(temperature, temperature_centi, int16_t, INT16_MIN, INT16_MAX, 100, "Temperature_C")
+#define RECORD_CHANNEL_HUMIDITY(X)    X(humidity, humidity_centi, uint16_t, 0, UINT16_MAX, 100, "Humidity_%")
+#define RECORD_CHANNEL_PRESSURE(X)    X(pressure, pressure_deci, uint16_t, 0, UINT16_MAX, 10, "Pressure_hPa")
+#define RECORD_CHANNEL_CO2(X)         X(co2, co2_ppm, uint16_t, 0, UINT16_MAX, 1, "CO2_ppm")
+#define RECORD_CHANNEL_BATTERY(X)     X(battery, battery_mv, uint16_t, 0, UINT16_MAX, 1000, "Battery_V")
+#define RECORD_CHANNEL_BAT_PASSES(X)  X(bat_passes, bat_passes, uint16_t, 0, UINT16_MAX, 1, "Bat_passes")
+
+// Toutes les grandeurs connues (membres de record_values_t)
+#define RECORD_CHANNEL_CATALOG(X) \
+    RECORD_CHANNEL_TEMPERATURE(X) \
+    RECORD_CHANNEL_HUMIDITY(X)    \
+    RECORD_CHANNEL_PRESSURE(X)    \
+    RECORD_CHANNEL_CO2(X)         \
+    RECORD_CHANNEL_BATTERY(X)     \
+    RECORD_CHANNEL_BAT_PASSES(X)
+
+// Canaux optionnels selon config.h
+#if RECORD_PRESSURE
+#define RECORD_OPTIONAL_PRESSURE(X) RECORD_CHANNEL_PRESSURE(X)
+#else
+#define RECORD_OPTIONAL_PRESSURE(X)
+#endif
+#if RECORD_CO2
+#define RECORD_OPTIONAL_CO2(X) RECORD_CHANNEL_CO2(X)
+#else
+#define RECORD_OPTIONAL_CO2(X)
+#endif
+#if RECORD_BATTERY
+#define RECORD_OPTIONAL_BATTERY(X) RECORD_CHANNEL_BATTERY(X)
+#else
+#define RECORD_OPTIONAL_BATTERY(X)
+#endif
+#if RECORD_BAT_PASSES
+#define RECORD_OPTIONAL_BAT_PASSES(X) RECORD_CHANNEL_BAT_PASSES(X)
+#else
+#define RECORD_OPTIONAL_BAT_PASSES(X)
+#endif
+
+// Décimales du CSV pour une échelle
+#define RECORD_SCALE_DECIMALS(scale) ((scale) >= 1000 ? 3 : (scale) >= 100 ? 2 : (scale) >= 10 ? 1 : 0)
+
+// Index des grandeurs du catalogue (bits de record_values_t.present)
+#define RECORD_QUANTITY_ENUM(name, field, type, min, max, scale, column) RECORD_Q_##name,
+enum { RECORD_CHANNEL_CATALOG(RECORD_QUANTITY_ENUM) RECORD_QUANTITY_COUNT };
+#undef RECORD_QUANTITY_ENUM
+
+// Index des canaux enregistrés (bits d'absence de chiro_record_t.flags)
+#define RECORD_CHANNEL_ENUM(name, field, type, min, max, scale, column) RECORD_CH_##name,
+enum { RECORD_CHANNELS(RECORD_CHANNEL_ENUM) RECORD_CHANNEL_COUNT };
+#undef RECORD_CHANNEL_ENUM
+
+_Static_assert(RECORD_CHANNEL_COUNT <= 8, "RECORD_CHANNELS: au plus 8 canaux (bits d'absence sur un octet)");
+
+// Colonnes CSV des canaux enregistrés (concaténées à la compilation)
+#define RECORD_CSV_COLUMN(name, field, type, min, max, scale, column) "," column
+
+// Empreinte des canaux enregistrés (en-tête des journaux binaires), constante de
+// compilation : grandeur, type et échelle de chaque canal pondérés par sa position
+#define RECORD_SCHEMA_TERM(name, field, type, min, max, scale, column)                                  \
+    +((((uint32_t)RECORD_Q_##name + 1u) * 0x9E3779B1u ^ (uint32_t)(scale) * 0x85EBCA77u ^                \
+       ((uint32_t)sizeof(type) << 8) ^ ((min) < 0 ? 0x5A5Au : 0u)) * (2u * (uint32_t)RECORD_CH_##name + 1u))
+#define RECORD_SCHEMA_HASH   ((uint32_t)(0u RECORD_CHANNELS(RECORD_SCHEMA_TERM)))
+#define RECORD_SCHEMA_HASH16 ((RECORD_SCHEMA_HASH ^ (RECORD_SCHEMA_HASH >> 16)) & 0xFFFFu)
+
+// Canaux historiques (température puis humidité) : schéma 0, celui des journaux
+// écrits avant record_schema.h. Leur empreinte est figée : modifier l'un de ces
+// deux canaux rendrait ces journaux illisibles sans changer leur schéma
+#define RECORD_SCHEMA_LEGACY_HASH 0x138DECF1u
+#define RECORD_SCHEMA_LEGACY      (RECORD_CHANNEL_COUNT == 2 && RECORD_CH_temperature == 0 && RECORD_CH_humidity == 1)
+
+#define RECORD_SCHEMA_ID \
+    ((uint16_t)(RECORD_SCHEMA_LEGACY ? 0u : RECORD_SCHEMA_HASH16 != 0 ? RECORD_SCHEMA_HASH16 : 1u))
+
+_Static_assert(!RECORD_SCHEMA_LEGACY || RECORD_SCHEMA_HASH == RECORD_SCHEMA_LEGACY_HASH,
+               "canaux historiques modifiés : les journaux de schéma 0 ne seraient plus lisibles");
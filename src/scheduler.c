@@ -0,0 +1,142 @@
+#include <math.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+
+#include "scheduler.h"
+#include "record.h"
+
+#if ADAPTIVE_SAMPLING
+static const char *TAG = "CHIRO_SCHED";
+
+#define SCHEDULER_MAGIC 0x44484353u  // "SCHD"
+
+// Dernière valeur inconnue (état RTC)
+#define SCHEDULER_NO_VALUE -999.0f
+
+// Poids de la dernière mesure dans la variance glissante (1/8 : ~8 mesures de mémoire)
+#define SCHEDULER_EWMA_SHIFT 3
+
+typedef struct {
+    uint32_t magic;         // SCHEDULER_MAGIC si l'état est cohérent
+    uint32_t interval_sec;  // Intervalle en cours
+    float last_temperature;
+    float last_humidity;
+    float var_temperature;  // Variance glissante des écarts entre mesures (°C²)
+    float var_humidity;     // (%²)
+    float activity;         // Dernier niveau d'activité (1 = seuil de changement)
+} scheduler_state_t;
+
+// État en RTC memory : repart de l'intervalle minimal après une perte d'alimentation
+RTC_DATA_ATTR static scheduler_state_t scheduler;
+
+static void scheduler_reset(void)
+{
+    scheduler.magic = SCHEDULER_MAGIC;
+    scheduler.interval_sec = SAMPLE_INTERVAL_MIN_SEC;
+    scheduler.last_temperature = SCHEDULER_NO_VALUE;
+    scheduler.last_humidity = SCHEDULER_NO_VALUE;
+    scheduler.var_temperature = 0.0f;
+    scheduler.var_humidity = 0.0f;
+    scheduler.activity = 1.0f;
+}
+
+// Écart normalisé par le seuil de changement, variance glissante mise à jour
+// (-1 : pas de mesure précédente à comparer)
+static float channel_activity(bool present, float value, float *last, float *variance, float threshold)
+{
+    if (!present) {
+        return -1.0f;
+    }
+    if (*last == SCHEDULER_NO_VALUE) {
+        *last = value;
+        return -1.0f;
+    }
+
+    float delta = value - *last;
+    *last = value;
+    *variance += (delta * delta - *variance) / (float)(1 << SCHEDULER_EWMA_SHIFT);
+
+    float instant = fabsf(delta) / threshold;
+    float recent = sqrtf(*variance) / threshold;
+    return instant > recent ? instant : recent;
+}
+#endif
+
+// Arrondi au codage des enregistrements, dans les bornes configurées
+static uint32_t clamp_interval(uint32_t seconds)
+{
+    if (seconds < SAMPLE_INTERVAL_MIN_SEC) {
+        seconds = SAMPLE_INTERVAL_MIN_SEC;
+    }
+    if (seconds > SAMPLE_INTERVAL_MAX_SEC) {
+        seconds = SAMPLE_INTERVAL_MAX_SEC;
+    }
+    seconds = record_interval_seconds(record_interval_code(seconds));
+    return seconds > SAMPLE_INTERVAL_MAX_SEC ? seconds - RECORD_INTERVAL_COARSE_STEP : seconds;
+}
+
+uint32_t scheduler_update(const record_values_t *values)
+{
+#if ADAPTIVE_SAMPLING
+    if (scheduler.magic != SCHEDULER_MAGIC) {
+        scheduler_reset();
+    }
+    float activity_t = channel_activity(RECORD_VALUE_HAS(values, temperature), values->temperature,
+                                        &scheduler.last_temperature, &scheduler.var_temperature,
+                                        SAMPLE_CHANGE_TEMPERATURE);
+    float activity_h = channel_activity(RECORD_VALUE_HAS(values, humidity), values->humidity,
+                                        &scheduler.last_humidity, &scheduler.var_humidity,
+                                        SAMPLE_CHANGE_HUMIDITY);
+    float activity = activity_t > activity_h ? activity_t : activity_h;
+    if (activity < 0.0f) {
+        return scheduler.interval_sec;  // Première mesure ou capteurs absents : garder l'intervalle
+    }
+    scheduler.activity = activity;
+
+    uint32_t interval = scheduler.interval_sec;
+    if (scheduler.activity >= 1.0f) {
+        interval = SAMPLE_INTERVAL_MIN_SEC;  // Changement net : mesurer au plus vite
+    } else if (scheduler.activity >= 0.5f) {
+        interval /= 2;
+    } else if (scheduler.activity < 0.25f) {
+        interval *= 2;                       // Cavité stable : espacer les mesures
+    }
+    interval = clamp_interval(interval);
+
+    if (interval != scheduler.interval_sec) {
+        LOG_ESSENTIAL(TAG, "🕰️  Intervalle %lu s -> %lu s (activité %.2f)", (unsigned long)scheduler.interval_sec,
+                  (unsigned long)interval, (double)scheduler.activity);
+        scheduler.interval_sec = interval;
+    }
+    return interval;
+#else
+    (void)values;
+    return DEEP_SLEEP_DURATION_SEC;
+#endif
+}
+
+uint32_t scheduler_interval_min(void)
+{
+    return clamp_interval(SAMPLE_INTERVAL_MIN_SEC);
+}
+
+uint32_t scheduler_interval_max(void)
+{
+    return clamp_interval(SAMPLE_INTERVAL_MAX_SEC);
+}
+
+bool scheduler_flush_due(uint32_t pending)
+{
+    if (pending < BUFFER_FLUSH_THRESHOLD) {
+        return false;
+    }
+#if ADAPTIVE_SAMPLING
+    // Mesures en mouvement : garder les réveils courts, flusher au retour du calme
+    if (scheduler.magic == SCHEDULER_MAGIC && scheduler.activity >= 0.5f && pending < BUFFER_FLUSH_DEFER_MAX) {
+        LOG_DEBUG(TAG, "⏳ Flush repoussé (activité %.2f, %lu mesures)", (double)scheduler.activity,
+                  (unsigned long)pending);
+        return false;
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "record.h"
+
+/*
+ * 🕰️ ÉCHANTILLONNAGE ADAPTATIF ET PLANIFICATION DES FLUSHS
+ *
+ * L'intervalle avant la mesure suivante dépend de la variation récente des
+ * mesures, suivie en RTC memory (variance glissante des écarts entre deux
+ * mesures) : retour immédiat à SAMPLE_INTERVAL_MIN_SEC quand une mesure
+ * s'écarte nettement de la précédente (porte ouverte, essaim qui arrive),
+ * doublement jusqu'à SAMPLE_INTERVAL_MAX_SEC quand la cavité est stable.
+ *
+ * Le flush vers la SD, qui allonge le réveil, est repoussé tant que les
+ * mesures bougent, dans la limite de BUFFER_FLUSH_DEFER_MAX mesures.
+ *
+ * Les intervalles choisis sont arrondis au codage de record.h, pour que
+ * l'intervalle enregistré avec chaque mesure soit exactement celui appliqué.
+ * Avec ADAPTIVE_SAMPLING à 0 : DEEP_SLEEP_DURATION_SEC et flush au seuil fixe.
+ */
+
+#if ADAPTIVE_SAMPLING
+_Static_assert(SAMPLE_INTERVAL_MIN_SEC >= 1 && SAMPLE_INTERVAL_MIN_SEC <= SAMPLE_INTERVAL_MAX_SEC,
+               "SAMPLE_INTERVAL_MIN_SEC doit être compris entre 1 et SAMPLE_INTERVAL_MAX_SEC");
+_Static_assert(SAMPLE_INTERVAL_MAX_SEC <= RECORD_INTERVAL_MAX_SEC,
+               "SAMPLE_INTERVAL_MAX_SEC dépasse l'intervalle codable dans un enregistrement");
+#endif
+_Static_assert(BUFFER_FLUSH_DEFER_MAX >= BUFFER_FLUSH_THRESHOLD,
+               "BUFFER_FLUSH_DEFER_MAX doit être supérieur ou égal à BUFFER_FLUSH_THRESHOLD");
+
+// Prendre en compte une mesure (température et humidité, absentes ignorées), retourne
+// l'intervalle avant la mesure suivante en secondes
+uint32_t scheduler_update(const record_values_t *values);
+
+// Bornes effectives de l'intervalle (arrondies au codage des enregistrements)
+uint32_t scheduler_interval_min(void);
+uint32_t scheduler_interval_max(void);
+
+// Le flush vers la SD doit-il avoir lieu à ce réveil ? (pending = mesures en attente)
+bool scheduler_flush_due(uint32_t pending);
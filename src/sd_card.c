@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_vfs_fat.h>
+#include <sdmmc_cmd.h>
+#include <driver/sdmmc_host.h>
+#include <driver/sdspi_host.h>
+#include <driver/spi_common.h>
+#include <sys/stat.h>
+
+#include "sd_card.h"
+#include "metrics.h"
+#include "phase_stats.h"
+#include "event_log.h"
+
+static const char *TAG = "CHIRO_SD";
+
+// Configuration des pins pour le slot SD sur LOLIN D32 PRO
+#define PIN_NUM_MISO 19
+#define PIN_NUM_MOSI 23
+#define PIN_NUM_CLK  18
+#define PIN_NUM_CS   4
+
+// Carte SD alimentée depuis sd_power_on_us (temps compté dans wake_metrics au démontage)
+static bool sd_powered = false;
+static int64_t sd_power_on_us = 0;
+
+// Carte de la session en cours (requise par esp_vfs_fat_sdcard_unmount)
+static sdmmc_card_t *mounted_card = NULL;
+
+// État de la carte conservé en RTC memory d'une session à l'autre : tant que
+// la même carte répond, ni affichage de ses caractéristiques, ni stat/mkdir
+// des répertoires déjà vérifiés, et montage directement à l'horloge retenue
+#define SD_SESSION_MAGIC 0x53534443u  // "CDSS"
+typedef struct {
+    uint32_t magic;
+    int serial;           // Numéro de série (CID) : une autre carte repart de zéro
+    int capacity;         // Secteurs (CSD)
+    int sector_size;
+    int freq_khz;         // Horloge SPI demandée au dernier montage réussi
+    int real_freq_khz;    // Horloge effective après la sonde
+    uint32_t month;       // Dernier répertoire AAAA/MM vérifié (0 = aucun)
+    bool work_dir_ready;  // SD_WORK_DIR vérifié
+} sd_session_t;
+
+RTC_DATA_ATTR static sd_session_t sd_session;
+
+// Bus SPI : initialisé au premier montage du démarrage, jamais libéré (voir unmount_sd_card)
+static esp_err_t init_spi_bus(int slot)
+{
+    spi_bus_config_t bus_cfg = {
+        .mosi_io_num = PIN_NUM_MOSI,
+        .miso_io_num = PIN_NUM_MISO,
+        .sclk_io_num = PIN_NUM_CLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = 4000,
+    };
+    esp_err_t ret = spi_bus_initialize(slot, &bus_cfg, SDSPI_DEFAULT_DMA);
+    if (ret == ESP_ERR_INVALID_STATE) {
+        // Le bus SPI est déjà initialisé, c'est normal lors d'une récupération
+        LOG_DEBUG(TAG, "Bus SPI déjà initialisé (récupération)");
+        return ESP_OK;
+    }
+    if (ret != ESP_OK) {
+        LOG_EVENT(TAG, SD_SPI_BUS_FAILED, ret, 0);
+    }
+    return ret;
+}
+
+// Sonde de la carte (400 kHz) puis montage FAT à l'horloge la plus haute
+// commune à l'hôte (freq_khz) et à la carte
+static esp_err_t mount_at(int freq_khz, sdmmc_card_t **card)
+{
+    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
+        .format_if_mount_failed = false,  // ⚠️ SÉCURITÉ: Pas de formatage automatique pour préserver les données
+        .max_files = 5,
+        .allocation_unit_size = SD_FLUSH_BLOCK_SIZE,
+        .disk_status_check_enable = false  // Désactiver la vérification de statut
+    };
+
+    sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+    host.max_freq_khz = freq_khz;
+    esp_err_t ret = init_spi_bus(host.slot);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Configuration du slot SPI pour la carte SD
+    sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT();
+    slot_config.gpio_cs = PIN_NUM_CS;
+    slot_config.host_id = host.slot;
+
+    LOG_DEBUG(TAG, "Montage du système de fichiers FAT (%d kHz max)...", freq_khz);
+    return esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, card);
+}
+
+static void log_mount_error(esp_err_t ret)
+{
+    LOG_EVENT(TAG, SD_MOUNT_FAILED, ret, 0);
+    if (ret == ESP_FAIL) {
+        LOG_DEBUG(TAG, "💡 Solutions possibles:");
+        LOG_DEBUG(TAG, "   1. Vérifiez que la carte SD est bien insérée");
+        LOG_DEBUG(TAG, "   2. Formatez la carte SD en FAT32 sur votre ordinateur");
+        LOG_DEBUG(TAG, "   3. Utilisez une carte SD différente");
+        LOG_DEBUG(TAG, "   4. Vérifiez que la carte SD n'est pas corrompue");
+        LOG_DEBUG(TAG, "ℹ️  Le formatage automatique est désactivé pour préserver vos données");
+    } else {
+        LOG_DEBUG(TAG, "💡 Vérifiez que la carte SD est insérée et correctement connectée.");
+    }
+}
+
+// Montage de la carte SD (bus SPI + FAT) ; *probed = carte inconnue de la session précédente
+static esp_err_t mount_sd_card(bool *probed)
+{
+    LOG_DEBUG(TAG, "Initialisation de la carte microSD...");
+
+    bool known = sd_session.magic == SD_SESSION_MAGIC;
+    int freq_khz = known ? sd_session.freq_khz : SD_SPI_FREQ_KHZ_MAX;
+    sdmmc_card_t *card;
+    esp_err_t ret = mount_at(freq_khz, &card);
+
+    // Horloge trop haute pour la carte ou le câblage : nouvelle sonde à la fréquence
+    // sûre (pas de réponse du tout = carte absente, inutile de réessayer)
+    if (ret != ESP_OK && ret != ESP_ERR_TIMEOUT && freq_khz > SD_SPI_FREQ_KHZ_SAFE) {
+        LOG_EVENT(TAG, SD_MOUNT_RETRY, freq_khz, ret);
+        freq_khz = SD_SPI_FREQ_KHZ_SAFE;
+        ret = mount_at(freq_khz, &card);
+    }
+    if (ret != ESP_OK) {
+        log_mount_error(ret);
+        return ret;
+    }
+    LOG_DEBUG(TAG, "Système de fichiers monté");
+    mounted_card = card;
+
+    // Autre carte (ou RTC memory perdue) : caractéristiques affichées, répertoires à vérifier
+    *probed = !known || card->cid.serial != sd_session.serial || card->csd.capacity != sd_session.capacity ||
+              card->csd.sector_size != sd_session.sector_size;
+    if (*probed) {
+        LOG_EVENT(TAG, SD_CARD_PROBED, card->csd.capacity, card->csd.sector_size);
+#ifndef PRODUCTION_MODE
+        sdmmc_card_print_info(stdout, card);
+#endif
+        sd_session.serial = card->cid.serial;
+        sd_session.capacity = card->csd.capacity;
+        sd_session.sector_size = card->csd.sector_size;
+        sd_session.month = 0;
+        sd_session.work_dir_ready = false;
+    }
+    sd_session.freq_khz = freq_khz;
+    sd_session.real_freq_khz = card->real_freq_khz;
+    sd_session.magic = SD_SESSION_MAGIC;
+
+    // Créer le répertoire de travail pour le projet
+    if (!sd_session.work_dir_ready) {
+        const char* work_dir = SD_WORK_DIR;
+        struct stat st;
+        if (stat(work_dir, &st) != 0) {
+            LOG_DEBUG(TAG, "Création du répertoire de travail: %s", work_dir);
+            if (mkdir(work_dir, 0755) != 0) {
+                LOG_EVENT(TAG, SD_WORK_DIR_FAILED, 0, 0);
+            } else {
+                LOG_DEBUG(TAG, "✅ Répertoire de travail créé: %s", work_dir);
+                sd_session.work_dir_ready = true;
+            }
+        } else {
+            LOG_DEBUG(TAG, "✅ Répertoire de travail existe déjà: %s", work_dir);
+            sd_session.work_dir_ready = true;
+        }
+    }
+
+    return ESP_OK;
+}
+
+// Fonction d'initialisation de la carte SD
+esp_err_t init_sd_card(void)
+{
+    bool probed = false;
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = mount_sd_card(&probed);
+    int64_t end = esp_timer_get_time();
+    
+    wake_metrics.sd_mounts++;
+    wake_metrics.sd_mount_us += end - start;
+    phase_stats_record(probed ? PHASE_SD_PROBE : PHASE_SD_MOUNT, end - start);
+    if (ret == ESP_OK) {
+        sd_powered = true;
+        sd_power_on_us = start;
+        wake_metrics.sd_probes += probed ? 1 : 0;
+        wake_metrics.sd_freq_khz = sd_session.real_freq_khz;
+        LOG_EVENT(TAG, SD_MOUNTED, (end - start) / 1000, sd_session.real_freq_khz);
+    } else {
+        wake_metrics.sd_on_us += end - start;
+    }
+    return ret;
+}
+
+uint32_t sd_card_known_month(void)
+{
+    return sd_session.magic == SD_SESSION_MAGIC ? sd_session.month : 0;
+}
+
+void sd_card_set_known_month(uint32_t month)
+{
+    sd_session.month = month;
+}
+
+void sd_card_forget_dirs(void)
+{
+    sd_session.month = 0;
+    sd_session.work_dir_ready = false;
+}
+
+// Fonction de test d'écriture sur la carte SD
+esp_err_t test_sd_card(void)
+{
+    ESP_LOGI(TAG, "Test d'écriture sur la carte SD...");
+    
+    // Vérifier que le point de montage existe
+    struct stat st;
+    if (stat(MOUNT_POINT, &st) != 0) {
+        ESP_LOGE(TAG, "Point de montage %s n'existe pas", MOUNT_POINT);
+        return ESP_FAIL;
+    }
+    
+    ESP_LOGI(TAG, "Point de montage %s existe", MOUNT_POINT);
+    
+    // Essayer d'abord avec un chemin dans le répertoire du projet
+    const char* test_file = SD_WORK_DIR "/test.txt";
+    ESP_LOGI(TAG, "Tentative d'écriture dans: %s", test_file);
+    
+    FILE *f = fopen(test_file, "w");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Erreur: impossible d'ouvrir %s pour écriture", test_file);
+        
+        // Essayer avec un nom de fichier différent dans le répertoire racine
+        test_file = MOUNT_POINT "/CHIRO.txt";
+        ESP_LOGI(TAG, "Tentative avec un autre nom: %s", test_file);
+        f = fopen(test_file, "w");
+        
+        if (f == NULL) {
+            ESP_LOGE(TAG, "Erreur: impossible d'ouvrir %s pour écriture", test_file);
+            ESP_LOGE(TAG, "💡 Vérifiez les permissions de la carte SD");
+            return ESP_FAIL;
+        }
+    }
+    
+    // Écrire des données simples
+    fprintf(f, "Chiro Logger Test\n");
+    fprintf(f, "Timestamp: %lld\n", (long long)esp_timer_get_time());
+    fprintf(f, "Status: OK\n");
+    fclose(f);
+    
+    ESP_LOGI(TAG, "Fichier %s écrit avec succès", test_file);
+    
+    // Lire le fichier pour vérifier
+    f = fopen(test_file, "r");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Erreur: impossible d'ouvrir le fichier pour lecture");
+        return ESP_FAIL;
+    }
+    
+    char line[64];
+    ESP_LOGI(TAG, "Contenu du fichier de test:");
+    while (fgets(line, sizeof(line), f)) {
+        // Retirer le \n pour l'affichage
+        char* pos = strchr(line, '\n');
+        if (pos) *pos = '\0';
+        ESP_LOGI(TAG, "  %s", line);
+    }
+    fclose(f);
+    
+    return ESP_OK;
+}
+
+// Fonction pour démonter proprement la carte SD
+esp_err_t unmount_sd_card(void)
+{
+    LOG_DEBUG(TAG, "Démontage de la carte SD...");
+    
+    // Démonter le système de fichiers
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = esp_vfs_fat_sdcard_unmount(MOUNT_POINT, mounted_card);
+    mounted_card = NULL;
+    phase_stats_record(PHASE_SD_UNMOUNT, esp_timer_get_time() - start);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Erreur lors du démontage: %s", esp_err_to_name(ret));
+        // Continuer même en cas d'erreur
+    }
+    
+    // NE PAS libérer le bus SPI automatiquement - cela cause des crashes
+    // Le bus sera automatiquement réinitialisé lors de la prochaine tentative de montage
+    LOG_DEBUG(TAG, "Démontage terminé (bus SPI conservé)");
+    
+    if (sd_powered) {
+        wake_metrics.sd_on_us += esp_timer_get_time() - sd_power_on_us;
+        sd_powered = false;
+    }
+    return ESP_OK;
+}
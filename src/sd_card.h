@@ -0,0 +1,36 @@
+#pragma once
+
+#include <esp_err.h>
+
+#include "config.h"
+
+/*
+ * 💾 CARTE microSD (slot SPI du LOLIN D32 PRO)
+ *
+ * La carte n'est montée que le temps d'un flush ou d'une écriture en mode
+ * dégradé, puis démontée pour couper sa consommation.
+ *
+ * Session : la RTC memory garde d'un montage à l'autre l'identité de la
+ * carte (CID, géométrie), l'horloge SPI retenue et les répertoires déjà
+ * vérifiés. Seul le premier montage d'une carte (ou après une perte
+ * d'alimentation) affiche ses caractéristiques et vérifie SD_WORK_DIR ; il
+ * demande SD_SPI_FREQ_KHZ_MAX et se replie sur SD_SPI_FREQ_KHZ_SAFE si la
+ * carte ne suit pas. Durées : lignes sd_probe (premier montage) et sd_mount
+ * (montages suivants) de SD_STATS_FILE, wake_metrics pour le banc.
+ */
+
+// Fonction d'initialisation de la carte SD (montage FAT + création de SD_WORK_DIR)
+esp_err_t init_sd_card(void);
+
+// Dernier répertoire mensuel vérifié sur la carte (année * 12 + mois, 0 = aucun)
+uint32_t sd_card_known_month(void);
+void sd_card_set_known_month(uint32_t month);
+
+// Erreur d'écriture : revérifier les répertoires à la prochaine ouverture
+void sd_card_forget_dirs(void);
+
+// Fonction de test d'écriture sur la carte SD
+esp_err_t test_sd_card(void);
+
+// Fonction pour démonter proprement la carte SD
+esp_err_t unmount_sd_card(void);
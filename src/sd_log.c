@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <esp_log.h>
+
+#include "sd_log.h"
+#include "sd_card.h"
+#include "metrics.h"
+#include "event_log.h"
+
+static const char *TAG = "CHIRO_SDLOG";
+
+#define SD_COMMIT_MAGIC    0x32434843u  // "CHC2"
+#define SD_COMMIT_MAGIC_V1 0x4D434843u  // "CHCM" : data.csv unique des firmwares antérieurs
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;     // SD_COMMIT_MAGIC
+    uint32_t day;       // Jour du fichier en cours d'écriture (SD_LOG_NO_DAY = aucun)
+    uint32_t size;      // Taille validée de ce fichier (lignes complètes uniquement)
+    uint32_t last_id;   // ID du dernier enregistrement du tampon validé (0 = aucun)
+    uint16_t crc;       // CRC-16 des 16 octets précédents
+    uint16_t sequence;  // Numéro d'écriture : l'emplacement au numéro le plus récent fait foi
+} sd_commit_t;
+
+// Deux emplacements dans des secteurs distincts, réécrits en alternance et sans
+// tronquer le fichier : une écriture interrompue laisse l'autre intact
+#define SD_COMMIT_SLOTS       2
+#define SD_COMMIT_SLOT_OFFSET 512
+
+// Marqueur des firmwares antérieurs : seul l'ID validé est repris
+typedef struct __attribute__((packed)) {
+    uint32_t magic;     // SD_COMMIT_MAGIC_V1
+    uint32_t csv_size;
+    uint32_t last_id;
+    uint16_t crc;
+    uint16_t reserved;
+} sd_commit_v1_t;
+
+static bool commit_slot_valid(const sd_commit_t *commit, size_t n)
+{
+    return n == sizeof(*commit) && commit->magic == SD_COMMIT_MAGIC &&
+           commit->crc == record_crc16(commit, offsetof(sd_commit_t, crc));
+}
+
+static bool read_sd_commit(sd_commit_t *commit)
+{
+    FILE *file = fopen(SD_COMMIT_FILE, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    bool found = false;
+    sd_commit_t slot;
+    size_t first = 0;
+    for (int i = 0; i < SD_COMMIT_SLOTS; i++) {
+        size_t n = fseek(file, (long)i * SD_COMMIT_SLOT_OFFSET, SEEK_SET) == 0 ? fread(&slot, 1, sizeof(slot), file) : 0;
+        if (i == 0) {
+            first = n;
+            memcpy(commit, &slot, n);
+        }
+        // Numéros comparés modulo 2^16
+        if (commit_slot_valid(&slot, n) && (!found || (int16_t)(slot.sequence - commit->sequence) > 0)) {
+            *commit = slot;
+            found = true;
+        }
+    }
+    fclose(file);
+    if (found) {
+        return true;
+    }
+
+    sd_commit_v1_t v1;
+    memcpy(&v1, commit, sizeof(v1));
+    if (first >= sizeof(v1) && v1.magic == SD_COMMIT_MAGIC_V1 &&
+        v1.crc == record_crc16(&v1, offsetof(sd_commit_v1_t, crc))) {
+        commit->day = SD_LOG_NO_DAY;
+        commit->size = 0;
+        commit->last_id = v1.last_id;
+        commit->sequence = 0;
+        return true;
+    }
+    return false;
+}
+
+static esp_err_t write_sd_commit(sd_log_writer_t *writer, uint32_t day, uint32_t size, uint32_t last_id)
+{
+    sd_commit_t commit = {
+        .magic = SD_COMMIT_MAGIC,
+        .day = day,
+        .size = size,
+        .last_id = last_id,
+        .sequence = (uint16_t)(writer->commit_sequence + 1),
+    };
+    commit.crc = record_crc16(&commit, offsetof(sd_commit_t, crc));
+
+    // "wb" seulement à la création : tronquer effacerait aussi l'emplacement valide
+    FILE *file = fopen(SD_COMMIT_FILE, "r+b");
+    if (file == NULL) {
+        file = fopen(SD_COMMIT_FILE, "wb");
+    }
+    if (file == NULL) {
+        return ESP_FAIL;
+    }
+    long offset = (long)(commit.sequence % SD_COMMIT_SLOTS) * SD_COMMIT_SLOT_OFFSET;
+    bool ok = fseek(file, offset, SEEK_SET) == 0 && fwrite(&commit, sizeof(commit), 1, file) == 1 &&
+              fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0 || !ok) {
+        return ESP_FAIL;
+    }
+    writer->commit_sequence = commit.sequence;
+    wake_metrics.sd_bytes += sizeof(commit);
+    return ESP_OK;
+}
+
+// Chemin du fichier d'un jour ; crée les répertoires année et mois si create_dirs,
+// sauf s'ils ont déjà été vérifiés sur cette carte (sd_card.h)
+static void day_path(uint32_t day, char *path, size_t size, bool create_dirs)
+{
+    time_t t = (time_t)day * SD_LOG_SECONDS_PER_DAY;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+
+    uint32_t month = (uint32_t)(tm.tm_year + 1900) * 12 + (uint32_t)tm.tm_mon + 1;
+    if (create_dirs && month != sd_card_known_month()) {
+        struct stat st;
+        snprintf(path, size, SD_WORK_DIR "/%04d", tm.tm_year + 1900);
+        if (stat(path, &st) != 0) {
+            mkdir(path, 0755);
+        }
+        snprintf(path, size, SD_WORK_DIR "/%04d/%02d", tm.tm_year + 1900, tm.tm_mon + 1);
+        if (stat(path, &st) == 0 || mkdir(path, 0755) == 0) {
+            sd_card_set_known_month(month);
+        }
+    }
+    snprintf(path, size, SD_WORK_DIR SD_DAY_PATH_FORMAT, tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+}
+
+static uint32_t file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? (uint32_t)st.st_size : 0;
+}
+
+// Retirer une éventuelle dernière ligne incomplète (fichier sans marqueur valide)
+static esp_err_t trim_incomplete_line(const char *path, uint32_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        *size = 0;
+        return ESP_OK;
+    }
+
+    char tail[RECORD_CSV_MAX_LEN * 4];
+    uint32_t from = *size > sizeof(tail) ? *size - sizeof(tail) : 0;
+    fseek(file, from, SEEK_SET);
+    size_t n = fread(tail, 1, sizeof(tail), file);
+    fclose(file);
+
+    while (n > 0 && tail[n - 1] != '\n') {
+        n--;
+    }
+    uint32_t valid_size = from + n;
+    if (valid_size != *size) {
+        LOG_EVENT(TAG, SD_LOG_LINE_TRIMMED, *size, valid_size);
+        if (truncate(path, valid_size) != 0) {
+            return ESP_FAIL;
+        }
+        *size = valid_size;
+    }
+    return ESP_OK;
+}
+
+// Ouvrir le fichier d'un jour en ajout, après avoir fait pointer le marqueur dessus
+static esp_err_t open_day(sd_log_writer_t *writer, uint32_t day)
+{
+    char path[64];
+    day_path(day, path, sizeof(path), true);
+    uint32_t size = file_size(path);
+
+    if (day != writer->day) {
+        if (trim_incomplete_line(path, &size) != ESP_OK ||
+            write_sd_commit(writer, day, size, writer->committed_id) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        writer->day = day;
+    }
+
+    writer->file = fopen(path, "a");
+    if (writer->file == NULL && sd_card_known_month() != 0) {
+        // Répertoire supprimé depuis sa vérification (carte relue sur un ordinateur)
+        sd_card_forget_dirs();
+        day_path(day, path, sizeof(path), true);
+        writer->file = fopen(path, "a");
+    }
+    if (writer->file == NULL) {
+        ESP_LOGE(TAG, "❌ Impossible d'ouvrir %s", path);
+        return ESP_FAIL;
+    }
+    // Écritures envoyées telles quelles à FATFS, sans recopie dans le tampon stdio
+    setvbuf(writer->file, NULL, _IONBF, 0);
+
+    writer->file_size = size;
+    writer->limit = SD_FLUSH_BLOCK_SIZE - (size_t)(size % SD_FLUSH_BLOCK_SIZE);
+    if (size == 0) {
+        memcpy(writer->block, RECORD_CSV_HEADER, sizeof(RECORD_CSV_HEADER) - 1);
+        writer->fill = sizeof(RECORD_CSV_HEADER) - 1;
+    }
+    return ESP_OK;
+}
+
+static void close_day(sd_log_writer_t *writer)
+{
+    if (writer->file != NULL) {
+        if (fclose(writer->file) != 0) {
+            writer->error = true;
+        }
+        writer->file = NULL;
+    }
+}
+
+uint32_t sd_log_committed_id(void)
+{
+    sd_commit_t commit;
+    return read_sd_commit(&commit) ? commit.last_id : 0;
+}
+
+esp_err_t sd_log_open(sd_log_writer_t *writer, char *block, bool track_ids)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->block = block;
+    writer->limit = SD_FLUSH_BLOCK_SIZE;
+    writer->track_ids = track_ids;
+    writer->day = SD_LOG_NO_DAY;
+
+    sd_commit_t commit = {0};
+    if (read_sd_commit(&commit)) {
+        writer->committed_id = commit.last_id;
+        writer->day = commit.day;
+        writer->commit_sequence = commit.sequence;
+    }
+
+    // Écriture interrompue dans le fichier du jour en cours : annuler la partie non validée
+    if (writer->day != SD_LOG_NO_DAY) {
+        char path[64];
+        day_path(writer->day, path, sizeof(path), false);
+        uint32_t size = file_size(path);
+        if (size > commit.size) {
+            LOG_EVENT(TAG, SD_LOG_TRUNCATED, size, commit.size);
+            if (truncate(path, commit.size) != 0) {
+                return ESP_FAIL;
+            }
+        }
+    }
+
+    writer->index = fopen(SD_INDEX_FILE, "ab");
+    if (writer->index == NULL) {
+        ESP_LOGW(TAG, "⚠️  Index %s indisponible", SD_INDEX_FILE);
+    }
+    return ESP_OK;
+}
+
+void sd_log_flush_block(sd_log_writer_t *writer)
+{
+    if (writer->fill > 0 && !writer->error) {
+        uint32_t last_id = writer->track_ids ? writer->block_last_id : writer->committed_id;
+        bool ok = fwrite(writer->block, 1, writer->fill, writer->file) == writer->fill &&
+                  fsync(fileno(writer->file)) == 0;
+        if (ok) {
+            ok = write_sd_commit(writer, writer->day, writer->file_size + writer->fill, last_id) == ESP_OK;
+        }
+        if (!ok) {
+            writer->error = true;
+        } else {
+            writer->written += writer->fill;
+            wake_metrics.sd_bytes += writer->fill;
+            writer->file_size += writer->fill;
+            writer->committed_id = last_id;
+
+            if (writer->block_indexed && writer->index != NULL) {
+                sd_index_entry_t *entry = &writer->block_entry;
+                entry->crc = record_crc16(entry, offsetof(sd_index_entry_t, crc));
+                if (fwrite(entry, sizeof(*entry), 1, writer->index) == 1) {
+                    wake_metrics.sd_bytes += sizeof(*entry);
+                }
+            }
+        }
+    }
+    if (!writer->error) {
+        writer->committed += writer->block_records;
+    }
+    writer->block_records = 0;
+    writer->block_indexed = false;
+    writer->fill = 0;
+    writer->limit = SD_FLUSH_BLOCK_SIZE;
+}
+
+void sd_log_add(sd_log_writer_t *writer, const chiro_record_t *record)
+{
+    if (writer->error) {
+        return;
+    }
+
+    uint32_t day = record->epoch / SD_LOG_SECONDS_PER_DAY;
+    if (writer->file == NULL || day != writer->day) {
+        sd_log_flush_block(writer);
+        close_day(writer);
+        if (writer->error || open_day(writer, day) != ESP_OK) {
+            writer->error = true;
+            return;
+        }
+    }
+
+    if (writer->limit - writer->fill < RECORD_CSV_MAX_LEN) {
+        sd_log_flush_block(writer);
+    }
+    if (!writer->block_indexed) {
+        writer->block_entry.epoch = record->epoch;
+        writer->block_entry.id = record->id;
+        writer->block_entry.offset = writer->file_size + (uint32_t)writer->fill;
+        writer->block_entry.day = (uint16_t)day;
+        writer->block_indexed = true;
+    }
+    writer->fill += record_to_csv(record, writer->block + writer->fill, SD_FLUSH_BLOCK_SIZE - writer->fill);
+    writer->block_last_id = record->id;
+}
+
+esp_err_t sd_log_close(sd_log_writer_t *writer)
+{
+    sd_log_flush_block(writer);
+    close_day(writer);
+
+    if (writer->index != NULL) {
+        bool ok = fflush(writer->index) == 0 && fsync(fileno(writer->index)) == 0;
+        if (fclose(writer->index) != 0 || !ok) {
+            ESP_LOGW(TAG, "⚠️  Index %s incomplet", SD_INDEX_FILE);
+        }
+        writer->index = NULL;
+    }
+    if (writer->error) {
+        sd_card_forget_dirs();  // Répertoires revérifiés à la session suivante
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
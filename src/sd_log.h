@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <esp_err.h>
+
+#include "config.h"
+#include "record.h"
+
+/*
+ * 🗂️ JOURNAL CSV DE LA CARTE SD, PARTITIONNÉ PAR JOUR
+ *
+ * Les mesures sont écrites dans un fichier par jour (SD_DAY_PATH_FORMAT,
+ * d'après l'horodatage de chaque mesure) : un ajout ne parcourt jamais plus
+ * d'une journée de clusters FAT, quelle que soit la durée du déploiement.
+ *
+ * Écriture par blocs : les lignes sont assemblées dans un tampon DMA de
+ * SD_FLUSH_BLOCK_SIZE octets puis envoyées en un seul fwrite non bufferisé ;
+ * après un premier bloc qui complète le cluster courant, chaque écriture
+ * couvre exactement un cluster. Chaque bloc est validé (fsync + marqueur)
+ * avant d'être compté comme copié.
+ *
+ * 🔒 Le marqueur SD_COMMIT_FILE désigne le fichier du jour en cours
+ * d'écriture, sa taille garantie et l'ID du dernier enregistrement du tampon
+ * validé. Il est réécrit après chaque bloc et avant le premier bloc d'un
+ * nouveau jour, en alternance dans deux emplacements numérotés : une coupure
+ * ou une carte pleine pendant la réécriture laisse le précédent valide. Au
+ * redémarrage :
+ * - au-delà de cette taille, les octets viennent d'une écriture interrompue
+ *   et sont retirés à l'ouverture suivante, qui les renvoie depuis le tampon ;
+ * - les premiers enregistrements du tampon dont l'ID est déjà validé sont
+ *   sautés (coupure entre la validation sur la SD et la libération du tampon).
+ *
+ * 🔎 SD_INDEX_FILE reçoit une entrée par bloc écrit (horodatage et ID de la
+ * première mesure, jour, position) : un lecteur retrouve une plage de dates
+ * par recherche dichotomique puis un seul fseek. L'index est une aide à la
+ * lecture : une entrée manquante ou répétée après une coupure ne fait que
+ * rallonger la lecture qui la suit.
+ */
+
+#define SD_LOG_SECONDS_PER_DAY 86400u
+#define SD_LOG_NO_DAY UINT32_MAX
+
+// Entrée de SD_INDEX_FILE (16 octets)
+typedef struct __attribute__((packed)) {
+    uint32_t epoch;   // Horodatage de la première mesure du bloc
+    uint32_t id;      // ID de la première mesure du bloc
+    uint32_t offset;  // Position de sa ligne dans le fichier du jour
+    uint16_t day;     // Jour du fichier (epoch / SD_LOG_SECONDS_PER_DAY)
+    uint16_t crc;     // CRC-16 des 14 octets précédents
+} sd_index_entry_t;
+
+_Static_assert(sizeof(sd_index_entry_t) == 16, "entrée d'index: 16 octets attendus");
+
+typedef struct {
+    FILE *file;                // Fichier du jour en cours (NULL = pas encore ouvert)
+    FILE *index;               // SD_INDEX_FILE ouvert en ajout
+    char *block;               // Tampon DMA de SD_FLUSH_BLOCK_SIZE octets
+    size_t fill;               // Octets en attente dans le bloc
+    size_t limit;              // Taille du bloc en cours (premier bloc raccourci pour s'aligner)
+    uint32_t day;              // Jour désigné par le marqueur
+    uint32_t file_size;        // Taille du fichier du jour après le dernier bloc validé
+    uint32_t written;          // Octets de mesures écrits sur la SD
+    uint32_t block_last_id;    // ID du dernier enregistrement du bloc en cours
+    uint32_t committed_id;     // ID du dernier enregistrement du tampon validé
+    uint16_t commit_sequence;  // Numéro de la dernière écriture du marqueur
+    uint32_t block_records;    // Enregistrements du tampon couverts par le bloc en cours
+    uint32_t committed;        // Enregistrements du tampon validés sur la SD
+    sd_index_entry_t block_entry;  // Entrée d'index du bloc en cours
+    bool block_indexed;        // block_entry renseignée (au moins une mesure dans le bloc)
+    bool track_ids;            // false en mode dégradé : l'ID validé n'avance pas
+    bool error;
+} sd_log_writer_t;
+
+// ID du dernier enregistrement du tampon validé sur la SD (carte montée, 0 si aucun)
+uint32_t sd_log_committed_id(void);
+
+// Reprendre le journal dans son dernier état validé (carte montée).
+// track_ids : les mesures viennent du tampon flash et avancent l'ID validé
+esp_err_t sd_log_open(sd_log_writer_t *writer, char *block, bool track_ids);
+
+// Ajouter une mesure (changement de fichier au changement de jour)
+void sd_log_add(sd_log_writer_t *writer, const chiro_record_t *record);
+
+// Écrire et valider le bloc en cours
+void sd_log_flush_block(sd_log_writer_t *writer);
+
+// Valider le dernier bloc et fermer les fichiers (ESP_FAIL si une écriture a échoué)
+esp_err_t sd_log_close(sd_log_writer_t *writer);
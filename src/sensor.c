@@ -0,0 +1,164 @@
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+
+#include "sensor.h"
+#include "record.h"
+#include "phase_stats.h"
+
+static const char *TAG = "CHIRO_SENSOR";
+
+// Pilotes de config.h, remplaçables par sensors_use()
+static const sensor_driver_t *const default_drivers[] = { SENSOR_DRIVERS };
+
+_Static_assert(sizeof(default_drivers) / sizeof(default_drivers[0]) <= SENSOR_MAX_DRIVERS,
+               "SENSOR_DRIVERS dépasse SENSOR_MAX_DRIVERS");
+
+static const sensor_driver_t *drivers[SENSOR_MAX_DRIVERS];
+static uint32_t driver_count = 0;
+static bool drivers_loaded = false;
+
+// Conversions en cours : ne survivent pas au deep sleep, pas de RTC memory
+static bool triggered[SENSOR_MAX_DRIVERS];
+static int64_t ready_at_us[SENSOR_MAX_DRIVERS];
+static sensor_timing_t timings[SENSOR_MAX_DRIVERS];
+
+static void load_drivers(void)
+{
+    if (!drivers_loaded) {
+        sensors_use(default_drivers, sizeof(default_drivers) / sizeof(default_drivers[0]));
+    }
+}
+
+void sensors_use(const sensor_driver_t *const *list, uint32_t count)
+{
+    driver_count = count < SENSOR_MAX_DRIVERS ? count : SENSOR_MAX_DRIVERS;
+    for (uint32_t i = 0; i < driver_count; i++) {
+        drivers[i] = list[i];
+    }
+    memset(triggered, 0, sizeof(triggered));
+    memset(timings, 0, sizeof(timings));
+    drivers_loaded = true;
+}
+
+uint32_t sensors_count(void)
+{
+    load_drivers();
+    return driver_count;
+}
+
+const char *sensors_name(uint32_t index)
+{
+    load_drivers();
+    return index < driver_count ? drivers[index]->name : "?";
+}
+
+static void trigger_driver(uint32_t index)
+{
+    sensor_timing_t *timing = &timings[index];
+    timing->wait_us = 0;
+    timing->collect_us = 0;
+
+    int64_t start = esp_timer_get_time();
+    timing->status = drivers[index]->trigger(&timing->conversion_us);
+    int64_t end = esp_timer_get_time();
+    timing->trigger_us = end - start;
+
+    triggered[index] = true;
+    ready_at_us[index] = end + timing->conversion_us;
+    if (timing->status != ESP_OK) {
+        LOG_ESSENTIAL(TAG, "⚠️  Capteur %s: conversion non lancée (%s)", drivers[index]->name,
+                      esp_err_to_name(timing->status));
+    }
+}
+
+void sensors_trigger(void)
+{
+    load_drivers();
+    for (uint32_t i = 0; i < driver_count; i++) {
+        trigger_driver(i);
+    }
+}
+
+// Attendre une échéance : ticks FreeRTOS (cœur libéré) puis attente active pour le reste
+static int64_t wait_until(int64_t deadline_us)
+{
+    int64_t start = esp_timer_get_time();
+    int64_t remaining = deadline_us - start;
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    if (remaining >= tick_us) {
+        vTaskDelay((TickType_t)(remaining / tick_us));
+        remaining = deadline_us - esp_timer_get_time();
+    }
+    if (remaining > 0) {
+        esp_rom_delay_us((uint32_t)remaining);
+    }
+    return esp_timer_get_time() - start;
+}
+
+// Grandeurs absentes complétées par celles du pilote
+static void merge_reading(sensor_reading_t *into, const sensor_reading_t *from)
+{
+#define MERGE_QUANTITY(name, field, type, min, max, scale, column)                    \
+    if (!RECORD_VALUE_HAS(into, name) && RECORD_VALUE_HAS(from, name)) {            \
+        RECORD_VALUE_SET(into, name, from->name);                                   \
+    }
+    RECORD_CHANNEL_CATALOG(MERGE_QUANTITY)
+#undef MERGE_QUANTITY
+}
+
+esp_err_t sensors_collect(uint32_t id, sensor_reading_t *reading)
+{
+    load_drivers();
+    memset(reading, 0, sizeof(*reading));
+
+    esp_err_t result = driver_count > 0 ? ESP_FAIL : ESP_ERR_NOT_FOUND;
+    for (uint32_t i = 0; i < driver_count; i++) {
+        if (!triggered[i]) {
+            trigger_driver(i);
+        }
+        triggered[i] = false;
+        sensor_timing_t *timing = &timings[i];
+        if (timing->status != ESP_OK) {
+            continue;
+        }
+
+        timing->wait_us = wait_until(ready_at_us[i]);
+
+        sensor_reading_t driver_reading = {0};
+        int64_t start = esp_timer_get_time();
+        timing->status = drivers[i]->collect(id, &driver_reading);
+        timing->collect_us = esp_timer_get_time() - start;
+        phase_stats_record_sensor(i, timing->trigger_us + timing->collect_us);
+
+        if (timing->status != ESP_OK) {
+            LOG_ESSENTIAL(TAG, "⚠️  Capteur %s: lecture échouée (%s)", drivers[i]->name,
+                          esp_err_to_name(timing->status));
+            continue;
+        }
+        merge_reading(reading, &driver_reading);
+        timing->reads++;
+        result = ESP_OK;
+    }
+    return result;
+}
+
+const sensor_timing_t *sensors_timing(uint32_t index)
+{
+    load_drivers();
+    return index < driver_count ? &timings[index] : NULL;
+}
+
+bool sensors_stub_capable(void)
+{
+    load_drivers();
+    for (uint32_t i = 0; i < driver_count; i++) {
+        if (!(drivers[i]->flags & SENSOR_FLAG_STUB)) {
+            return false;
+        }
+    }
+    return driver_count > 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#include "config.h"
+#include "record.h"
+
+/*
+ * 🌡️ PILOTES DE CAPTEURS
+ *
+ * Un pilote sépare le déclenchement de la conversion (trigger, sans attente)
+ * de la lecture du résultat (collect). chiro_wake_cycle() déclenche tous les
+ * capteurs dès le début du réveil, fait pendant la conversion ce qui n'a pas
+ * besoin de la mesure (heure et ID, montage du tampon flash s'il va servir),
+ * puis relève les résultats en n'attendant que la part de conversion qui n'a
+ * pas été recouverte.
+ *
+ * Plusieurs pilotes par réveil (config.h, SENSOR_DRIVERS) : chaque grandeur
+ * vient du premier pilote qui la fournit, absente (bit de present à 0) si
+ * aucun. Seuls les canaux de RECORD_CHANNELS sont enregistrés.
+ * Durées par pilote : sensors_timing() pour le dernier relevé, lignes
+ * sensor:<nom> de SD_STATS_FILE pour les cumuls (phase_stats.h).
+ */
+
+// Une valeur par grandeur de record_schema.h (°C, %, hPa, ppm, V...)
+typedef record_values_t sensor_reading_t;
+
+// Mesure reproduite à l'identique par le wake stub (wake_stub.h)
+#define SENSOR_FLAG_STUB 0x01
+
+typedef struct {
+    const char *name;
+    uint32_t flags;  // SENSOR_FLAG_*
+    // Lancer une conversion sans l'attendre ; *conversion_us = délai avant collect()
+    esp_err_t (*trigger)(uint32_t *conversion_us);
+    // Lire le résultat de la conversion (id = numéro de la mesure) ;
+    // ne remplit (RECORD_VALUE_SET) que les grandeurs que le capteur mesure
+    esp_err_t (*collect)(uint32_t id, sensor_reading_t *reading);
+} sensor_driver_t;
+
+// Durées du dernier relevé d'un pilote (µs)
+typedef struct {
+    int64_t trigger_us;      // trigger() : commande envoyée sur le bus
+    uint32_t conversion_us;  // Délai annoncé par le pilote
+    int64_t wait_us;         // Conversion non recouverte, attendue avant collect()
+    int64_t collect_us;      // collect() : lecture et conversion du résultat
+    esp_err_t status;        // Échec du trigger, sinon résultat du collect
+    uint32_t reads;          // Relevés réussis depuis le démarrage
+} sensor_timing_t;
+
+// Pilotes fournis
+extern const sensor_driver_t sensor_driver_synthetic;  // Valeurs dérivées de l'ID (synthetic_sensor.h)
+extern const sensor_driver_t sensor_driver_sht3x;      // Sensirion SHT3x en I2C
+extern const sensor_driver_t sensor_driver_sht4x;      // Sensirion SHT4x en I2C
+extern const sensor_driver_t sensor_driver_bme280;     // Bosch BME280 en I2C, mode forcé
+
+// Remplacer la liste SENSOR_DRIVERS (simulateur : traces rejouées), au plus SENSOR_MAX_DRIVERS
+void sensors_use(const sensor_driver_t *const *drivers, uint32_t count);
+
+// Pilotes actifs
+uint32_t sensors_count(void);
+const char *sensors_name(uint32_t index);
+
+// Début du réveil : lancer les conversions de tous les pilotes
+void sensors_trigger(void);
+
+// Attendre la fin des conversions et relever la mesure (un pilote non déclenché
+// l'est ici) ; ESP_OK si au moins un pilote a répondu
+esp_err_t sensors_collect(uint32_t id, sensor_reading_t *reading);
+
+// Durées du dernier relevé du pilote index (NULL hors liste)
+const sensor_timing_t *sensors_timing(uint32_t index);
+
+// true si le wake stub reproduit exactement les mesures des pilotes actifs
+bool sensors_stub_capable(void);
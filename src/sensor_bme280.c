@@ -0,0 +1,196 @@
+#include <esp_attr.h>
+
+#include "sensor.h"
+#include "sensor_i2c.h"
+
+/*
+ * Bosch BME280 en mode forcé : une conversion par réveil (suréchantillonnage
+ * x1 pour les trois grandeurs), puis retour automatique en veille. Les
+ * coefficients d'étalonnage sont lus une fois et gardés en RTC memory.
+ * Compensation entière de la fiche technique (section 4.2.3 et 8.2).
+ */
+
+#define BME280_REG_CALIB_TP   0x88  // 26 octets : T1..T3, P1..P9, (réservé), H1
+#define BME280_REG_CHIP_ID    0xD0
+#define BME280_REG_CALIB_H    0xE1  // 7 octets : H2..H6
+#define BME280_REG_CTRL_HUM   0xF2
+#define BME280_REG_CTRL_MEAS  0xF4
+#define BME280_REG_DATA       0xF7  // 8 octets : pression, température, humidité
+
+#define BME280_CHIP_ID        0x60
+#define BME280_OSRS_X1        0x01
+#define BME280_MODE_FORCED    0x01
+
+// 1,25 ms + 2,3 ms par grandeur + 0,575 ms pour la pression et l'humidité (durée maximale)
+#define BME280_CONVERSION_US  9300
+
+#define BME280_CALIB_MAGIC    0x32454D42u  // "BME2"
+
+typedef struct {
+    uint32_t magic;
+    uint16_t t1;
+    int16_t t2, t3;
+    uint16_t p1;
+    int16_t p2, p3, p4, p5, p6, p7, p8, p9;
+    uint8_t h1, h3;
+    int16_t h2, h4, h5;
+    int8_t h6;
+} bme280_calib_t;
+
+// Lue au premier déclenchement après une perte de la RTC memory
+RTC_DATA_ATTR static bme280_calib_t calib;
+
+static esp_err_t bme280_read(uint8_t reg, uint8_t *data, size_t len)
+{
+    i2c_master_dev_handle_t device;
+    esp_err_t ret = sensor_i2c_device(SENSOR_BME280_ADDRESS, &device);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return i2c_master_transmit_receive(device, &reg, 1, data, len, SENSOR_I2C_TIMEOUT_MS);
+}
+
+static esp_err_t bme280_write(uint8_t reg, uint8_t value)
+{
+    i2c_master_dev_handle_t device;
+    esp_err_t ret = sensor_i2c_device(SENSOR_BME280_ADDRESS, &device);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t data[2] = { reg, value };
+    return i2c_master_transmit(device, data, sizeof(data), SENSOR_I2C_TIMEOUT_MS);
+}
+
+static uint16_t u16_le(const uint8_t *bytes)
+{
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static esp_err_t bme280_load_calib(void)
+{
+    if (calib.magic == BME280_CALIB_MAGIC) {
+        return ESP_OK;
+    }
+
+    uint8_t chip_id;
+    esp_err_t ret = bme280_read(BME280_REG_CHIP_ID, &chip_id, 1);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (chip_id != BME280_CHIP_ID) {
+        return ESP_ERR_NOT_SUPPORTED;  // BMP280 (0x58) : pas d'humidité
+    }
+
+    uint8_t tp[26], h[7];
+    ret = bme280_read(BME280_REG_CALIB_TP, tp, sizeof(tp));
+    if (ret == ESP_OK) {
+        ret = bme280_read(BME280_REG_CALIB_H, h, sizeof(h));
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    calib.t1 = u16_le(tp + 0);
+    calib.t2 = (int16_t)u16_le(tp + 2);
+    calib.t3 = (int16_t)u16_le(tp + 4);
+    calib.p1 = u16_le(tp + 6);
+    calib.p2 = (int16_t)u16_le(tp + 8);
+    calib.p3 = (int16_t)u16_le(tp + 10);
+    calib.p4 = (int16_t)u16_le(tp + 12);
+    calib.p5 = (int16_t)u16_le(tp + 14);
+    calib.p6 = (int16_t)u16_le(tp + 16);
+    calib.p7 = (int16_t)u16_le(tp + 18);
+    calib.p8 = (int16_t)u16_le(tp + 20);
+    calib.p9 = (int16_t)u16_le(tp + 22);
+    calib.h1 = tp[25];
+    calib.h2 = (int16_t)u16_le(h + 0);
+    calib.h3 = h[2];
+    calib.h4 = (int16_t)(((int8_t)h[3] * 16) | (h[4] & 0x0F));
+    calib.h5 = (int16_t)(((int8_t)h[5] * 16) | (h[4] >> 4));
+    calib.h6 = (int8_t)h[6];
+    calib.magic = BME280_CALIB_MAGIC;
+    return ESP_OK;
+}
+
+static esp_err_t bme280_trigger(uint32_t *conversion_us)
+{
+    *conversion_us = BME280_CONVERSION_US;
+    esp_err_t ret = bme280_load_calib();
+    // ctrl_hum n'est pris en compte qu'à l'écriture de ctrl_meas
+    if (ret == ESP_OK) {
+        ret = bme280_write(BME280_REG_CTRL_HUM, BME280_OSRS_X1);
+    }
+    if (ret == ESP_OK) {
+        ret = bme280_write(BME280_REG_CTRL_MEAS, (BME280_OSRS_X1 << 5) | (BME280_OSRS_X1 << 2) | BME280_MODE_FORCED);
+    }
+    return ret;
+}
+
+// Température en centièmes de °C, t_fine pour la pression et l'humidité
+static int32_t compensate_temperature(int32_t adc_t, int32_t *t_fine)
+{
+    int32_t var1 = ((((adc_t >> 3) - ((int32_t)calib.t1 << 1))) * calib.t2) >> 11;
+    int32_t var2 = (((((adc_t >> 4) - (int32_t)calib.t1) * ((adc_t >> 4) - (int32_t)calib.t1)) >> 12) * calib.t3) >> 14;
+    *t_fine = var1 + var2;
+    return (*t_fine * 5 + 128) >> 8;
+}
+
+// Pression en Pa, format Q24.8
+static uint32_t compensate_pressure(int32_t adc_p, int32_t t_fine)
+{
+    int64_t var1 = (int64_t)t_fine - 128000;
+    int64_t var2 = var1 * var1 * calib.p6;
+    var2 = var2 + ((var1 * calib.p5) * 131072);
+    var2 = var2 + ((int64_t)calib.p4 * 34359738368LL);
+    var1 = ((var1 * var1 * calib.p3) / 256) + ((var1 * calib.p2) * 4096);
+    var1 = ((((int64_t)1) << 47) + var1) * calib.p1 / 8589934592LL;
+    if (var1 == 0) {
+        return 0;
+    }
+    int64_t p = 1048576 - adc_p;
+    p = (((p * 2147483648LL) - var2) * 3125) / var1;
+    var1 = ((int64_t)calib.p9 * (p / 8192) * (p / 8192)) / 33554432;
+    var2 = ((int64_t)calib.p8 * p) / 524288;
+    p = ((p + var1 + var2) / 256) + ((int64_t)calib.p7 * 16);
+    return (uint32_t)p;
+}
+
+// Humidité relative en %, format Q22.10
+static uint32_t compensate_humidity(int32_t adc_h, int32_t t_fine)
+{
+    int32_t v = t_fine - 76800;
+    v = (((((adc_h << 14) - ((int32_t)calib.h4 << 20) - ((int32_t)calib.h5 * v)) + 16384) >> 15) *
+         (((((((v * calib.h6) >> 10) * (((v * (int32_t)calib.h3) >> 11) + 32768)) >> 10) + 2097152) * calib.h2 +
+           8192) >> 14));
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)calib.h1) >> 4);
+    v = v < 0 ? 0 : (v > 419430400 ? 419430400 : v);
+    return (uint32_t)(v >> 12);
+}
+
+static esp_err_t bme280_collect(uint32_t id, sensor_reading_t *reading)
+{
+    (void)id;
+    uint8_t data[8];
+    esp_err_t ret = bme280_read(BME280_REG_DATA, data, sizeof(data));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int32_t adc_p = (int32_t)((data[0] << 12) | (data[1] << 4) | (data[2] >> 4));
+    int32_t adc_t = (int32_t)((data[3] << 12) | (data[4] << 4) | (data[5] >> 4));
+    int32_t adc_h = (int32_t)((data[6] << 8) | data[7]);
+    if (adc_t == 0x80000) {
+        return ESP_ERR_INVALID_STATE;  // Valeur de réinitialisation : pas de conversion
+    }
+
+    int32_t t_fine;
+    RECORD_VALUE_SET(reading, temperature, compensate_temperature(adc_t, &t_fine) / 100.0f);
+    RECORD_VALUE_SET(reading, pressure, compensate_pressure(adc_p, t_fine) / 25600.0f);
+    RECORD_VALUE_SET(reading, humidity, compensate_humidity(adc_h, t_fine) / 1024.0f);
+    return ESP_OK;
+}
+
+const sensor_driver_t sensor_driver_bme280 = {
+    .name = "bme280",
+    .trigger = bme280_trigger,
+    .collect = bme280_collect,
+};
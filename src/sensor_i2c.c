@@ -0,0 +1,82 @@
+#include <stdbool.h>
+#include <esp_log.h>
+
+#include "sensor_i2c.h"
+
+static const char *TAG = "CHIRO_I2C";
+
+#define SENSOR_I2C_MAX_DEVICES SENSOR_MAX_DRIVERS
+
+static i2c_master_bus_handle_t bus = NULL;
+
+static struct {
+    uint8_t address;
+    i2c_master_dev_handle_t handle;
+} devices[SENSOR_I2C_MAX_DEVICES];
+static int device_count = 0;
+
+static esp_err_t init_bus(void)
+{
+    if (bus != NULL) {
+        return ESP_OK;
+    }
+
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = SENSOR_I2C_PORT,
+        .sda_io_num = SENSOR_I2C_SDA_GPIO,
+        .scl_io_num = SENSOR_I2C_SCL_GPIO,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = true,
+    };
+    esp_err_t ret = i2c_new_master_bus(&bus_config, &bus);
+    if (ret != ESP_OK) {
+        LOG_ESSENTIAL(TAG, "❌ Bus I2C des capteurs indisponible (%s)", esp_err_to_name(ret));
+        bus = NULL;
+    }
+    return ret;
+}
+
+esp_err_t sensor_i2c_device(uint8_t address, i2c_master_dev_handle_t *device)
+{
+    for (int i = 0; i < device_count; i++) {
+        if (devices[i].address == address) {
+            *device = devices[i].handle;
+            return ESP_OK;
+        }
+    }
+    if (device_count == SENSOR_I2C_MAX_DEVICES) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = init_bus();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    i2c_device_config_t device_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = SENSOR_I2C_SPEED_HZ,
+    };
+    ret = i2c_master_bus_add_device(bus, &device_config, device);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    devices[device_count].address = address;
+    devices[device_count].handle = *device;
+    device_count++;
+    return ESP_OK;
+}
+
+uint8_t sensor_crc8(const uint8_t *bytes, size_t len)
+{
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
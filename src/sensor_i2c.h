@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_err.h>
+#include <driver/i2c_master.h>
+
+#include "config.h"
+
+/*
+ * 🔌 BUS I2C DES CAPTEURS
+ *
+ * Bus SENSOR_I2C_PORT créé au premier accès de chaque démarrage (SDA/SCL et
+ * fréquence dans config.h), un périphérique par adresse. Délai d'attente
+ * court : un capteur absent ne doit pas allonger le réveil.
+ */
+
+#define SENSOR_I2C_TIMEOUT_MS 20
+
+// Périphérique à l'adresse donnée sur le bus des capteurs
+esp_err_t sensor_i2c_device(uint8_t address, i2c_master_dev_handle_t *device);
+
+// CRC-8 des capteurs Sensirion (polynôme 0x31, départ 0xFF)
+uint8_t sensor_crc8(const uint8_t *bytes, size_t len);
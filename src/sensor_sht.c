@@ -0,0 +1,99 @@
+#include "sensor.h"
+#include "sensor_i2c.h"
+
+/*
+ * Sensirion SHT3x et SHT4x : mesure unique haute répétabilité, sans étirement
+ * d'horloge (le bus reste libre pendant la conversion). Réponse de 6 octets :
+ * température (2 octets + CRC) puis humidité (2 octets + CRC).
+ */
+
+#define SHT3X_CONVERSION_US 15500  // Haute répétabilité, durée maximale
+#define SHT4X_CONVERSION_US 8300
+
+static esp_err_t sht_send(uint8_t address, const uint8_t *command, size_t len)
+{
+    i2c_master_dev_handle_t device;
+    esp_err_t ret = sensor_i2c_device(address, &device);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return i2c_master_transmit(device, command, len, SENSOR_I2C_TIMEOUT_MS);
+}
+
+// Mots bruts de température et d'humidité, CRC vérifiés
+static esp_err_t sht_read(uint8_t address, uint16_t *raw_temperature, uint16_t *raw_humidity)
+{
+    i2c_master_dev_handle_t device;
+    esp_err_t ret = sensor_i2c_device(address, &device);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint8_t data[6];
+    ret = i2c_master_receive(device, data, sizeof(data), SENSOR_I2C_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (sensor_crc8(data, 2) != data[2] || sensor_crc8(data + 3, 2) != data[5]) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    *raw_temperature = (uint16_t)((data[0] << 8) | data[1]);
+    *raw_humidity = (uint16_t)((data[3] << 8) | data[4]);
+    return ESP_OK;
+}
+
+static float clamp_humidity(float humidity)
+{
+    return humidity < 0.0f ? 0.0f : (humidity > 100.0f ? 100.0f : humidity);
+}
+
+static esp_err_t sht3x_trigger(uint32_t *conversion_us)
+{
+    static const uint8_t command[] = { 0x24, 0x00 };  // Single shot, haute répétabilité
+    *conversion_us = SHT3X_CONVERSION_US;
+    return sht_send(SENSOR_SHT3X_ADDRESS, command, sizeof(command));
+}
+
+static esp_err_t sht3x_collect(uint32_t id, sensor_reading_t *reading)
+{
+    (void)id;
+    uint16_t raw_temperature, raw_humidity;
+    esp_err_t ret = sht_read(SENSOR_SHT3X_ADDRESS, &raw_temperature, &raw_humidity);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    RECORD_VALUE_SET(reading, temperature, -45.0f + 175.0f * raw_temperature / 65535.0f);
+    RECORD_VALUE_SET(reading, humidity, clamp_humidity(100.0f * raw_humidity / 65535.0f));
+    return ESP_OK;
+}
+
+static esp_err_t sht4x_trigger(uint32_t *conversion_us)
+{
+    static const uint8_t command[] = { 0xFD };  // Haute précision
+    *conversion_us = SHT4X_CONVERSION_US;
+    return sht_send(SENSOR_SHT4X_ADDRESS, command, sizeof(command));
+}
+
+static esp_err_t sht4x_collect(uint32_t id, sensor_reading_t *reading)
+{
+    (void)id;
+    uint16_t raw_temperature, raw_humidity;
+    esp_err_t ret = sht_read(SENSOR_SHT4X_ADDRESS, &raw_temperature, &raw_humidity);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    RECORD_VALUE_SET(reading, temperature, -45.0f + 175.0f * raw_temperature / 65535.0f);
+    RECORD_VALUE_SET(reading, humidity, clamp_humidity(-6.0f + 125.0f * raw_humidity / 65535.0f));
+    return ESP_OK;
+}
+
+const sensor_driver_t sensor_driver_sht3x = {
+    .name = "sht3x",
+    .trigger = sht3x_trigger,
+    .collect = sht3x_collect,
+};
+
+const sensor_driver_t sensor_driver_sht4x = {
+    .name = "sht4x",
+    .trigger = sht4x_trigger,
+    .collect = sht4x_collect,
+};
@@ -0,0 +1,25 @@
+#include "sensor.h"
+#include "synthetic_sensor.h"
+
+// Pas de conversion : valeurs calculées à la lecture
+static esp_err_t synthetic_trigger(uint32_t *conversion_us)
+{
+    *conversion_us = 0;
+    return ESP_OK;
+}
+
+static esp_err_t synthetic_collect(uint32_t id, sensor_reading_t *reading)
+{
+    int32_t temperature_centi, humidity_centi;
+    synthetic_sensor_read(id, &temperature_centi, &humidity_centi);
+    RECORD_VALUE_SET(reading, temperature, temperature_centi / 100.0f);
+    RECORD_VALUE_SET(reading, humidity, humidity_centi / 100.0f);
+    return ESP_OK;
+}
+
+const sensor_driver_t sensor_driver_synthetic = {
+    .name = "synthetic",
+    .flags = SENSOR_FLAG_STUB,
+    .trigger = synthetic_trigger,
+    .collect = synthetic_collect,
+};
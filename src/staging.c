@@ -0,0 +1,55 @@
+#include <string.h>
+#include <esp_attr.h>
+
+#include "staging.h"
+
+// Lot en RTC slow memory (STAGING_BATCH_SIZE * 16 octets)
+RTC_DATA_ATTR static chiro_record_t staged_records[STAGING_BATCH_SIZE];
+RTC_DATA_ATTR static uint32_t staged_count = 0;
+
+// Appelée aussi par le wake stub (wake_stub.h) : code en RTC fast memory
+RTC_IRAM_ATTR bool staging_push(const chiro_record_t *record)
+{
+    // Compteur incohérent (RTC memory altérée) : repartir d'un lot vide
+    if (staged_count > STAGING_BATCH_SIZE) {
+        staged_count = 0;
+    }
+    if (staged_count == STAGING_BATCH_SIZE) {
+        return false;
+    }
+
+    staged_records[staged_count] = *record;
+    staged_count++;
+    return true;
+}
+
+RTC_IRAM_ATTR uint32_t staging_count(void)
+{
+    return staged_count <= STAGING_BATCH_SIZE ? staged_count : 0;
+}
+
+bool staging_is_full(void)
+{
+    return staging_count() == STAGING_BATCH_SIZE;
+}
+
+const chiro_record_t *staging_records(void)
+{
+    return staged_records;
+}
+
+void staging_clear(void)
+{
+    staged_count = 0;
+}
+
+void staging_drop(uint32_t count)
+{
+    uint32_t n = staging_count();
+    if (count >= n) {
+        staged_count = 0;
+        return;
+    }
+    memmove(staged_records, staged_records + count, (n - count) * sizeof(chiro_record_t));
+    staged_count = n - count;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "record.h"
+
+/*
+ * 🧺 LOT DE MESURES EN RTC MEMORY
+ *
+ * Les mesures sont d'abord accumulées en RTC slow memory, qui survit au deep
+ * sleep, puis écrites en une seule fois dans le tampon flash quand le lot est
+ * plein ou qu'un flush est dû : la plupart des réveils ne touchent pas la flash.
+ *
+ * Garantie : le lot ne dépasse jamais STAGING_BATCH_SIZE mesures. Une perte
+ * de la RTC memory (coupure, brown-out) perd donc au plus :
+ * - SAMPLING_ENGINE_CPU (wake stub compris) : un lot, STAGING_BATCH_SIZE mesures ;
+ * - SAMPLING_ENGINE_ULP : un lot plus les mesures relevées par l'ULP pendant le
+ *   deep sleep, qui attendent en RTC slow memory le réveil suivant, soit
+ *   STAGING_BATCH_SIZE + ULP_SAMPLE_CAPACITY mesures.
+ */
+
+_Static_assert(STAGING_BATCH_SIZE >= 1 && STAGING_BATCH_SIZE <= BUFFER_FLUSH_THRESHOLD,
+               "STAGING_BATCH_SIZE doit être compris entre 1 et BUFFER_FLUSH_THRESHOLD");
+
+// Ajouter une mesure au lot (false si le lot est déjà plein)
+bool staging_push(const chiro_record_t *record);
+
+// Nombre de mesures dans le lot
+uint32_t staging_count(void);
+
+bool staging_is_full(void);
+
+// Mesures du lot, de la plus ancienne à la plus récente
+const chiro_record_t *staging_records(void);
+
+// Vider le lot une fois écrit en flash (ou sur la SD)
+void staging_clear(void);
+
+// Retirer les count plus anciennes mesures du lot (écrites en flash avant un échec)
+void staging_drop(uint32_t count);
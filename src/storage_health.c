@@ -0,0 +1,124 @@
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_err.h>
+
+#include "storage_health.h"
+#include "metrics.h"
+#include "record.h"
+#include "timekeeper.h"
+
+#define STORAGE_HEALTH_MAGIC 0x48544C48u  // "HLTH"
+
+// Secteur effaçable de la flash SPI (estimation des effacements SPIFFS)
+#define FLASH_ERASE_SECTOR_SIZE 4096
+
+// Cumuls depuis la mise sous tension
+typedef struct {
+    uint32_t magic;             // STORAGE_HEALTH_MAGIC si les cumuls sont cohérents
+    uint32_t since_epoch;       // Début de la fenêtre d'observation
+    uint64_t buffered_records;
+    uint64_t flash_bytes;
+    uint32_t flash_erases;
+    uint64_t flushed_records;
+    uint64_t sd_bytes;
+} health_totals_t;
+
+// Cumuls en RTC memory : repartent de zéro après une perte d'alimentation
+RTC_DATA_ATTR static health_totals_t totals;
+
+static storage_health_t last;
+static bool last_valid = false;
+
+static void totals_check(uint32_t epoch)
+{
+    if (totals.magic != STORAGE_HEALTH_MAGIC) {
+        memset(&totals, 0, sizeof(totals));
+        totals.magic = STORAGE_HEALTH_MAGIC;
+        totals.since_epoch = epoch;
+    }
+}
+
+void storage_health_add_wake(void)
+{
+    totals_check(timekeeper_now());
+    totals.buffered_records += wake_metrics.buffered_records;
+    totals.flash_bytes += wake_metrics.flash_bytes;
+    totals.flash_erases += wake_metrics.flash_erases;
+    totals.flushed_records += wake_metrics.flushed_records;
+    totals.sd_bytes += wake_metrics.sd_bytes;
+}
+
+// Rapport x100 (0 sans octets logiques)
+static uint32_t ratio_centi(uint64_t bytes, uint64_t records)
+{
+    uint64_t logical = records * sizeof(chiro_record_t);
+    return logical > 0 ? (uint32_t)(bytes * 100 / logical) : 0;
+}
+
+// Jours avant d'avoir consommé remaining au rythme de used sur window_sec
+// (-1 : fenêtre trop courte ou rien consommé)
+static int32_t project_days(uint64_t remaining, uint64_t used, uint32_t window_sec)
+{
+    if (window_sec < STORAGE_HEALTH_MIN_WINDOW_SEC || used == 0) {
+        return -1;
+    }
+    uint64_t days = remaining * window_sec / used / 86400;
+    return days > INT32_MAX ? INT32_MAX : (int32_t)days;
+}
+
+static void compute(storage_health_t *health, uint32_t epoch, const buffer_usage_t *usage, uint64_t sd_free_bytes)
+{
+    // Réveil en cours compris (cumulé seulement à la mise en sommeil)
+    memset(health, 0, sizeof(*health));
+    health->epoch = epoch;
+    health->window_sec = epoch > totals.since_epoch ? epoch - totals.since_epoch : 0;
+    health->records = totals.buffered_records + wake_metrics.buffered_records;
+    health->flash_bytes = totals.flash_bytes + wake_metrics.flash_bytes;
+    health->flash_wa_centi = ratio_centi(health->flash_bytes, health->records);
+    health->flash_erases = usage->erases_counted
+                               ? totals.flash_erases + wake_metrics.flash_erases
+                               : (uint32_t)(health->flash_bytes / FLASH_ERASE_SECTOR_SIZE);
+    health->usage = *usage;
+
+    uint32_t free_bytes = usage->total_bytes > usage->used_bytes ? usage->total_bytes - usage->used_bytes : 0;
+    health->buffer_full_days = project_days(free_bytes, health->flash_bytes, health->window_sec);
+
+    uint64_t cycles_left = usage->erase_max < FLASH_ENDURANCE_CYCLES ? FLASH_ENDURANCE_CYCLES - usage->erase_max : 0;
+    health->flash_life_days = project_days(cycles_left * usage->sectors, health->flash_erases, health->window_sec);
+
+    health->sd_bytes = totals.sd_bytes + wake_metrics.sd_bytes;
+    health->sd_wa_centi = ratio_centi(health->sd_bytes, totals.flushed_records + wake_metrics.flushed_records);
+    health->sd_free_bytes = sd_free_bytes;
+    health->sd_full_days = project_days(sd_free_bytes, health->sd_bytes, health->window_sec);
+}
+
+esp_err_t storage_health_write(FILE *file, uint32_t epoch, const char *backend, const buffer_usage_t *usage,
+                               uint64_t sd_free_bytes)
+{
+    totals_check(epoch);
+    compute(&last, epoch, usage, sd_free_bytes);
+    last_valid = true;
+
+    // En-tête si le fichier est neuf
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        fputs("DateTime,Backend,Window_s,Records,Flash_B,Flash_WA,Erases,Erase_max,Buffer_used_B,Buffer_total_B,"
+              "Buffer_full_days,Flash_life_days,SD_B,SD_WA,SD_free_B,SD_full_days\n",
+              file);
+    }
+
+    fprintf(file, "%lu,%s,%lu,%llu,%llu,%lu.%02lu,%lu,%lu,%lu,%lu,%ld,%ld,%llu,%lu.%02lu,%llu,%ld\n",
+            (unsigned long)last.epoch, backend, (unsigned long)last.window_sec, (unsigned long long)last.records,
+            (unsigned long long)last.flash_bytes, (unsigned long)(last.flash_wa_centi / 100),
+            (unsigned long)(last.flash_wa_centi % 100), (unsigned long)last.flash_erases,
+            (unsigned long)usage->erase_max, (unsigned long)usage->used_bytes, (unsigned long)usage->total_bytes,
+            (long)last.buffer_full_days, (long)last.flash_life_days, (unsigned long long)last.sd_bytes,
+            (unsigned long)(last.sd_wa_centi / 100), (unsigned long)(last.sd_wa_centi % 100),
+            (unsigned long long)last.sd_free_bytes, (long)last.sd_full_days);
+    return ferror(file) ? ESP_FAIL : ESP_OK;
+}
+
+const storage_health_t *storage_health_last(void)
+{
+    return last_valid ? &last : NULL;
+}
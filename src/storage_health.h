@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <esp_err.h>
+
+#include "config.h"
+#include "buffer_backend.h"
+
+/*
+ * 🩺 USURE ET CAPACITÉ DU STOCKAGE
+ *
+ * Les octets écrits et secteurs effacés de chaque réveil (metrics.h) sont
+ * cumulés en RTC memory depuis la mise sous tension. À chaque flush, une
+ * ligne d'état est ajoutée à SD_HEALTH_FILE :
+ * - amplification d'écriture : octets écrits / taille logique des mesures
+ *   (sizeof(chiro_record_t)), pour le tampon flash et pour la SD ;
+ * - usure : effacements depuis la mise sous tension et secteur le plus usé ;
+ * - remplissage du tampon et de la carte ;
+ * - projections au rythme observé : jours avant tampon plein si la SD ne
+ *   répond plus, jours avant la fin de vie de la flash (FLASH_ENDURANCE_CYCLES,
+ *   usure répartie sur tous les secteurs), jours avant carte pleine.
+ *
+ * SPIFFS n'expose pas ses effacements ni l'usure de ses secteurs : un
+ * effacement est compté par secteur de données écrit (estimation basse, sans
+ * ramasse-miettes ni métadonnées) et la durée de vie suppose une flash neuve.
+ * Projections à -1 tant que la fenêtre d'observation est trop courte.
+ */
+
+// Fenêtre minimale avant de projeter un rythme (secondes)
+#define STORAGE_HEALTH_MIN_WINDOW_SEC 3600
+
+// Dernier état calculé (ligne de SD_HEALTH_FILE)
+typedef struct {
+    uint32_t epoch;             // Heure du flush
+    uint32_t window_sec;        // Durée d'observation depuis la mise sous tension
+    uint64_t records;           // Mesures écrites dans le tampon flash
+    uint64_t flash_bytes;       // Octets écrits dans le tampon (données et métadonnées)
+    uint32_t flash_wa_centi;    // Amplification d'écriture du tampon (x100)
+    uint32_t flash_erases;      // Secteurs effacés (estimés avec SPIFFS)
+    buffer_usage_t usage;       // Occupation et usure du tampon
+    int32_t buffer_full_days;   // Jours avant tampon plein sans flush (-1 : inconnu)
+    int32_t flash_life_days;    // Jours avant FLASH_ENDURANCE_CYCLES (-1 : inconnu)
+    uint64_t sd_bytes;          // Octets écrits sur la SD
+    uint32_t sd_wa_centi;       // Octets écrits sur la SD par octet logique flushé (x100)
+    uint64_t sd_free_bytes;
+    int32_t sd_full_days;       // Jours avant carte pleine (-1 : inconnu)
+} storage_health_t;
+
+// Fin de réveil : cumuler les compteurs du réveil (wake_metrics)
+void storage_health_add_wake(void);
+
+// Ajouter la ligne d'état à un fichier ouvert (carte montée). usage = occupation du
+// tampon relevée au début du flush, sd_free_bytes = place libre sur la carte
+esp_err_t storage_health_write(FILE *file, uint32_t epoch, const char *backend, const buffer_usage_t *usage,
+                               uint64_t sd_free_bytes);
+
+// Dernier état écrit (NULL avant le premier flush)
+const storage_health_t *storage_health_last(void);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * 🌡️ MESURE SYNTHÉTIQUE
+ *
+ * En attendant le câblage du capteur, valeurs dérivées de l'ID de mesure, en
+ * centièmes : calcul entier, utilisable par le wake stub (pas de FPU ni
+ * d'accès à la flash avant le bootloader) comme par le cycle complet.
+ */
+
+static inline __attribute__((always_inline)) void synthetic_sensor_read(uint32_t id, int32_t *temperature_centi,
+                                                                        int32_t *humidity_centi)
+{
+    *temperature_centi = 1850 + (int32_t)(id * 10);  // 18.5 °C + 0.1 °C par mesure
+    *humidity_centi = 8500 + (int32_t)(id * 20);     // 85 % + 0.2 % par mesure
+}
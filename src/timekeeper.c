@@ -0,0 +1,312 @@
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <nvs_flash.h>
+
+#include "timekeeper.h"
+#include "flash_buffer.h"
+#include "record.h"
+#include "event_log.h"
+
+static const char *TAG = "CHIRO_TIME";
+
+#define TIME_STATE_MAGIC   0x454D4954u  // "TIME"
+#define TIME_NVS_NAMESPACE "chiro"
+#define TIME_NVS_KEY       "clock"
+
+// Point de contrôle NVS
+typedef struct {
+    uint32_t id_limit;  // Premier ID non réservé
+    uint32_t epoch;     // Heure au moment de l'écriture
+} time_checkpoint_t;
+
+// Réservation du bloc d'ID en cours
+typedef enum {
+    ID_RESERVE_CONFIRMED,    // id_limit écrit en NVS
+    ID_RESERVE_RESTORED,     // Reprise après coupure, premier bloc pas encore réservé
+    ID_RESERVE_PROVISIONAL,  // NVS en échec : id_limit tenu en RTC memory seulement
+} id_reserve_t;
+
+typedef struct {
+    uint32_t magic;          // TIME_STATE_MAGIC si l'état est cohérent
+    uint32_t next_id;        // Prochain ID à attribuer
+    uint32_t id_limit;       // Fin du bloc réservé (next_id >= id_limit : réserver)
+    uint32_t reserve;        // id_reserve_t
+    int64_t epoch_base_us;   // Heure (µs) quand esp_timer_get_time() vaut 0 dans ce démarrage
+    int64_t sleep_start_us;  // Heure à l'entrée en deep sleep
+    int64_t sleep_us;        // Durée programmée (0 = pas de deep sleep en attente)
+    int64_t timer_us;        // Timer de secours si l'ULP doit réveiller avant (0 : timer seul)
+    uint32_t check;
+} time_state_t;
+
+RTC_DATA_ATTR static time_state_t time_state;
+
+// Hors RTC memory : remis à zéro par chaque démarrage de l'ESP32 (et par
+// timekeeper_sleep() pour le simulateur, où les variables survivent)
+static bool boot_handled = false;
+
+// Fonctions d'état en RTC fast memory : appelées aussi par le wake stub (wake_stub.h)
+static RTC_IRAM_ATTR uint32_t time_state_checksum(const time_state_t *state)
+{
+    return state->magic ^ (state->next_id * 2654435761u) ^ (state->id_limit * 40503u) ^ (state->reserve << 24) ^
+           (uint32_t)state->epoch_base_us ^ ~(uint32_t)(state->epoch_base_us >> 32) ^
+           ((uint32_t)state->sleep_start_us * 2246822519u) ^ (uint32_t)(state->sleep_start_us >> 32) ^
+           ((uint32_t)state->sleep_us * 3266489917u) ^ ~(uint32_t)(state->sleep_us >> 32) ^
+           ((uint32_t)state->timer_us * 668265263u) ^ (uint32_t)(state->timer_us >> 32);
+}
+
+static RTC_IRAM_ATTR void time_state_commit(void)
+{
+    time_state.magic = TIME_STATE_MAGIC;
+    time_state.check = time_state_checksum(&time_state);
+}
+
+static RTC_IRAM_ATTR bool time_state_is_valid(void)
+{
+    return time_state.magic == TIME_STATE_MAGIC && time_state.check == time_state_checksum(&time_state);
+}
+
+// Jours depuis le 1970-01-01 (calendrier grégorien proleptique)
+static int32_t days_from_civil(int32_t year, int32_t month, int32_t day)
+{
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    int32_t yoe = year - era * 400;
+    int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Heure de départ sans point de contrôle : TIME_INITIAL_EPOCH, sinon date de compilation
+static uint32_t initial_epoch(void)
+{
+    if (TIME_INITIAL_EPOCH != 0) {
+        return TIME_INITIAL_EPOCH;
+    }
+
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    const char *date = __DATE__;  // "Mmm dd yyyy"
+    const char *time = __TIME__;  // "hh:mm:ss"
+    int32_t month = 1;
+    for (int i = 0; i < 12; i++) {
+        if (memcmp(months + 3 * i, date, 3) == 0) {
+            month = i + 1;
+        }
+    }
+    int32_t day = (date[4] == ' ' ? 0 : date[4] - '0') * 10 + (date[5] - '0');
+    int32_t year = (date[7] - '0') * 1000 + (date[8] - '0') * 100 + (date[9] - '0') * 10 + (date[10] - '0');
+    int32_t seconds = ((time[0] - '0') * 10 + (time[1] - '0')) * 3600 +
+                      ((time[3] - '0') * 10 + (time[4] - '0')) * 60 + (time[6] - '0') * 10 + (time[7] - '0');
+    return (uint32_t)days_from_civil(year, month, day) * 86400u + (uint32_t)seconds;
+}
+
+static esp_err_t open_nvs(nvs_handle_t *handle)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        // Partition NVS illisible par cette version d'ESP-IDF : la réinitialiser
+        LOG_EVENT(TAG, TIME_NVS_RESET, ret, 0);
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return nvs_open(TIME_NVS_NAMESPACE, NVS_READWRITE, handle);
+}
+
+// Écrire le point de contrôle ; id_limit n'est retenu en RTC qu'une fois écrit
+static esp_err_t write_checkpoint(uint32_t id_limit)
+{
+    time_checkpoint_t checkpoint = { .id_limit = id_limit, .epoch = timekeeper_now() };
+    nvs_handle_t handle;
+    esp_err_t ret = open_nvs(&handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(handle, TIME_NVS_KEY, &checkpoint, sizeof(checkpoint));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+
+    if (ret != ESP_OK) {
+        LOG_EVENT(TAG, TIME_CHECKPOINT_FAILED, ret, 0);
+        return ret;
+    }
+    time_state.id_limit = id_limit;
+    time_state.reserve = ID_RESERVE_CONFIRMED;
+    time_state_commit();
+    LOG_DEBUG(TAG, "💾 Point de contrôle: ID réservés jusqu'à %lu, heure %lu", (unsigned long)id_limit,
+              (unsigned long)checkpoint.epoch);
+    return ESP_OK;
+}
+
+static void set_epoch(uint32_t epoch)
+{
+    time_state.epoch_base_us = (int64_t)epoch * 1000000 - esp_timer_get_time();
+}
+
+// Perte d'alimentation : reprendre après le dernier ID réservé et la dernière heure connue
+static void restore_after_power_loss(void)
+{
+    time_checkpoint_t checkpoint = { 0 };
+    size_t length = sizeof(checkpoint);
+    nvs_handle_t handle;
+    esp_err_t ret = open_nvs(&handle);
+    if (ret == ESP_OK) {
+        ret = nvs_get_blob(handle, TIME_NVS_KEY, &checkpoint, &length);
+        nvs_close(handle);
+    }
+    bool restored = ret == ESP_OK && length == sizeof(checkpoint);
+    if (!restored) {
+        memset(&checkpoint, 0, sizeof(checkpoint));
+    }
+
+    uint32_t next_id = checkpoint.id_limit > 0 ? checkpoint.id_limit : 1;
+    uint32_t epoch = checkpoint.epoch > initial_epoch() ? checkpoint.epoch : initial_epoch();
+
+    // Les mesures du tampon flash sont postérieures au dernier point de contrôle
+    chiro_record_t last;
+    if (read_last_buffer_record(&last) == ESP_OK) {
+        if (last.id >= next_id) {
+            next_id = last.id + 1;
+        }
+        uint32_t after = last.epoch + record_interval_seconds(last.interval_code);
+        if (after > epoch) {
+            epoch = after;
+        }
+    }
+
+    time_state.next_id = next_id;
+    time_state.id_limit = next_id;  // Bloc réservé à la première mesure
+    time_state.reserve = ID_RESERVE_RESTORED;
+    time_state.sleep_us = 0;
+    set_epoch(epoch);
+    time_state_commit();
+
+    // Événements datés une fois l'heure restaurée
+    if (!restored) {
+        LOG_EVENT(TAG, TIME_NO_CHECKPOINT, ret, 0);
+    }
+    LOG_EVENT(TAG, TIME_RESTORED, next_id, epoch);
+}
+
+void timekeeper_boot(void)
+{
+    // Plusieurs cycles dans le même démarrage (banc de mesure sans deep sleep)
+    if (boot_handled) {
+        return;
+    }
+    boot_handled = true;
+
+    // Hors réveil par le timer ou l'ULP (mise sous tension, reset logiciel,
+    // watchdog), la durée écoulée est inconnue : même reprise qu'après une coupure
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    if (!time_state_is_valid() || time_state.sleep_us == 0 ||
+        (cause != ESP_SLEEP_WAKEUP_TIMER && cause != ESP_SLEEP_WAKEUP_ULP)) {
+        restore_after_power_loss();
+        return;
+    }
+
+    // Réveil par le timer de secours (ULP bloqué) : le sommeil a duré plus longtemps
+    int64_t slept_us = cause == ESP_SLEEP_WAKEUP_TIMER && time_state.timer_us != 0 ? time_state.timer_us
+                                                                                   : time_state.sleep_us;
+
+    // esp_timer repart de zéro au réveil, après le bootloader
+    time_state.epoch_base_us = time_state.sleep_start_us + slept_us + (int64_t)TIME_BOOT_OFFSET_MS * 1000;
+    time_state.sleep_us = 0;
+    time_state_commit();
+}
+
+// Bloc d'ID suivant : en NVS, sinon provisoire en RTC memory jusqu'au point de
+// contrôle d'un flush (pas de nouvelle écriture NVS à chaque réveil)
+static void reserve_ids(void)
+{
+    if (time_state.reserve != ID_RESERVE_PROVISIONAL &&
+        write_checkpoint(time_state.next_id + TIME_ID_RESERVE) == ESP_OK) {
+        return;
+    }
+
+    if (time_state.reserve == ID_RESERVE_RESTORED) {
+        // Le point de contrôle NVS peut dater d'avant un bloc provisoire déjà
+        // flushé : reprendre après le dernier ID validé sur la SD
+        uint32_t last_id;
+        if (read_sd_committed_id(&last_id) == ESP_OK && time_state.next_id <= last_id) {
+            LOG_EVENT(TAG, TIME_IDS_SKIPPED, last_id, last_id + 1);
+            time_state.next_id = last_id + 1;
+        }
+    }
+    if (time_state.reserve != ID_RESERVE_PROVISIONAL) {
+        LOG_EVENT(TAG, TIME_IDS_PROVISIONAL, time_state.next_id, time_state.next_id + TIME_ID_RESERVE);
+    }
+    time_state.reserve = ID_RESERVE_PROVISIONAL;
+    time_state.id_limit = time_state.next_id + TIME_ID_RESERVE;
+    time_state_commit();
+}
+
+uint32_t timekeeper_next_id(void)
+{
+    if (time_state.next_id >= time_state.id_limit) {
+        reserve_ids();
+    }
+    uint32_t id = time_state.next_id++;
+    time_state_commit();
+    return id;
+}
+
+uint32_t timekeeper_now(void)
+{
+    return (uint32_t)((time_state.epoch_base_us + esp_timer_get_time()) / 1000000);
+}
+
+void timekeeper_skip_ids(uint32_t last_id)
+{
+    if (time_state.next_id <= last_id) {
+        LOG_EVENT(TAG, TIME_IDS_SKIPPED, last_id, last_id + 1);
+        time_state.next_id = last_id + 1;
+        time_state_commit();
+    }
+}
+
+void timekeeper_checkpoint(void)
+{
+    write_checkpoint(time_state.id_limit > time_state.next_id ? time_state.id_limit : time_state.next_id);
+}
+
+void timekeeper_sleep(uint32_t sleep_sec)
+{
+    timekeeper_sleep_ulp(sleep_sec, 0);
+}
+
+void timekeeper_sleep_ulp(uint32_t ulp_sec, uint32_t timer_sec)
+{
+    time_state.sleep_start_us = time_state.epoch_base_us + esp_timer_get_time();
+    time_state.sleep_us = (int64_t)ulp_sec * 1000000;
+    time_state.timer_us = (int64_t)timer_sec * 1000000;
+    time_state_commit();
+    boot_handled = false;
+}
+
+RTC_IRAM_ATTR uint32_t timekeeper_peek_id(void)
+{
+    return time_state.next_id;
+}
+
+RTC_IRAM_ATTR bool timekeeper_stub_wake(uint32_t sleep_sec, uint32_t *id, uint32_t *epoch)
+{
+    // Réservation NVS ou reprise après coupure : démarrage complet
+    if (!time_state_is_valid() || time_state.sleep_us == 0 || time_state.next_id >= time_state.id_limit) {
+        return false;
+    }
+
+    // Arithmétique 64 bits : fonctions libgcc de la ROM, utilisables avant le bootloader
+    int64_t wake_us = time_state.sleep_start_us + time_state.sleep_us;
+    *id = time_state.next_id++;
+    *epoch = (uint32_t)(wake_us / 1000000);
+    time_state.sleep_start_us = wake_us + TIME_STUB_OFFSET_US;
+    time_state.sleep_us = (int64_t)sleep_sec * 1000000;
+    time_state_commit();
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+/*
+ * 🕰️ IDENTIFIANTS ET HEURE PERSISTANTS
+ *
+ * Les ID de mesure et l'horodatage ne repartent plus de zéro après une
+ * coupure d'alimentation :
+ * - ID : réservés par blocs de TIME_ID_RESERVE dans la NVS, une seule écriture
+ *   par bloc. Après une coupure, la numérotation reprend à la fin du dernier
+ *   bloc réservé (les ID non utilisés du bloc sont sautés, jamais réattribués).
+ * - NVS en échec : le bloc suivant n'est réservé qu'en RTC memory (provisoire)
+ *   et les mesures continuent ; la réservation est retentée au point de
+ *   contrôle de chaque flush. Si la NVS refuse encore la première réservation
+ *   après une coupure, la numérotation reprend après le dernier ID validé sur
+ *   la SD. Reste non couvert : une NVS rétablie juste après une coupure
+ *   survenue pendant un bloc provisoire (ID déjà sur la SD réattribués, puis
+ *   écartés au flush suivant comme déjà validés).
+ * - Heure : epoch UTC tenu en RTC memory, avancé de la durée de chaque deep
+ *   sleep. Après une coupure, l'heure repart du point de contrôle NVS (écrit
+ *   avec chaque réservation et après chaque flush) ou de la dernière mesure du
+ *   tampon flash si elle est plus récente ; la durée de la coupure est perdue.
+ *
+ * Aucune écriture flash supplémentaire au réveil ordinaire.
+ */
+
+// Début de réveil : avancer l'heure de la durée du deep sleep, ou reprendre
+// ID et heure depuis la NVS après une perte d'alimentation
+void timekeeper_boot(void);
+
+// Nouvel ID de mesure, strictement croissant (réserve un bloc en NVS si besoin,
+// en RTC memory seulement si la NVS refuse l'écriture)
+uint32_t timekeeper_next_id(void);
+
+// Heure courante (secondes epoch UTC)
+uint32_t timekeeper_now(void);
+
+// Les prochains ID seront supérieurs à last_id (dernier ID présent sur la SD)
+void timekeeper_skip_ids(uint32_t last_id);
+
+// Point de contrôle NVS (après un flush réussi)
+void timekeeper_checkpoint(void);
+
+// Juste avant le deep sleep : mémoriser l'heure et la durée programmée
+void timekeeper_sleep(uint32_t sleep_sec);
+
+// Variante de l'acquisition ULP : réveil attendu de l'ULP après ulp_sec, timer
+// de secours après timer_sec (l'heure suit la cause du réveil)
+void timekeeper_sleep_ulp(uint32_t ulp_sec, uint32_t timer_sec);
+
+// Prochain ID, sans l'attribuer
+uint32_t timekeeper_peek_id(void);
+
+// Réveil traité par le wake stub (wake_stub.h) : ID et heure du réveil, puis
+// nouveau deep sleep de sleep_sec ; false si le bloc d'ID réservés est épuisé
+// ou qu'aucun deep sleep n'était en cours (démarrage complet nécessaire)
+bool timekeeper_stub_wake(uint32_t sleep_sec, uint32_t *id, uint32_t *epoch);
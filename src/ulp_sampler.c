@@ -0,0 +1,132 @@
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <esp32/ulp.h>
+#include <driver/adc.h>
+
+#include "ulp_sampler.h"
+
+// Pilote ADC historique lié seulement avec le moteur ULP
+#if SAMPLING_ENGINE == SAMPLING_ENGINE_ULP
+
+static const char *TAG = "CHIRO_ULP";
+
+// Étiquettes du programme
+enum {
+    LABEL_STORE,
+    LABEL_HALT,
+};
+
+/*
+ * Programme ULP, exécuté à chaque période du timer :
+ *   lire les deux voies de l'ADC1
+ *   si le tampon est plein : réveiller les cœurs (mesure perdue)
+ *   sinon : ranger la paire, compter, et réveiller les cœurs au bout de wake_after mesures
+ */
+static const ulp_insn_t ulp_program[] = {
+    I_MOVI(R3, ULP_DATA_OFFSET),
+    I_ADC(R1, 0, ULP_ADC_TEMPERATURE_CHANNEL),
+    I_ADC(R2, 0, ULP_ADC_HUMIDITY_CHANNEL),
+
+    I_LD(R0, R3, ULP_WORD_COUNT),
+    M_BL(LABEL_STORE, ULP_SAMPLE_CAPACITY),
+    I_WAKE(),
+    I_HALT(),
+
+    M_LABEL(LABEL_STORE),
+    I_LSHI(R0, R0, 1),
+    I_ADDR(R0, R0, R3),                     // R0 = données + 2 * nombre de mesures
+    I_ST(R1, R0, ULP_WORD_SAMPLES),
+    I_ST(R2, R0, ULP_WORD_SAMPLES + 1),
+    I_LD(R0, R3, ULP_WORD_COUNT),
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, ULP_WORD_COUNT),
+
+    I_LD(R0, R3, ULP_WORD_WAKE_IN),
+    I_SUBI(R0, R0, 1),
+    I_ST(R0, R3, ULP_WORD_WAKE_IN),
+    M_BGE(LABEL_HALT, 1),
+    I_WAKE(),
+
+    M_LABEL(LABEL_HALT),
+    I_HALT(),
+};
+
+// Mot de données (16 bits utiles)
+static uint32_t data_word(uint32_t index)
+{
+    return RTC_SLOW_MEM[ULP_DATA_OFFSET + index] & 0xFFFF;
+}
+
+esp_err_t ulp_sampler_start(uint32_t period_sec, uint32_t wake_after)
+{
+    if (wake_after < 1) {
+        wake_after = 1;
+    }
+    if (wake_after > ULP_SAMPLE_CAPACITY) {
+        wake_after = ULP_SAMPLE_CAPACITY;
+    }
+
+    // ADC1 lu par l'ULP (pilote historique, seul à exposer le mode ULP sur l'ESP32)
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten((adc1_channel_t)ULP_ADC_TEMPERATURE_CHANNEL, ADC_ATTEN_DB_12);
+    adc1_config_channel_atten((adc1_channel_t)ULP_ADC_HUMIDITY_CHANNEL, ADC_ATTEN_DB_12);
+    adc1_ulp_enable();
+
+    size_t size = sizeof(ulp_program) / sizeof(ulp_insn_t);
+    esp_err_t ret = ulp_process_macros_and_load(0, ulp_program, &size);
+    if (ret != ESP_OK || size > ULP_DATA_OFFSET) {
+        LOG_ESSENTIAL(TAG, "❌ Programme ULP non chargé (%s, %u mots)", esp_err_to_name(ret), (unsigned)size);
+        return ret != ESP_OK ? ret : ESP_ERR_INVALID_SIZE;
+    }
+
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_WORD_PERIOD] = period_sec;
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_WORD_WAKE_IN] = wake_after;
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_WORD_COUNT] = 0;
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_WORD_MAGIC] = ULP_DATA_MAGIC;
+
+    ret = ulp_set_wakeup_period(0, period_sec * 1000000);
+    if (ret == ESP_OK) {
+        ret = ulp_run(0);
+    }
+    if (ret != ESP_OK) {
+        LOG_ESSENTIAL(TAG, "❌ ULP non lancé (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+    LOG_DEBUG(TAG, "🛰️  ULP lancé: %lu mesures à %lu s", (unsigned long)wake_after, (unsigned long)period_sec);
+    return ESP_OK;
+}
+
+uint32_t ulp_sampler_collect(ulp_sample_t *samples, uint32_t max, uint32_t *period_sec)
+{
+    // Plus de mesure pendant le relevé ni pendant le reste du réveil
+    ulp_timer_stop();
+
+    if (data_word(ULP_WORD_MAGIC) != ULP_DATA_MAGIC) {
+        return 0;
+    }
+    uint32_t count = data_word(ULP_WORD_COUNT);
+    if (count > max) {
+        count = max;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        samples[i].temperature_raw = (uint16_t)data_word(ULP_WORD_SAMPLES + 2 * i);
+        samples[i].humidity_raw = (uint16_t)data_word(ULP_WORD_SAMPLES + 2 * i + 1);
+    }
+    *period_sec = data_word(ULP_WORD_PERIOD);
+
+    // Relevé fait : ne pas réinjecter ces mesures après un reset avant le prochain lancement
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + ULP_WORD_MAGIC] = 0;
+    return count;
+}
+
+float ulp_sample_temperature(uint16_t raw)
+{
+    return ULP_TEMPERATURE_OFFSET + raw * ULP_TEMPERATURE_PER_LSB;
+}
+
+float ulp_sample_humidity(uint16_t raw)
+{
+    return ULP_HUMIDITY_OFFSET + raw * ULP_HUMIDITY_PER_LSB;
+}
+
+#endif // SAMPLING_ENGINE == SAMPLING_ENGINE_ULP
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <esp_err.h>
+
+#include "config.h"
+
+/*
+ * 🛰️ ACQUISITION PAR LE COPROCESSEUR ULP
+ *
+ * Avec SAMPLING_ENGINE_ULP, les cœurs Xtensa restent en deep sleep entre deux
+ * lots : le coprocesseur ULP (machine à états, programme en RTC slow memory)
+ * est relancé par son timer toutes les period_sec secondes, lit la
+ * température et l'humidité sur deux voies de l'ADC1 et ajoute la paire à un
+ * tampon en RTC slow memory. Il réveille l'ESP32 après wake_after mesures
+ * (lot à écrire en flash, flush dû) ; le démarrage relève le tampon et fait
+ * passer chaque mesure par le chemin habituel (ID, heure, ordonnanceur,
+ * agrégats, add_to_flash_buffer).
+ *
+ * Zone de données, mots de 32 bits à partir de ULP_DATA_OFFSET (l'ULP
+ * n'écrit que les 16 bits de poids faible, les 16 bits de poids fort
+ * contiennent l'adresse de l'instruction ST) :
+ *   [0] ULP_DATA_MAGIC   écrit par les cœurs au lancement, effacé au relevé
+ *   [1] période (s)      écrite par les cœurs, pour dater les mesures
+ *   [2] mesures restantes avant le réveil (décrémenté par l'ULP)
+ *   [3] nombre de mesures dans le tampon (incrémenté par l'ULP)
+ *   [4 + 2i], [5 + 2i]   lectures ADC brutes (température, humidité) de la mesure i
+ *
+ * L'intervalle adaptatif (scheduler.h) est appliqué lot par lot : l'ULP
+ * garde la période fixée au lancement jusqu'au réveil suivant.
+ */
+
+// Programme ULP en mots 0..ULP_DATA_OFFSET-1, données ensuite
+#define ULP_DATA_OFFSET    64
+#define ULP_DATA_MAGIC     0xC41Fu
+#define ULP_WORD_MAGIC     0
+#define ULP_WORD_PERIOD    1
+#define ULP_WORD_WAKE_IN   2
+#define ULP_WORD_COUNT     3
+#define ULP_WORD_SAMPLES   4
+#define ULP_DATA_WORDS     (ULP_WORD_SAMPLES + 2 * ULP_SAMPLE_CAPACITY)
+
+// Mémoire réservée à l'ULP en tête de RTC slow memory (CONFIG_ULP_COPROC_RESERVE_MEM, sdkconfig.defaults)
+#define ULP_RESERVED_BYTES 1024
+
+_Static_assert(ULP_SAMPLE_CAPACITY >= 1 && (ULP_DATA_OFFSET + ULP_DATA_WORDS) * 4 <= ULP_RESERVED_BYTES,
+               "ULP_SAMPLE_CAPACITY dépasse la mémoire réservée à l'ULP");
+
+// Lectures ADC brutes d'une mesure (0-4095)
+typedef struct {
+    uint16_t temperature_raw;
+    uint16_t humidity_raw;
+} ulp_sample_t;
+
+// Charger et lancer le programme ULP : une mesure toutes les period_sec
+// secondes, réveil des cœurs après wake_after mesures
+esp_err_t ulp_sampler_start(uint32_t period_sec, uint32_t wake_after);
+
+// Arrêter le timer de l'ULP et relever les mesures accumulées (au plus max,
+// de la plus ancienne à la plus récente) ; 0 si le tampon n'a pas été lancé
+// depuis la dernière perte de la RTC memory
+uint32_t ulp_sampler_collect(ulp_sample_t *samples, uint32_t max, uint32_t *period_sec);
+
+// Conversion des lectures ADC (étalonnage ULP_* de config.h)
+float ulp_sample_temperature(uint16_t raw);
+float ulp_sample_humidity(uint16_t raw);
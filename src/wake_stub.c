@@ -0,0 +1,215 @@
+#include <stddef.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#ifdef ESP_PLATFORM
+#include <esp_sleep.h>
+#include <esp_wake_stub.h>
+#endif
+
+#include "wake_stub.h"
+#include "staging.h"
+#include "timekeeper.h"
+#include "scheduler.h"
+#include "aggregates.h"
+#include "record.h"
+#include "synthetic_sensor.h"
+
+static const char *TAG = "CHIRO_STUB";
+
+#define WAKE_STUB_MAGIC 0x4B415746u  // "FWAK"
+
+// Cas où le stub reproduit la décision de l'ordonnanceur (scheduler.h)
+#define STUB_MODE_STABLE 0x01  // Intervalle maximal, écarts < 1/2 seuil : intervalle et flush inchangés
+#define STUB_MODE_MOVING 0x02  // Intervalle minimal, un écart > 1/2 seuil : flush repoussé
+
+// Demi-seuils de changement en centièmes, avec une marge d'un centième pour
+// rester du même côté que le calcul en flottants de l'ordonnanceur
+#define STUB_STABLE_T_CENTI ((int32_t)(SAMPLE_CHANGE_TEMPERATURE * 50.0f))
+#define STUB_STABLE_H_CENTI ((int32_t)(SAMPLE_CHANGE_HUMIDITY * 50.0f))
+#define STUB_MOVING_T_CENTI (STUB_STABLE_T_CENTI + 1)
+#define STUB_MOVING_H_CENTI (STUB_STABLE_H_CENTI + 1)
+
+typedef struct {
+    uint32_t magic;              // WAKE_STUB_MAGIC si l'état est cohérent
+    uint32_t sleep_sec;          // Intervalle appliqué par le stub
+    uint32_t interval_code;      // Son codage dans les enregistrements (record.c reste en flash)
+    uint32_t modes;              // STUB_MODE_* autorisés à cet intervalle (0 = stub désactivé)
+    uint32_t pending;            // Mesures en attente (tampon flash + lot RTC)
+    int32_t temperature_centi;   // Dernière mesure
+    int32_t humidity_centi;
+    uint32_t handled;            // Mesures prises par le stub depuis le dernier démarrage complet
+    uint32_t check;
+} wake_stub_state_t;
+
+RTC_DATA_ATTR static wake_stub_state_t stub_state;
+
+static RTC_IRAM_ATTR uint32_t stub_state_checksum(void)
+{
+    return stub_state.magic ^ (stub_state.sleep_sec * 2654435761u) ^ (stub_state.interval_code << 16) ^
+           (stub_state.modes << 24) ^ (stub_state.pending * 40503u) ^ (uint32_t)stub_state.temperature_centi ^
+           ((uint32_t)stub_state.humidity_centi << 7) ^ ~stub_state.handled;
+}
+
+static RTC_IRAM_ATTR void stub_state_commit(void)
+{
+    stub_state.magic = WAKE_STUB_MAGIC;
+    stub_state.check = stub_state_checksum();
+}
+
+#if FAST_WAKE
+// CRC-16/CCITT bit à bit : record_crc16() et sa table restent en flash
+static RTC_IRAM_ATTR uint16_t stub_crc16(const uint8_t *bytes, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+#if ADAPTIVE_SAMPLING
+static RTC_IRAM_ATTR int32_t stub_abs(int32_t value)
+{
+    return value < 0 ? -value : value;
+}
+#endif
+
+static RTC_IRAM_ATTR int32_t stub_clamp(int32_t value, int32_t min, int32_t max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
+// Limite de mesures en attente avant un démarrage complet, selon l'écart à la
+// mesure précédente (0 : l'ordonnanceur changerait d'intervalle)
+static RTC_IRAM_ATTR uint32_t stub_pending_limit(int32_t temperature_centi, int32_t humidity_centi)
+{
+#if ADAPTIVE_SAMPLING
+    int32_t delta_t = stub_abs(temperature_centi - stub_state.temperature_centi);
+    int32_t delta_h = stub_abs(humidity_centi - stub_state.humidity_centi);
+    if ((stub_state.modes & STUB_MODE_STABLE) && delta_t < STUB_STABLE_T_CENTI && delta_h < STUB_STABLE_H_CENTI) {
+        return BUFFER_FLUSH_THRESHOLD;
+    }
+    if ((stub_state.modes & STUB_MODE_MOVING) && (delta_t >= STUB_MOVING_T_CENTI || delta_h >= STUB_MOVING_H_CENTI)) {
+        return BUFFER_FLUSH_DEFER_MAX;
+    }
+    return 0;
+#else
+    (void)temperature_centi;
+    (void)humidity_centi;
+    return BUFFER_FLUSH_THRESHOLD;
+#endif
+}
+#endif
+
+RTC_IRAM_ATTR bool wake_stub_cycle(void)
+{
+#if FAST_WAKE
+    if (stub_state.magic != WAKE_STUB_MAGIC || stub_state.check != stub_state_checksum() || stub_state.modes == 0) {
+        return false;
+    }
+    // Le démarrage complet écrit le lot en flash quand il se remplit
+    if (staging_count() + 1 >= STAGING_BATCH_SIZE) {
+        return false;
+    }
+
+    int32_t temperature_centi, humidity_centi;
+    synthetic_sensor_read(timekeeper_peek_id(), &temperature_centi, &humidity_centi);
+    if (stub_state.pending + 1 >= stub_pending_limit(temperature_centi, humidity_centi)) {
+        return false;
+    }
+
+    uint32_t id, epoch;
+    if (!timekeeper_stub_wake(stub_state.sleep_sec, &id, &epoch)) {
+        return false;
+    }
+    chiro_record_t record = { 0 };
+    record.id = id;
+    record.epoch = epoch;
+    record.temperature_centi = (int16_t)stub_clamp(temperature_centi, INT16_MIN, INT16_MAX);
+    record.humidity_centi = (uint16_t)stub_clamp(humidity_centi, 0, UINT16_MAX);
+    // Autres canaux de RECORD_CHANNELS : non mesurés par le stub (constante à la compilation)
+    record.flags = (uint8_t)(RECORD_FLAG_NONE_PRESENT & ~(RECORD_FLAG_NO(temperature) | RECORD_FLAG_NO(humidity)));
+    record.interval_code = (uint8_t)stub_state.interval_code;
+    record.crc = stub_crc16((const uint8_t *)&record, offsetof(chiro_record_t, crc));
+    staging_push(&record);
+
+    stub_state.pending++;
+    stub_state.handled++;
+    stub_state.temperature_centi = temperature_centi;
+    stub_state.humidity_centi = humidity_centi;
+    stub_state_commit();
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t wake_stub_sleep_sec(void)
+{
+    return stub_state.sleep_sec;
+}
+
+void wake_stub_replay(void)
+{
+    if (stub_state.magic != WAKE_STUB_MAGIC || stub_state.check != stub_state_checksum()) {
+        stub_state.handled = 0;
+    }
+
+    // Mesures du stub : les dernières du lot RTC, dans l'ordre
+    uint32_t count = staging_count();
+    uint32_t handled = stub_state.handled < count ? stub_state.handled : count;
+    const chiro_record_t *records = staging_records() + (count - handled);
+    for (uint32_t i = 0; i < handled; i++) {
+        record_values_t values;
+        record_values(&records[i], &values);
+        scheduler_update(&values);
+        aggregates_add(&records[i]);
+    }
+    if (handled > 0) {
+        LOG_ESSENTIAL(TAG, "⚡ %lu mesures prises par le wake stub", (unsigned long)handled);
+    }
+
+    stub_state.modes = 0;
+    stub_state.handled = 0;
+    stub_state_commit();
+}
+
+void wake_stub_arm(uint32_t sleep_sec, int32_t temperature_centi, int32_t humidity_centi, uint32_t pending)
+{
+    uint32_t modes = STUB_MODE_STABLE | STUB_MODE_MOVING;
+#if ADAPTIVE_SAMPLING
+    modes = (sleep_sec == scheduler_interval_max() ? STUB_MODE_STABLE : 0) |
+            (sleep_sec == scheduler_interval_min() ? STUB_MODE_MOVING : 0);
+#endif
+
+    stub_state.sleep_sec = sleep_sec;
+    stub_state.interval_code = record_interval_code(sleep_sec);
+    stub_state.modes = FAST_WAKE ? modes : 0;
+    stub_state.pending = pending;
+    stub_state.temperature_centi = temperature_centi;
+    stub_state.humidity_centi = humidity_centi;
+    stub_state.handled = 0;
+    stub_state_commit();
+}
+
+#ifdef ESP_PLATFORM
+// Stub ESP-IDF : mesure et retour en deep sleep, ou démarrage complet
+static RTC_IRAM_ATTR void chiro_wake_stub(void)
+{
+    if (wake_stub_cycle()) {
+        esp_wake_stub_set_wakeup_time((uint64_t)stub_state.sleep_sec * 1000000ULL);
+        esp_wake_stub_sleep(&chiro_wake_stub);  // Sans retour
+    }
+    esp_default_wake_deep_sleep();
+}
+#endif
+
+void wake_stub_install(void)
+{
+#if defined(ESP_PLATFORM) && FAST_WAKE
+    esp_set_deep_sleep_wake_stub(&chiro_wake_stub);
+#endif
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+/*
+ * ⚡ RÉVEIL RAPIDE PAR WAKE STUB (CAPTEUR SYNTHÉTIQUE SEULEMENT)
+ *
+ * Un démarrage complet coûte ~150 ms de bootloader avant app_main(), pour un
+ * cycle qui se résume le plus souvent à une mesure ajoutée au lot RTC. Le wake
+ * stub, exécuté depuis la RTC fast memory dès la sortie du deep sleep, fait ce
+ * travail seul (mesure, ID et heure, lot RTC) et rendort l'ESP32.
+ *
+ * Le stub ne prend une mesure que si le cycle complet aurait pris exactement
+ * les mêmes décisions : lot RTC non plein, pas de flush dû, intervalle
+ * inchangé (mesures stables à l'intervalle maximal, ou en mouvement à
+ * l'intervalle minimal), ID déjà réservés. Sinon il laisse démarrer
+ * l'application, qui rejoue d'abord les mesures du stub dans l'ordonnanceur et
+ * les agrégats (wake_stub_replay), puis autorise à nouveau le stub pour les
+ * réveils suivants (wake_stub_arm).
+ *
+ * Une perte de la RTC memory invalide l'état : démarrage complet.
+ *
+ * Limite : le stub ne lit que le capteur synthétique (synthetic_sensor_read),
+ * aucun pilote I2C ne tient en RTC fast memory. Il n'est donc compilé que pour
+ * le simulateur et les bancs (FAST_WAKE, SENSOR_SYNTHETIC_ONLY) ; avec des
+ * capteurs réels, chaque mesure passe par un démarrage complet.
+ */
+
+_Static_assert(!FAST_WAKE || SENSOR_SYNTHETIC_ONLY,
+               "FAST_WAKE : le wake stub ne lit que le capteur synthétique (SENSOR_SYNTHETIC_ONLY)");
+
+// Au réveil, avant l'application : true si la mesure est dans le lot RTC et que
+// l'ESP32 peut se rendormir pour wake_stub_sleep_sec() secondes
+bool wake_stub_cycle(void);
+
+// Durée du deep sleep après un réveil traité par le stub (secondes)
+uint32_t wake_stub_sleep_sec(void);
+
+// Début d'un démarrage complet : mesures prises par le stub transmises à
+// l'ordonnanceur et aux agrégats, stub désactivé
+void wake_stub_replay(void);
+
+// Fin d'un démarrage complet réussi : prochains réveils confiés au stub
+// (pending = mesures en attente dans le tampon flash et le lot RTC)
+void wake_stub_arm(uint32_t sleep_sec, int32_t temperature_centi, int32_t humidity_centi, uint32_t pending);
+
+// Juste avant le deep sleep : installer le stub (ESP32, sans effet sur l'ordinateur)
+void wake_stub_install(void);